@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+namespace soro::bench {
+
+// number of calls to the global operator new since program start
+std::size_t allocation_count();
+
+struct measurement {
+  std::chrono::microseconds duration_{};
+  std::size_t allocations_{0};
+};
+
+template <typename Fn>
+measurement measure(Fn&& fn) {
+  auto const allocations_before = allocation_count();
+  auto const start = std::chrono::steady_clock::now();
+
+  fn();
+
+  auto const stop = std::chrono::steady_clock::now();
+
+  return {.duration_ = std::chrono::duration_cast<std::chrono::microseconds>(
+              stop - start),
+          .allocations_ = allocation_count() - allocations_before};
+}
+
+void log_measurement(std::string_view name, measurement const& m);
+
+}  // namespace soro::bench
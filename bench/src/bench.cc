@@ -0,0 +1,42 @@
+#include "bench/bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "utl/logging.h"
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};  // NOLINT
+
+}  // namespace
+
+void* operator new(std::size_t const size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (auto* ptr = std::malloc(size); ptr != nullptr) {  // NOLINT
+    return ptr;
+  }
+
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);  // NOLINT
+}
+
+namespace soro::bench {
+
+std::size_t allocation_count() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+void log_measurement(std::string_view const name, measurement const& m) {
+  uLOG(utl::info) << name << ": " << m.duration_.count() << "us, "
+                  << m.allocations_ << " allocations";
+}
+
+}  // namespace soro::bench
@@ -0,0 +1,125 @@
+#include "doctest/doctest.h"
+
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "soro/infrastructure/infrastructure.h"
+
+#include "bench/bench.h"
+#include "test/file_paths.h"
+
+namespace soro::infra::bench {
+
+using namespace soro::bench;
+
+constexpr auto const LOOKUP_ROUNDS = 16U;
+
+TEST_CASE("bench ds100 to station lookup") {
+  for (auto const& infra : soro::test::get_infrastructure_scenarios()) {
+    std::map<std::string, station::ptr, std::less<>> tree;
+    for (auto const& [ds100, station] : (*infra)->ds100_to_station_) {
+      tree.emplace(std::string{ds100}, station);
+    }
+
+    soro::size_t tree_hits = 0;
+    auto const tree_m = measure([&] {
+      for (auto round = 0U; round < LOOKUP_ROUNDS; ++round) {
+        for (auto const& station : (*infra)->stations_) {
+          tree_hits += tree.find(std::string_view{station->ds100_})->second ==
+                       station;
+        }
+      }
+    });
+
+    soro::size_t hash_hits = 0;
+    auto const hash_m = measure([&] {
+      for (auto round = 0U; round < LOOKUP_ROUNDS; ++round) {
+        for (auto const& station : (*infra)->stations_) {
+          hash_hits += (*infra)
+                           ->ds100_to_station_
+                           .find(std::string_view{station->ds100_})
+                           ->second == station;
+        }
+      }
+    });
+
+    log_measurement("ds100 to station, std::map", tree_m);
+    log_measurement("ds100 to station, soro::hash_map", hash_m);
+
+    CHECK_EQ(tree_hits, hash_hits);
+  }
+}
+
+TEST_CASE("bench station route name lookup") {
+  for (auto const& infra : soro::test::get_infrastructure_scenarios()) {
+    std::vector<std::map<std::string, station_route::ptr, std::less<>>> trees(
+        (*infra)->stations_.size());
+    for (auto const& station : (*infra)->stations_) {
+      for (auto const& [name, sr] : station->station_routes_) {
+        trees[station->id_].emplace(std::string{name}, sr);
+      }
+    }
+
+    soro::size_t tree_hits = 0;
+    auto const tree_m = measure([&] {
+      for (auto round = 0U; round < LOOKUP_ROUNDS; ++round) {
+        for (auto const& sr : (*infra)->station_routes_) {
+          auto const& tree = trees[sr->station_->id_];
+          tree_hits += tree.find(std::string_view{sr->name_})->second == sr;
+        }
+      }
+    });
+
+    soro::size_t hash_hits = 0;
+    auto const hash_m = measure([&] {
+      for (auto round = 0U; round < LOOKUP_ROUNDS; ++round) {
+        for (auto const& sr : (*infra)->station_routes_) {
+          auto const& routes = sr->station_->station_routes_;
+          hash_hits += routes.find(std::string_view{sr->name_})->second == sr;
+        }
+      }
+    });
+
+    log_measurement("station route by name, std::map", tree_m);
+    log_measurement("station route by name, soro::hash_map", hash_m);
+
+    CHECK_EQ(tree_hits, hash_hits);
+  }
+}
+
+TEST_CASE("bench element to station lookup") {
+  for (auto const& infra : soro::test::get_infrastructure_scenarios()) {
+    std::map<element_id, station::ptr> tree;
+    for (auto const& station : (*infra)->stations_) {
+      for (auto const& element : station->elements_) {
+        tree.emplace(element->id(), station);
+      }
+    }
+
+    soro::size_t tree_hits = 0;
+    auto const tree_m = measure([&] {
+      for (auto round = 0U; round < LOOKUP_ROUNDS; ++round) {
+        for (auto const& [e_id, station] : tree) {
+          tree_hits += tree.at(e_id) == station;
+        }
+      }
+    });
+
+    soro::size_t vector_hits = 0;
+    auto const vector_m = measure([&] {
+      for (auto round = 0U; round < LOOKUP_ROUNDS; ++round) {
+        for (auto const& [e_id, station] : tree) {
+          vector_hits += (*infra)->element_to_station_[e_id] == station;
+        }
+      }
+    });
+
+    log_measurement("element to station, std::map", tree_m);
+    log_measurement("element to station, soro::vector", vector_m);
+
+    CHECK_EQ(tree_hits, vector_hits);
+  }
+}
+
+}  // namespace soro::infra::bench
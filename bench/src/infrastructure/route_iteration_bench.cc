@@ -0,0 +1,101 @@
+#include "doctest/doctest.h"
+
+#include "soro/utls/coroutine/recursive_generator.h"
+
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/timetable/timetable.h"
+
+#include "bench/bench.h"
+#include "test/file_paths.h"
+
+namespace soro::infra::bench {
+
+using namespace soro::bench;
+
+// coroutine based reference implementations, equivalent to the iteration
+// before it was replaced by the zero-allocation iterators
+
+utls::recursive_generator<route_node> coro_from_to(station_route const& sr,
+                                                   node::idx const from,
+                                                   node::idx const to) {
+  for (auto rn : sr.from_to(from, to)) {
+    co_yield rn;
+  }
+}
+
+utls::recursive_generator<route_node> coro_iterate(
+    interlocking_route const& ir, infrastructure const& infra) {
+  if (ir.station_routes_.size() == 1) {
+    co_yield coro_from_to(*ir.first_sr(infra), ir.start_offset_,
+                          ir.end_offset_);
+    co_return;
+  }
+
+  auto const first_sr = ir.first_sr(infra);
+  co_yield coro_from_to(*first_sr, ir.start_offset_, first_sr->size());
+
+  for (auto i = 1U; i < ir.station_routes_.size() - 1; ++i) {
+    auto const sr = ir.sr(static_cast<interlocking_route::sr_offset>(i), infra);
+    co_yield coro_from_to(*sr, 0, sr->size());
+  }
+
+  co_yield coro_from_to(*ir.last_sr(infra), 0, ir.end_offset_);
+}
+
+TEST_CASE("bench interlocking route iteration") {
+  for (auto const& infra : soro::test::get_infrastructure_scenarios()) {
+    soro::size_t coro_nodes = 0;
+    auto const coro = measure([&] {
+      for (auto const& ir : (*infra)->interlocking_.routes_) {
+        for (auto const& rn : coro_iterate(ir, *infra)) {
+          coro_nodes += static_cast<soro::size_t>(rn.omitted_) + 1;
+        }
+      }
+    });
+
+    soro::size_t it_nodes = 0;
+    auto const it = measure([&] {
+      for (auto const& ir : (*infra)->interlocking_.routes_) {
+        for (auto const& rn : ir.iterate(*infra)) {
+          it_nodes += static_cast<soro::size_t>(rn.omitted_) + 1;
+        }
+      }
+    });
+
+    log_measurement("interlocking routes, coroutines", coro);
+    log_measurement("interlocking routes, iterators", it);
+
+    CHECK_EQ(coro_nodes, it_nodes);
+    CHECK_EQ(it.allocations_, std::size_t{0});
+  }
+}
+
+TEST_CASE("bench train iteration") {
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    auto const& infra = *scenario->infra_;
+
+    soro::size_t nodes = 0;
+    auto const it = measure([&] {
+      for (auto const& train : scenario->timetable_->trains_) {
+        for (auto const& tn : train.iterate(infra)) {
+          nodes += static_cast<soro::size_t>(tn.sequence_point_.has_value());
+        }
+      }
+    });
+
+    auto const length = measure([&] {
+      for (auto const& train : scenario->timetable_->trains_) {
+        std::ignore = train.path_length(infra);
+      }
+    });
+
+    log_measurement("trains, iterators", it);
+    log_measurement("train path lengths, iterators", length);
+
+    CHECK_GT(nodes, soro::size_t{0});
+    CHECK_EQ(it.allocations_, std::size_t{0});
+    CHECK_EQ(length.allocations_, std::size_t{0});
+  }
+}
+
+}  // namespace soro::infra::bench
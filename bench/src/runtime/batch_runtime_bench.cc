@@ -0,0 +1,69 @@
+#include "doctest/doctest.h"
+
+#include "soro/runtime/batch_runtime.h"
+
+#include "bench/bench.h"
+#include "test/file_paths.h"
+#include "test/runtime/variants.h"
+
+namespace soro::runtime::bench {
+
+using namespace soro::bench;
+using namespace soro::runtime::test;
+using namespace soro::tt;
+using namespace soro::infra;
+
+TEST_CASE("bench batch runtime") {
+  type_set const record_types({type::HALT, type::MAIN_SIGNAL});
+
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    auto const& infra = *scenario->infra_;
+    auto const& tt = scenario->timetable_;
+
+    std::vector<std::vector<train>> all_variants;
+    for (auto const& train : tt->trains_) {
+      // every train runs with BATCH_LANES compositions sharing its freight flag
+      auto variants = get_variants(train, tt, BATCH_LANES);
+
+      // compositions not able to run the path fail in both implementations
+      try {
+        for (auto const& variant : variants) {
+          std::ignore = runtime_calculation(variant, variant.physics(*tt),
+                                            infra, record_types);
+        }
+      } catch (std::exception const&) {
+        continue;
+      }
+
+      all_variants.emplace_back(std::move(variants));
+    }
+
+    std::size_t scalar_stamps = 0;
+    auto const scalar_m = measure([&] {
+      for (auto const& variants : all_variants) {
+        for (auto const& variant : variants) {
+          scalar_stamps += runtime_calculation(variant, variant.physics(*tt),
+                                               infra, record_types)
+                               .times_.size();
+        }
+      }
+    });
+
+    std::size_t batch_stamps = 0;
+    auto const batch_m = measure([&] {
+      for (auto const& variants : all_variants) {
+        for (auto const& ts :
+             batch_runtime_calculation(variants, *tt, infra, record_types)) {
+          batch_stamps += ts.times_.size();
+        }
+      }
+    });
+
+    log_measurement("runtime variants, scalar", scalar_m);
+    log_measurement("runtime variants, batch", batch_m);
+
+    CHECK_EQ(scalar_stamps, batch_stamps);
+  }
+}
+
+}  // namespace soro::runtime::bench
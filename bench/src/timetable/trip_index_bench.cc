@@ -0,0 +1,55 @@
+#include "doctest/doctest.h"
+
+#include "soro/timetable/timetable.h"
+
+#include "bench/bench.h"
+#include "test/file_paths.h"
+
+namespace soro::tt::bench {
+
+using namespace soro::bench;
+
+constexpr auto const WINDOW_COUNT = 64U;
+
+TEST_CASE("bench trip window queries") {
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    auto const& tt = scenario->timetable_;
+    auto const& full = tt->interval_;
+
+    auto const step = (full.end_ - full.start_) / WINDOW_COUNT;
+
+    std::size_t scanned = 0;
+    auto const scan_m = measure([&] {
+      for (auto w = 0U; w < WINDOW_COUNT; ++w) {
+        interval const window{.start_ = full.start_ + step * w,
+                              .end_ = full.start_ + step * w + hours{2}};
+
+        for (auto const& train : tt->trains_) {
+          for (auto const anchor : train.departures(window)) {
+            std::ignore = anchor;
+            ++scanned;
+          }
+        }
+      }
+    });
+
+    std::size_t indexed = 0;
+    auto const index_m = measure([&] {
+      for (auto w = 0U; w < WINDOW_COUNT; ++w) {
+        interval const window{.start_ = full.start_ + step * w,
+                              .end_ = full.start_ + step * w + hours{2}};
+
+        indexed += tt->trip_index_.overlapping(window).size();
+      }
+    });
+
+    log_measurement("trip windows, train::departures", scan_m);
+    log_measurement("trip windows, trip_index", index_m);
+
+    // departures only considers trips anchored on days inside the window,
+    // the index also finds trips from the day before running past midnight
+    CHECK_LE(scanned, indexed);
+  }
+}
+
+}  // namespace soro::tt::bench
@@ -2,6 +2,7 @@
 
 #include "cista/containers/array.h"
 #include "cista/containers/fws_multimap.h"
+#include "cista/containers/hash_map.h"
 #include "cista/containers/hash_set.h"
 #include "cista/containers/optional.h"
 #include "cista/containers/variant.h"
@@ -11,7 +12,6 @@
 
 #if defined(SERIALIZE)
 
-#include "cista/containers/hash_map.h"
 #include "cista/containers/hash_set.h"
 #include "cista/containers/ptr.h"
 #include "cista/containers/tuple.h"
@@ -59,6 +59,9 @@ using tuple = cista::tuple<Ts...>;
 template <typename Key, typename Value>
 using map = data::hash_map<Key, Value>;
 
+template <typename Key, typename Value>
+using hash_map = data::hash_map<Key, Value>;
+
 template <typename T>
 using set = data::hash_set<T>;
 
@@ -127,6 +130,10 @@ using tuple = std::tuple<Ts...>;
 template <typename Key, typename Value, typename Comparator = std::less<> >
 using map = std::map<Key, Value, Comparator>;
 
+// open addressing hash map, use this instead of map for lookup heavy data
+template <typename Key, typename Value>
+using hash_map = data::hash_map<Key, Value>;
+
 template <typename T>
 using set = data::hash_set<T>;
 
@@ -1,8 +1,9 @@
 #pragma once
 
+#include <iterator>
 #include <vector>
 
-#include "soro/utls/coroutine/generator.h"
+#include "soro/utls/container/it_range.h"
 
 #include "soro/si/units.h"
 
@@ -20,21 +21,66 @@ struct section {
   using id = uint32_t;
   using ids = soro::vector<id>;
 
-  template <direction Dir, skip Skip = skip::Yes>
-  utls::generator<element::ptr> iterate() const {
-    auto const& elements =
-        Dir == direction::Rising ? rising_order_ : falling_order_;
+  // forward iterator over the elements of a section in direction Dir,
+  // with skip::Yes directed track elements of the opposite direction are
+  // skipped
+  template <direction Dir, skip Skip>
+  struct iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = element::ptr;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    using base_iterator = soro::vector<element::ptr>::const_iterator;
+
+    iterator() = default;
+    iterator(base_iterator const it, base_iterator const end)
+        : it_{it}, end_{end} {
+      skip_opposite();
+    }
+
+    reference operator*() const noexcept { return *it_; }
+    pointer operator->() const noexcept { return std::addressof(*it_); }
+
+    iterator& operator++() {
+      ++it_;
+      skip_opposite();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto copy = *this;
+      ++(*this);
+      return copy;
+    }
 
-    for (auto e : elements) {
+    bool operator==(iterator const& o) const noexcept { return it_ == o.it_; }
+    bool operator!=(iterator const& o) const noexcept { return it_ != o.it_; }
+
+  private:
+    void skip_opposite() {
       if constexpr (Skip == skip::Yes) {
-        if (e->is_directed_track_element() &&
-            e->as<track_element>().rising_ != static_cast<bool>(Dir)) {
-          continue;
+        while (it_ != end_ && (*it_)->is_directed_track_element() &&
+               (*it_)->as<track_element>().rising_ !=
+                   static_cast<bool>(Dir)) {
+          ++it_;
         }
       }
-
-      co_yield e;
     }
+
+    base_iterator it_{};
+    base_iterator end_{};
+  };
+
+  template <direction Dir, skip Skip = skip::Yes>
+  utls::it_range<iterator<Dir, Skip>> iterate() const {
+    auto const& elements =
+        Dir == direction::Rising ? rising_order_ : falling_order_;
+
+    return utls::make_range(
+        iterator<Dir, Skip>{std::begin(elements), std::end(elements)},
+        iterator<Dir, Skip>{std::end(elements), std::end(elements)});
   }
 
   auto from(element::ptr const element, direction const dir) const {
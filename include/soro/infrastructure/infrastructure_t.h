@@ -7,6 +7,7 @@
 #include "soro/infrastructure/infrastructure_options.h"
 #include "soro/infrastructure/interlocking/interlocking.h"
 #include "soro/infrastructure/line.h"
+#include "soro/infrastructure/spatial_index.h"
 #include "soro/infrastructure/station/station.h"
 #include "soro/infrastructure/station/station_route_graph.h"
 #include "soro/rolling_stock/rolling_stock.h"
@@ -39,8 +40,9 @@ struct infrastructure_t {
   soro::vector<station_route::ptr> station_routes_{};
   soro::vector<station_route::path::ptr> station_route_paths_{};
 
-  soro::map<soro::string, station::ptr> ds100_to_station_{};
-  soro::map<element_id, station::ptr> element_to_station_{};
+  soro::hash_map<soro::string, station::ptr> ds100_to_station_{};
+  // element ids are dense, index this with element::id()
+  soro::vector<station::ptr> element_to_station_{};
 
   station_route_graph station_route_graph_{};
 
@@ -52,6 +54,9 @@ struct infrastructure_t {
   soro::vector<utls::gps> station_positions_{};
   soro::vector<utls::gps> element_positions_{};
 
+  // elements, stations and routes by their positions
+  spatial_index spatial_{};
+
   lines lines_{};
 
   soro::vector<soro::unique_ptr<station>> station_store_{};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "soro/utls/container/id_iterator.h"
+#include "soro/utls/coroutine/generator.h"
 
 #include "soro/infrastructure/graph/type_set.h"
 #include "soro/infrastructure/station/station_route.h"
@@ -28,6 +29,47 @@ struct interlocking_route {
   static constexpr id INVALID = std::numeric_limits<id>::max();
   static constexpr bool valid(id const id) noexcept { return id != INVALID; }
 
+  // forward iterator yielding the route nodes of an interlocking route,
+  // chains the iterators of all traversed station routes
+  struct iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = route_node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    using sr_iterator = soro::vector<station_route::id>::const_iterator;
+
+    iterator() = default;
+    iterator(sr_iterator from_it, node::idx from, sr_iterator to_it,
+             node::idx to, infrastructure_t const* infra);
+
+    reference operator*() const noexcept { return *node_it_; }
+    pointer operator->() const noexcept { return node_it_.operator->(); }
+
+    iterator& operator++();
+    iterator operator++(int);
+
+    bool operator==(iterator const& o) const noexcept {
+      return sr_it_ == o.sr_it_ && node_it_ == o.node_it_;
+    }
+    bool operator!=(iterator const& o) const noexcept { return !(*this == o); }
+
+  private:
+    void skip_exhausted();
+
+    sr_iterator sr_it_{};
+    sr_iterator to_it_{};
+    node::idx to_{node::INVALID_IDX};
+
+    station_route::iterator node_it_{};
+    station_route::iterator node_end_{};
+
+    infrastructure_t const* infra_{nullptr};
+  };
+
+  using range = utls::it_range<iterator>;
+
   bool static valid_end(type const t);
   type_set static valid_ends();
 
@@ -60,16 +102,13 @@ struct interlocking_route {
   bool starts_on_section(infrastructure const&) const;
   bool ends_on_section(infrastructure const&) const;
 
-  utls::recursive_generator<route_node> from_to(station_route::id, node::idx,
-                                                station_route::id, node::idx,
-                                                infrastructure const&) const;
+  range from_to(station_route::id, node::idx, station_route::id, node::idx,
+                infrastructure const&) const;
 
-  utls::recursive_generator<route_node> from(station_route::id, node::idx,
-                                             infrastructure const&) const;
-  utls::recursive_generator<route_node> to(station_route::id, node::idx,
-                                           infrastructure const&) const;
+  range from(station_route::id, node::idx, infrastructure const&) const;
+  range to(station_route::id, node::idx, infrastructure const&) const;
 
-  utls::recursive_generator<route_node> iterate(infrastructure const&) const;
+  range iterate(infrastructure const&) const;
   utls::generator<sub_path> iterate_station_routes(
       infrastructure_t const&) const;
 
@@ -12,6 +12,6 @@ namespace soro::infra {
 
 soro::vector<utls::gps> parse_station_coords(
     std::filesystem::path const& gps_path,
-    soro::map<soro::string, station::ptr> const& ds100_to_station);
+    soro::hash_map<soro::string, station::ptr> const& ds100_to_station);
 
 }  // namespace soro::infra
\ No newline at end of file
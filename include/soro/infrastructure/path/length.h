@@ -2,7 +2,6 @@
 
 #include "soro/utls/concepts/iterable_helpers.h"
 #include "soro/utls/concepts/yields.h"
-#include "soro/utls/coroutine/coro_map.h"
 
 #include "soro/infrastructure/infrastructure.h"
 #include "soro/infrastructure/path/is_path.h"
@@ -10,84 +9,104 @@
 
 namespace soro::infra {
 
-template <typename Iterable>
-  requires utls::yields<element::ptr, Iterable> &&
-           utls::is_input_iterable<Iterable>
-si::length get_path_length_from_elements(Iterable&& element_iter) {
+// projection maps every value yielded by the iterable to an element::ptr,
+// this lets us compute the length of route or train paths without an
+// intermediate coroutine or container
+template <typename Iterable, typename Projection>
+  requires utls::is_input_iterable<Iterable>
+si::length get_path_length_from_elements(Iterable&& iter, Projection&& proj) {
   si::length distance = si::ZERO<si::length>;
 
-  auto it = std::begin(element_iter);
+  auto it = std::begin(iter);
 
-  element::ptr last_element = *it;
+  element::ptr last_element = proj(*it);
   ++it;
 
-  for (; it != std::end(element_iter); ++it) {
-    auto const kmp = last_element->get_km(*it);
-    auto const next_kmp = (*it)->get_km(last_element);
+  for (; it != std::end(iter); ++it) {
+    element::ptr const element = proj(*it);
+
+    auto const kmp = last_element->get_km(element);
+    auto const next_kmp = element->get_km(last_element);
 
     distance += abs(kmp - next_kmp);
 
-    last_element = *it;
+    last_element = element;
   }
 
   return distance;
 }
 
 template <typename Iterable>
-  requires utls::yields<node::ptr, Iterable> &&
+  requires utls::yields<element::ptr, Iterable> &&
            utls::is_input_iterable<Iterable>
-si::length get_path_length_from_elements(Iterable&& node_iter) {
-  return get_path_length_from_elements(utls::coro_map(
-      node_iter, [](node::ptr node_ptr) { return node_ptr->element_; }));
+si::length get_path_length_from_elements(Iterable&& element_iter) {
+  return get_path_length_from_elements(
+      element_iter, [](element::ptr element_ptr) { return element_ptr; });
 }
 
 template <typename Iterable>
-  requires utls::yields<element::ptr, Iterable> &&
+  requires utls::yields<node::ptr, Iterable> &&
            utls::is_input_iterable<Iterable>
-si::length get_path_length_from_sections(Iterable&& element_iter) {
-  auto iter = std::begin(element_iter);
+si::length get_path_length_from_elements(Iterable&& node_iter) {
+  return get_path_length_from_elements(
+      node_iter, [](node::ptr node_ptr) { return node_ptr->element_; });
+}
+
+// see get_path_length_from_elements for the projection
+template <typename Iterable, typename Projection>
+  requires utls::is_input_iterable<Iterable>
+si::length get_path_length_from_sections(Iterable&& iter, Projection&& proj) {
+  auto it = std::begin(iter);
 
   si::length distance = si::ZERO<si::length>;
 
-  element::ptr last_section = *iter;
-  element::ptr next_to_last_section = *(++iter);
+  element::ptr last_section = proj(*it);
+  element::ptr next_to_last_section = proj(*(++it));
 
   element::ptr next_section = next_to_last_section;
   element::ptr prev_to_next_section = last_section;
 
-  while (iter != std::end(element_iter)) {
-    while (iter != std::end(element_iter) && (*iter)->is_track_element()) {
-      ++iter;
+  while (it != std::end(iter)) {
+    while (it != std::end(iter) && proj(*it)->is_track_element()) {
+      ++it;
 
       prev_to_next_section = next_section;
-      next_section = *iter;
+      next_section = proj(*it);
     }
 
     distance += abs(last_section->get_km(next_to_last_section) -
                     next_section->get_km(prev_to_next_section));
 
-    if (iter == std::end(element_iter)) {
+    if (it == std::end(iter)) {
       break;
     }
 
-    ++iter;
+    ++it;
 
     last_section = next_section;
-    next_to_last_section = *iter;
+    next_to_last_section = proj(*it);
 
     prev_to_next_section = next_section;
-    next_section = *iter;
+    next_section = proj(*it);
   }
 
   return distance;
 }
 
+template <typename Iterable>
+  requires utls::yields<element::ptr, Iterable> &&
+           utls::is_input_iterable<Iterable>
+si::length get_path_length_from_sections(Iterable&& element_iter) {
+  return get_path_length_from_sections(
+      element_iter, [](element::ptr element_ptr) { return element_ptr; });
+}
+
 template <typename Iterable>
   requires utls::yields<node::ptr, Iterable> &&
            utls::is_input_iterable<Iterable>
 si::length get_path_length_from_sections(Iterable&& node_iter) {
-  return get_path_length_from_sections(utls::coro_map(
-      node_iter, [](auto&& node_ptr) { return node_ptr->element_; }));
+  return get_path_length_from_sections(
+      node_iter, [](node::ptr node_ptr) { return node_ptr->element_; });
 }
 
 }  // namespace soro::infra
\ No newline at end of file
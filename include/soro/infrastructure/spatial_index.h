@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "cista/reflection/comparable.h"
+
+#include "soro/base/soro_types.h"
+
+#include "soro/utls/coordinates/gps.h"
+
+namespace soro::infra {
+
+struct infrastructure_t;
+
+/*
+ * Packed static R-tree over the bounding boxes of all elements, stations,
+ * station routes and interlocking routes with a position.
+ *
+ * The items are sorted along a Hilbert curve over their centers, every
+ * NODE_SIZE consecutive boxes of a level form a node of the next level. All
+ * levels are stored consecutively in boxes_, from the leaves to the root, so
+ * the index is a few flat vectors and serialized with the infrastructure.
+ */
+struct spatial_index {
+  enum class kind : uint8_t {
+    ELEMENT,
+    STATION,
+    STATION_ROUTE,
+    INTERLOCKING_ROUTE
+  };
+
+  struct item {
+    CISTA_COMPARABLE()
+
+    kind kind_{kind::ELEMENT};
+    soro::size_t id_{0};
+  };
+
+  // empty: accepts every item
+  using filter = std::function<bool(item const&)>;
+
+  static constexpr soro::size_t NODE_SIZE = 16;
+
+  // queries return leaves, leaf l is items_[l] with the box boxes_[l]
+  using leaf = soro::size_t;
+
+  static constexpr soro::size_t NO_LIMIT =
+      std::numeric_limits<soro::size_t>::max();
+
+  // all leaves with a bounding box overlapping the viewport. with a limit the
+  // search stops after that many leaves, which ones is unspecified
+  std::vector<leaf> within(utls::bounding_box const& viewport,
+                           filter const& accept = {},
+                           soro::size_t const limit = NO_LIMIT) const;
+
+  // the k leaves closest to the position, closest first. the distance is
+  // measured to the bounding box of a leaf, 0 if it contains the position
+  std::vector<leaf> nearest(utls::gps const& position, soro::size_t const k,
+                            filter const& accept = {}) const;
+
+  bool empty() const noexcept;
+  soro::size_t size() const noexcept;
+
+  soro::vector<item> items_;
+  soro::vector<utls::bounding_box> boxes_;
+
+  // level l are the boxes [level_ends_[l - 1], level_ends_[l]), starting at
+  // the leaves, the last level is the root
+  soro::vector<soro::size_t> level_ends_;
+};
+
+std::string_view to_string(spatial_index::kind const k);
+
+spatial_index make_spatial_index(infrastructure_t const& infra);
+
+}  // namespace soro::infra
@@ -30,8 +30,8 @@ struct station {
   soro::vector<section::id> sections_{};
   soro::vector<element::ptr> elements_{};
 
-  soro::map<soro::string, soro::ptr<station_route>> station_routes_{};
-  soro::map<element_id, soro::vector<soro::ptr<station_route>>>
+  soro::hash_map<soro::string, soro::ptr<station_route>> station_routes_{};
+  soro::hash_map<element_id, soro::vector<soro::ptr<station_route>>>
       element_to_routes_{};
 
   soro::vector<border> borders_{};
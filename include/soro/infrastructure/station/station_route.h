@@ -1,6 +1,8 @@
 #pragma once
 
-#include "soro/utls/coroutine/recursive_generator.h"
+#include <iterator>
+
+#include "soro/utls/container/it_range.h"
 
 #include "soro/infrastructure/graph/element_data.h"
 #include "soro/infrastructure/graph/node.h"
@@ -52,6 +54,41 @@ struct station_route {
     soro::vector<node::idx> etcs_ends_{};
   };
 
+  // forward iterator yielding the route nodes in [from, to) of a station route
+  struct iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = route_node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    iterator() = default;
+    iterator(station_route const* sr, node::idx from, node::idx to);
+
+    reference operator*() const noexcept { return current_; }
+    pointer operator->() const noexcept { return &current_; }
+
+    iterator& operator++();
+    iterator operator++(int);
+
+    bool operator==(iterator const& o) const noexcept {
+      return node_idx_ == o.node_idx_;
+    }
+    bool operator!=(iterator const& o) const noexcept { return !(*this == o); }
+
+  private:
+    void set_current();
+
+    station_route const* sr_{nullptr};
+    node::idx node_idx_{node::INVALID_IDX};
+    node::idx to_{node::INVALID_IDX};
+    node::idx omit_idx_{0};
+    node::idx spl_idx_{0};
+    route_node current_{};
+  };
+
+  using range = utls::it_range<iterator>;
+
   node::idx size() const noexcept;
   node::ptr nodes(node::idx const idx) const;
   soro::vector<node::ptr> const& nodes() const;
@@ -74,11 +111,10 @@ struct station_route {
   bool operator==(station_route const& o) const;
   bool operator!=(station_route const& o) const;
 
-  utls::recursive_generator<route_node> iterate() const;
-  utls::recursive_generator<route_node> from(node::idx from) const;
-  utls::recursive_generator<route_node> to(node::idx to) const;
-  utls::recursive_generator<route_node> from_to(node::idx from,
-                                                node::idx to) const;
+  range iterate() const;
+  range from(node::idx from) const;
+  range to(node::idx to) const;
+  range from_to(node::idx from, node::idx to) const;
 
   node::optional_idx get_halt_idx(rs::FreightTrain freight) const;
   node::optional_ptr get_halt_node(rs::FreightTrain freight) const;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <span>
+
+#include "soro/base/soro_types.h"
+#include "soro/si/units.h"
+
+#include "soro/rolling_stock/train_series.h"
+
+namespace soro::rs {
+
+// the tractive and resistive forces of all vehicles of a train merged into a
+// single piecewise quadratic polynomial over the speed.
+//
+// segment i covers the speeds [bounds_[i - 1], bounds_[i]), the first segment
+// starts at 0 m/s. all values are stored in base SI units.
+struct force_model {
+  // ax² + bx + c
+  struct coefficients {
+    si::precision a_{0.0};
+    si::precision b_{0.0};
+    si::precision c_{0.0};
+  };
+
+  si::force tractive_force(si::speed const v) const;
+  si::force resistive_force(si::speed const v) const;
+
+  // (tractive force - resistive force) / (weight * mass factor)
+  si::acceleration acceleration(si::speed const v) const;
+
+  // the acceleration for all speeds in vs, written to out of the same size.
+  // runs of speeds in the same segment share its lookup, so neighbouring
+  // speeds should be neighbours in vs as well.
+  void acceleration(std::span<si::speed const> vs,
+                    std::span<si::acceleration> out) const;
+
+  soro::size_t segment(si::precision const v) const;
+
+  // searches the segment starting at hint, cheap if the speed is close to the
+  // one hint was found for
+  soro::size_t segment(si::precision const v, soro::size_t hint) const;
+
+  soro::vector<si::precision> bounds_;
+  soro::vector<coefficients> tractive_;
+  soro::vector<coefficients> acceleration_;
+  coefficients resistive_;
+
+  si::speed max_speed_{si::ZERO<si::speed>};
+};
+
+force_model make_force_model(soro::vector<traction_vehicle> const& vehicles,
+                             si::weight const weight,
+                             si::speed const max_speed);
+
+}  // namespace soro::rs
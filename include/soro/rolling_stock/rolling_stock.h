@@ -16,7 +16,7 @@ struct rolling_stock {
       std::string_view const series, std::string_view const owner,
       variant_id const variant_id) const;
 
-  soro::map<soro::string, train_series> train_series_;
+  soro::hash_map<soro::string, train_series> train_series_;
 };
 
 rolling_stock parse_rolling_stock(
@@ -1,12 +1,28 @@
 #pragma once
 
+#include <limits>
+
 #include "soro/rolling_stock/ctc.h"
+#include "soro/rolling_stock/force_model.h"
 #include "soro/rolling_stock/freight.h"
 #include "soro/rolling_stock/train_series.h"
 
 namespace soro::rs {
 
+// a train composition, interned per timetable and shared between all trains
+// running with the same traction vehicles and characteristic
 struct train_physics {
+  using id = uint32_t;
+  using ptr = soro::ptr<train_physics>;
+
+  static constexpr id INVALID = std::numeric_limits<id>::max();
+
+  // builds the composition together with its compiled force model
+  static train_physics make(soro::vector<traction_vehicle> tvs,
+                            si::weight const carriage_weight,
+                            si::length const length, si::speed const max_speed,
+                            CTC const ctc, FreightTrain const freight);
+
 #if !defined(SERIALIZE)
   train_physics() = default;
   // if we don't serialize we need a constructor since the members are private
@@ -26,6 +42,11 @@ struct train_physics {
 
   si::force resistive_force(si::speed const v) const;
 
+  // net acceleration when accelerating with full tractive force at speed v
+  si::acceleration acceleration(si::speed const v) const;
+
+  force_model const& model() const;
+
   si::acceleration deacceleration() const;
 
   rs::CTC ctc() const;
@@ -45,6 +66,8 @@ private:
   si::speed max_speed_{si::ZERO<si::speed>};
   rs::CTC ctc_{rs::CTC::NO};
   rs::FreightTrain freight_{rs::FreightTrain::NO};
+
+  force_model model_;
 };
 
 }  // namespace soro::rs
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "soro/runtime/runtime.h"
+
+namespace soro::runtime {
+
+// number of train variants advanced together by the batch kernel
+constexpr std::size_t BATCH_LANES = 16;
+
+/*
+ * Running time calculation for many variants of the same train, e.g. the same
+ * stop sequence run with different compositions or sequence point times.
+ *
+ * All variants must share the same interval geometry, i.e. run on the same
+ * path with the same freight flag and halt pattern. Up to BATCH_LANES variants
+ * are advanced through an interval in lockstep, the acceleration phase of all
+ * lanes is evaluated as one structure of arrays step.
+ *
+ * The compositions of the variants are looked up in bt.
+ *
+ * Returns the timestamps of every variant in the order of the variants,
+ * equal to the ones of runtime_calculation up to floating point differences.
+ */
+std::vector<timestamps> batch_runtime_calculation(
+    std::span<tt::train const> variants, tt::base_timetable const& bt,
+    infra::infrastructure const& infra, infra::type_set const& record_types);
+
+}  // namespace soro::runtime
@@ -1,8 +1,17 @@
 #pragma once
 
-#include "utl/concat.h"
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "cista/hash.h"
 
 #include "soro/infrastructure/infrastructure.h"
+#include "soro/rolling_stock/freight.h"
 #include "soro/timetable/timetable.h"
 
 namespace soro::runtime {
@@ -21,25 +30,12 @@ struct event {
 struct interval {
   interval(si::length const dist, si::speed const left_limit,
            si::speed const right_limit, tt::sequence_point::optional_ptr sp,
-           std::vector<event> events)
+           std::span<event const> events)
       : distance_(dist),
         limit_left_{left_limit},
         limit_right_{right_limit},
         sequence_point_{std::move(sp)},
-        events_{std::move(events)} {}
-
-  void append(interval const& o) {
-    limit_right_ = o.limit_right_;
-    utl::concat(events_, o.events_);
-
-    utls::sassert(
-        !(sequence_point_.has_value() && o.sequence_point_.has_value()),
-        "Appending two intervals where both have a sequence point");
-
-    if (o.sequence_point_.has_value()) {
-      sequence_point_ = o.sequence_point_;
-    }
-  }
+        events_{events} {}
 
   bool is_halt() const { return sequence_point_.has_value(); }
 
@@ -61,19 +57,119 @@ struct interval {
     return std::min(target_speed(), tp.max_speed());
   }
 
+  // the highest speed the train may run at in the interval
+  si::speed max_speed(rs::train_physics const& tp) const {
+    return std::min(limit_left_, tp.max_speed());
+  }
+
   si::length distance_{si::INVALID<si::length>};
   si::speed limit_left_{si::INVALID<si::speed>};
   si::speed limit_right_{si::INVALID<si::speed>};
 
   tt::sequence_point::optional_ptr sequence_point_{};
 
+  // points into the events of the interval geometry the interval belongs to
+  std::span<event const> events_;
+};
+
+// the train independent part of an interval list, identical for all trains
+// running on the same path with the same freight flag and halt pattern.
+//
+// halts are stored as an index into the sequence points of the train,
+// the events of all intervals are stored in a single array.
+struct interval_geometry {
+  static constexpr auto NO_SEQUENCE_POINT =
+      std::numeric_limits<soro::size_t>::max();
+
+  struct border {
+    bool is_halt() const { return sequence_point_idx_ != NO_SEQUENCE_POINT; }
+
+    si::length distance_{si::INVALID<si::length>};
+    si::speed limit_left_{si::INVALID<si::speed>};
+    si::speed limit_right_{si::INVALID<si::speed>};
+
+    soro::size_t sequence_point_idx_{NO_SEQUENCE_POINT};
+
+    // [events_begin_, events_end_) in events_
+    soro::size_t events_begin_{0};
+    soro::size_t events_end_{0};
+  };
+
+  std::vector<border> borders_;
   std::vector<event> events_;
 };
 
-using interval_list = soro::vector<interval>;
+// the intervals of a single train, bound to the sequence point times of the
+// train and with speed limits adjusted to its braking capabilities.
+struct interval_list {
+  using container = std::vector<interval>;
+
+  auto begin() const { return std::cbegin(intervals_); }
+  auto end() const { return std::cend(intervals_); }
+
+  auto size() const { return intervals_.size(); }
+  auto empty() const { return intervals_.empty(); }
+
+  interval const& operator[](std::size_t const idx) const {
+    return intervals_[idx];
+  }
+  interval& operator[](std::size_t const idx) { return intervals_[idx]; }
+
+  interval const& front() const { return intervals_.front(); }
+  interval const& back() const { return intervals_.back(); }
+
+  // keeps the events referenced by the intervals alive
+  std::shared_ptr<interval_geometry const> geometry_;
+  container intervals_;
+};
+
+interval_geometry get_interval_geometry(tt::train const& train,
+                                        infra::type_set const& event_types,
+                                        infra::infrastructure const& infra);
+
+// the speed limits are adjusted to the composition the train runs with
+interval_list bind_interval_list(
+    std::shared_ptr<interval_geometry const> geometry, tt::train const& train,
+    rs::train_physics const& physics);
 
 interval_list get_interval_list(tt::train const& train,
+                                rs::train_physics const& physics,
                                 infra::type_set const& event_types,
                                 infra::infrastructure const& infra);
 
+// memoizes get_interval_geometry for trains sharing the same path, freight
+// flag and halt pattern. the times of the sequence points are not part of
+// the key, they are bound to the shared geometry for every train.
+// safe to use from multiple threads at once.
+struct interval_cache {
+  // the properties of a sequence point relevant for the geometry
+  enum class point_kind : uint8_t { PASS, CHECKPOINT, HALT };
+
+  struct key {
+    bool operator==(key const& o) const = default;
+
+    std::vector<infra::interlocking_route::id> path_;
+    std::vector<std::pair<infra::station_route::id, point_kind>> points_;
+    std::vector<infra::type> event_types_;
+    rs::FreightTrain freight_{rs::FreightTrain::NO};
+  };
+
+  struct key_hash {
+    cista::hash_t operator()(key const& k) const;
+  };
+
+  interval_list get(tt::train const& train, rs::train_physics const& physics,
+                    infra::type_set const& event_types,
+                    infra::infrastructure const& infra);
+
+  void report() const;
+
+  std::shared_mutex mutex_;
+  std::unordered_map<key, std::shared_ptr<interval_geometry const>, key_hash>
+      cache_;
+
+  std::atomic_size_t hits_{0};
+  std::atomic_size_t misses_{0};
+};
+
 }  // namespace soro::runtime
@@ -4,6 +4,7 @@
 
 #include "soro/infrastructure/graph/type_set.h"
 #include "soro/infrastructure/infrastructure.h"
+#include "soro/runtime/interval.h"
 #include "soro/runtime/runtime_physics.h"
 #include "soro/timetable/timetable.h"
 
@@ -26,12 +27,29 @@ struct timestamps {
   soro::vector<soro::size_t> halt_indices_;
 };
 
+relative_time si_to_relative_time(si::time const t);
+si::time relative_to_si_time(relative_time const t);
+
 /*
  * For every element type given in record_types the returned timestamps contain
  * a timestamp with arrival and departure value.
  */
 timestamps runtime_calculation(tt::train const& train,
+                               rs::train_physics const& physics,
                                infra::infrastructure const& infra,
                                infra::type_set const& record_types);
 
+// same as above, but shares the interval geometry with all trains on the same
+// path, freight flag and halt pattern via the given cache.
+timestamps runtime_calculation(tt::train const& train,
+                               rs::train_physics const& physics,
+                               infra::infrastructure const& infra,
+                               infra::type_set const& record_types,
+                               interval_cache& cache);
+
+// runs the calculation on an interval list already bound to the train
+timestamps runtime_calculation(tt::train const& train,
+                               rs::train_physics const& physics,
+                               interval_list const& intervals);
+
 }  // namespace soro::runtime
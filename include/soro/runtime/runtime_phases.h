@@ -0,0 +1,70 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include "soro/runtime/interval.h"
+#include "soro/runtime/runtime.h"
+#include "soro/runtime/runtime_physics.h"
+
+namespace soro::runtime {
+
+/*
+ * The acceleration, coasting and deacceleration phase of a train running
+ * through an interval, starting at the given speed.
+ *
+ * The acceleration phase is given as the steps the train could accelerate in
+ * the interval, as returned by accelerate(), empty if it does not accelerate.
+ * If there is no room to brake to the target speed afterwards, the
+ * acceleration ends at an earlier step.
+ */
+struct interval_phases {
+  interval_phases(std::span<runtime_result const> accel_results,
+                  si::speed current_speed, interval const& prev_interval,
+                  interval const& interval, rs::train_physics const& tp);
+
+  bool has_accel_phase() const { return !accel_results_.empty(); }
+  bool has_coast_phase() const { return coast_profile_.has_value(); }
+  bool has_deaccel_phase() const { return deaccel_profile_.has_value(); }
+
+  si::speed end_speed() const;
+  si::time duration() const;
+
+  // the time after the start of the interval at which the train has run
+  // delta_distance into it
+  si::time event_time(si::length delta_distance) const;
+
+  std::span<runtime_result const> accel_results_;
+  runtime_result accel_;
+
+  std::optional<coast_profile> coast_profile_;
+  runtime_result coast_;
+
+  std::optional<brake_profile> deaccel_profile_;
+  runtime_result deaccel_;
+};
+
+/*
+ * The running time calculation of a single train, advanced interval by
+ * interval. The timestamps of the departure interval are added right away.
+ */
+struct runtime_state {
+  runtime_state(tt::train const& train, rs::train_physics const& physics,
+                interval_list const& intervals);
+
+  // the steps the train could accelerate in the interval at idx
+  runtime_results accelerate(soro::size_t idx) const;
+
+  // runs through the interval at idx with the given acceleration steps, adds
+  // the timestamps of its events and advances to the departure from it
+  void advance(soro::size_t idx, std::span<runtime_result const> accel_results);
+
+  tt::train const* train_;
+  rs::train_physics const* physics_;
+  interval_list const* intervals_;
+
+  runtime_result current_;
+  timestamps ts_;
+};
+
+}  // namespace soro::runtime
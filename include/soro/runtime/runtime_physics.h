@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -38,9 +40,45 @@ inline std::ostream& operator<<(std::ostream& out, runtime_results const& rr) {
   return out;
 }
 
+// the steps of brake() without materializing them
+struct brake_profile {
+  brake_profile(rs::train_physics const& tp, si::speed initial_speed,
+                si::speed target_speed);
+
+  runtime_result last() const;
+
+  // the time of the first step with offset + braked distance >= delta
+  std::optional<si::time> reaching(si::length offset, si::length delta) const;
+
+  si::speed initial_speed_;
+  si::speed target_speed_;
+  si::acceleration deacceleration_;
+
+  si::length distance_{si::ZERO<si::length>};
+  std::size_t steps_{0};
+};
+
+// the steps of coast() without materializing them
+struct coast_profile {
+  coast_profile(si::speed current_speed, si::length distance);
+
+  runtime_result last() const;
+
+  // the time of the first step with offset + coasted distance >= delta
+  std::optional<si::time> reaching(si::length offset, si::length delta) const;
+
+  si::speed speed_;
+  si::length distance_;
+  std::size_t steps_{0};
+};
+
 runtime_results accelerate(rs::train_physics const& tp, si::speed initial_speed,
                            si::speed target_speed, si::length max_distance);
 
+// drops the last step of an acceleration if it went past max_distance, the
+// acceleration then ends at max_distance
+void limit_distance(runtime_results& accel_results, si::length max_distance);
+
 runtime_results brake(rs::train_physics const& p, si::speed initial_speed,
                       si::speed target_speed);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "soro/simulation/dpd.h"
+#include "soro/simulation/ordering/ordering_graph.h"
 #include "soro/simulation/sim_graph.h"
 #include "soro/utls/unixtime.h"
 
@@ -56,6 +57,31 @@ inline TimeSpeedDPD get_runtime_distribution(utls::unixtime const& arrival,
   return result;
 }
 
-struct disruption {};
+// events injected into a simulation on top of the sampled delays
+struct disruption {
+  // the node ends later by extra_, e.g. a train leaving late is a delay of the
+  // first node of its trip
+  struct delay {
+    ordering_node::id node_{ordering_node::INVALID};
+    duration2 extra_{duration2::zero()};
+  };
+
+  // the interlocking route can not be entered during closed_
+  struct closure {
+    infra::interlocking_route::id ir_{infra::interlocking_route::INVALID};
+    tt::interval closed_{};
+  };
+
+  bool empty() const {
+    return delays_.empty() && closures_.empty() && reversed_orders_.empty();
+  }
+
+  std::vector<delay> delays_;
+  std::vector<closure> closures_;
+
+  // ordering edges from -> to turned into to -> from, i.e. the train of the
+  // latter uses the contested route first
+  std::vector<ordering_edge> reversed_orders_;
+};
 
 }  // namespace soro::simulation
\ No newline at end of file
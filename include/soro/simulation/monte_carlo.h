@@ -0,0 +1,148 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "soro/base/time.h"
+
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/simulation/disruption.h"
+#include "soro/simulation/dpd.h"
+#include "soro/simulation/ordering/ordering_graph.h"
+#include "soro/simulation/simulation_options.h"
+#include "soro/timetable/timetable.h"
+
+namespace soro::simulation {
+
+// a discrete delay distribution, sampled by inverting its cumulative
+// distribution. probabilities are normalized by their total mass.
+struct delay_distribution {
+  duration2 sample(double const u) const;
+
+  std::vector<duration2> delays_;
+  std::vector<double> cdf_;
+};
+
+delay_distribution make_halt_delay_distribution();
+delay_distribution make_runtime_delay_distribution();
+
+// everything the sampling needs that does not change between replications:
+// the scheduled times of every ordering node, the halts they contain, an
+// evaluation order and the delay distributions.
+struct monte_carlo_model {
+  struct node {
+    absolute_time scheduled_start_{absolute_time::max()};
+    absolute_time scheduled_end_{absolute_time::max()};
+
+    // halts where a dwell delay is drawn, including the departure halt
+    soro::size_t halts_{0};
+  };
+
+  std::vector<node> nodes_;
+  std::vector<ordering_node::id> topological_order_;
+
+  delay_distribution halt_delays_;
+  delay_distribution runtime_delays_;
+};
+
+monte_carlo_model make_monte_carlo_model(ordering_graph const& og,
+                                         infra::infrastructure const& infra,
+                                         tt::timetable const& tt);
+
+struct monte_carlo_options {
+  soro::size_t replications_{1000};
+  uint64_t seed_{0};
+
+  std::vector<double> quantiles_{0.5, 0.9, 0.99};
+
+  // delays are aggregated into bins of this width, delays beyond the last
+  // bin are reported as bin_count_ * bin_width_
+  duration2 bin_width_{6};
+  soro::size_t bin_count_{600};
+
+  // replications are run in blocks of this size, every block is evaluated in
+  // parallel. the results do not depend on it, it only bounds the memory.
+  soro::size_t block_size_{256};
+
+  // disable when the caller already runs several simulations in parallel
+  bool parallel_{true};
+
+  simulation_options distributions_;
+};
+
+struct monte_carlo_result {
+  // the sampled arrival delays at the end of the node for every quantile
+  std::span<duration2 const> quantiles(ordering_node::id const id) const;
+  duration2 quantile(ordering_node::id const id,
+                     soro::size_t const quantile_idx) const;
+
+  // the sampled arrival time at the end of the node for every quantile
+  absolute_time arrival(monte_carlo_model const& model,
+                        ordering_node::id const id,
+                        soro::size_t const quantile_idx) const;
+
+  std::vector<double> levels_;
+  soro::size_t replications_{0};
+
+  // node-major, levels_.size() entries per node
+  std::vector<duration2> quantiles_;
+  std::vector<double> mean_delay_;
+};
+
+/*
+ * Samples halt and runtime delays for every node of the ordering graph and
+ * propagates them along the train chains and ordering edges.
+ *
+ * Every random number is derived from (seed, replication, node, stream) by a
+ * counter based generator, the results are bit-reproducible regardless of the
+ * number of threads.
+ */
+monte_carlo_result simulate_monte_carlo(monte_carlo_model const& model,
+                                        ordering_graph const& og,
+                                        monte_carlo_options const& opts);
+monte_carlo_result simulate_monte_carlo(monte_carlo_model const& model,
+                                        ordering_graph const& og,
+                                        monte_carlo_options const& opts,
+                                        disruption const& d);
+
+// statistics only for the given nodes, the entries of all other nodes stay
+// zero. every node is still simulated, but the histograms only cover these
+monte_carlo_result simulate_monte_carlo(
+    monte_carlo_model const& model, ordering_graph const& og,
+    monte_carlo_options const& opts, disruption const& d,
+    std::span<ordering_node::id const> const nodes);
+
+// a simulation keeping the arrival of every node in every replication,
+// allows answering what-if questions by re-simulating only what changed
+struct monte_carlo_state {
+  monte_carlo_options opts_;
+
+  // all disruptions applied so far
+  disruption disruption_;
+
+  // replication-major, the arrival at the end of every node
+  std::vector<absolute_time> ends_;
+
+  monte_carlo_result result_;
+};
+
+monte_carlo_state make_monte_carlo_state(monte_carlo_model const& model,
+                                         ordering_graph const& og,
+                                         monte_carlo_options const& opts,
+                                         disruption d = {});
+
+/*
+ * Adds the disruption to the state and re-samples only the nodes downstream
+ * of the disrupted ones. Within a replication propagation stops at nodes whose
+ * arrival moves by at most the tolerance.
+ *
+ * With a zero tolerance the state equals one simulated with all disruptions
+ * from the start. Returns the nodes whose arrivals changed.
+ */
+std::vector<ordering_node::id> resimulate(monte_carlo_state& state,
+                                          monte_carlo_model const& model,
+                                          ordering_graph const& og,
+                                          disruption const& added,
+                                          duration2 tolerance = duration2::zero());
+
+}  // namespace soro::simulation
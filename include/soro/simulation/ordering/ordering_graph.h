@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stop_token>
+
 #include "soro/utls/unixtime.h"
 
 #include "soro/infrastructure/infrastructure.h"
@@ -33,8 +35,10 @@ struct ordering_graph {
 
   ordering_graph() = default;
   ordering_graph(infra::infrastructure const& infra, tt::timetable const& tt);
+
+  // stops early with an incomplete graph once stop is requested
   ordering_graph(infra::infrastructure const& infra, tt::timetable const& tt,
-                 filter const& filter);
+                 filter const& filter, std::stop_token const& stop = {});
 
   std::span<const ordering_node> trip_nodes(tt::train::trip const trip) const;
 
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/simulation/disruption.h"
+#include "soro/simulation/monte_carlo.h"
+#include "soro/simulation/ordering/ordering_graph.h"
+#include "soro/timetable/timetable.h"
+
+namespace soro::simulation {
+
+struct scenario {
+  std::string name_;
+  disruption disruption_;
+};
+
+// the arrival delay at the end of every trip, for every scenario
+struct scenario_table {
+  std::span<duration2 const> quantiles(soro::size_t const scenario_idx,
+                                       soro::size_t const trip_idx) const;
+  double mean_delay(soro::size_t const scenario_idx,
+                    soro::size_t const trip_idx) const;
+
+  // one line per scenario and trip:
+  // scenario,train,anchor,mean,<one column per quantile level>
+  void write_csv(std::ostream& out) const;
+
+  std::vector<std::string> scenarios_;
+  std::vector<tt::train::trip> trips_;
+  std::vector<double> levels_;
+
+  // scenario-major, trips_.size() * levels_.size() entries per scenario
+  std::vector<duration2> quantiles_;
+  // scenario-major, trips_.size() entries per scenario
+  std::vector<double> mean_delay_;
+};
+
+/*
+ * Evaluates many disruption scenarios against the same infrastructure and
+ * timetable. The ordering graph, the running time calculations and the
+ * sampling model are built once, every scenario only adds its disruption as
+ * an overlay. Scenarios are simulated concurrently.
+ */
+struct scenario_batch {
+  scenario_batch(infra::infrastructure const& infra, tt::timetable const& tt,
+                 ordering_graph::filter const& filter,
+                 monte_carlo_options opts);
+
+  scenario_table run(std::span<scenario const> scenarios) const;
+
+  ordering_graph og_;
+  monte_carlo_model model_;
+  monte_carlo_options opts_;
+
+  // the trips of the ordering graph and the last node of every trip
+  std::vector<tt::train::trip> trips_;
+  std::vector<ordering_node::id> trip_ends_;
+};
+
+}  // namespace soro::simulation
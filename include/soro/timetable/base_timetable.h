@@ -2,15 +2,20 @@
 
 #include "soro/timetable/timetable_options.h"
 #include "soro/timetable/train.h"
+#include "soro/timetable/trip_index.h"
 
 namespace soro::tt {
 
 struct base_timetable {
   soro::vector<train> trains_;
 
+  // every distinct train composition, referenced by train::composition_
+  soro::vector<rs::train_physics> compositions_;
+
   soro::map<train::number, train::ptr> number_to_train_;
 
   interval interval_{};
+  trip_index trip_index_;
   soro::string source_;
 };
 
@@ -63,8 +63,20 @@ struct bitfield {
   bitfield operator|=(bitfield const& o) noexcept;
   friend bitfield operator|(bitfield const& lhs, bitfield const& rhs) noexcept;
 
+  // keeps the range of this bitfield, days outside the range of o are unset
+  bitfield operator&=(bitfield const& o) noexcept;
+  friend bitfield operator&(bitfield const& lhs, bitfield const& rhs) noexcept;
+
+  // the same service days moved by offset days, e.g. the arrival days of
+  // trips arriving on the day after their departure
+  bitfield shifted(date::days const offset) const noexcept;
+
   soro::size_t count() const noexcept;
 
+  // number of set days in [from, to]
+  soro::size_t count(anchor_time const from,
+                     anchor_time const to) const noexcept;
+
   absolute_time first_set_date() const noexcept;
   absolute_time last_set_date() const noexcept;
 
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cista/hash.h"
+
 #include "soro/utls/result.h"
 
 #include "soro/infrastructure/infrastructure.h"
@@ -17,6 +24,48 @@ utls::result<interlocking_transformation> transform_to_interlocking(
     stop_sequence const& stop_sequence, rs::FreightTrain freight,
     infra::infrastructure const& infra);
 
+// memoizes transform_to_interlocking for stop sequences sharing the same
+// station routes, halt pattern, freight and break in/out.
+// the times of the sequence points are not part of the key, so many
+// construction trains of the same line share a single entry.
+// safe to use from multiple threads at once.
+struct interlocking_transformation_cache {
+  // the properties of a sequence point relevant for the transformation
+  enum class point_kind : uint8_t { PASS, CHECKPOINT, HALT };
+
+  struct key {
+    bool operator==(key const& o) const = default;
+
+    std::vector<std::pair<infra::station_route::id, point_kind>> points_;
+    rs::FreightTrain freight_{rs::FreightTrain::NO};
+    bool break_in_{false};
+    bool break_out_{false};
+  };
+
+  struct key_hash {
+    cista::hash_t operator()(key const& k) const;
+  };
+
+  // the interlocking path together with the indices of the stop sequence
+  // points that are kept as sequence points of the train
+  struct value {
+    soro::vector<infra::interlocking_route::id> path_;
+    std::vector<std::size_t> sequence_point_idxs_;
+  };
+
+  utls::result<interlocking_transformation> get(
+      stop_sequence const& stop_sequence, rs::FreightTrain freight,
+      infra::infrastructure const& infra);
+
+  void report() const;
+
+  std::shared_mutex mutex_;
+  std::unordered_map<key, utls::result<value>, key_hash> cache_;
+
+  std::atomic_size_t hits_{0};
+  std::atomic_size_t misses_{0};
+};
+
 void print_ir_generating_failures();
 
 }  // namespace soro::tt
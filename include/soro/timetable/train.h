@@ -1,5 +1,6 @@
 #pragma once
 
+#include <iterator>
 #include <utility>
 
 #include "soro/utls/container/id_iterator.h"
@@ -16,8 +17,11 @@
 
 namespace soro::tt {
 
+struct base_timetable;
+
 // yielded when iterating a train
 struct train_node : infra::route_node {
+  train_node() = default;
   train_node(route_node const& rn, sequence_point::optional_ptr sp);
 
   bool omitted() const;  // NOLINT
@@ -71,9 +75,59 @@ struct train {
     interval interval_;
   };
 
+  // forward iterator yielding the train nodes along the path of a train,
+  // chains the iterators of all interlocking routes in the path
+  struct node_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = train_node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    node_iterator() = default;
+    node_iterator(train const* train, infra::infrastructure const* infra,
+                  soro::size_t path_idx);
+
+    reference operator*() const noexcept { return current_; }
+    pointer operator->() const noexcept { return &current_; }
+
+    node_iterator& operator++();
+    node_iterator operator++(int);
+
+    bool operator==(node_iterator const& o) const noexcept {
+      return path_idx_ == o.path_idx_ && ir_it_ == o.ir_it_;
+    }
+    bool operator!=(node_iterator const& o) const noexcept {
+      return !(*this == o);
+    }
+
+  private:
+    void enter_path_idx();
+    void skip_exhausted();
+    void set_current();
+
+    train const* train_{nullptr};
+    infra::infrastructure const* infra_{nullptr};
+
+    soro::size_t path_idx_{0};
+    soro::size_t sp_idx_{0};
+
+    infra::interlocking_route::iterator ir_it_{};
+    infra::interlocking_route::iterator ir_end_{};
+
+    train_node current_{};
+  };
+
   utls::it_range<iterator> departures(interval const& interval) const;
   utls::it_range<iterator> departures() const;
 
+  // the composition in the compositions of the timetable the train belongs to
+  rs::train_physics const& physics(base_timetable const& bt) const;
+
+  // takes the freight and ctc flags of the composition
+  void set_composition(rs::train_physics::id const id,
+                       rs::train_physics const& composition);
+
   rs::FreightTrain freight() const;
   bool is_freight() const;
 
@@ -109,7 +163,7 @@ struct train {
   infra::interlocking_route const& last_interlocking_route(
       infra::infrastructure const&) const;
 
-  utls::recursive_generator<train_node> iterate(
+  utls::it_range<node_iterator> iterate(
       infra::infrastructure const& infra) const;
 
   auto path(infra::infrastructure const& infra) const {
@@ -129,7 +183,14 @@ struct train {
   si::length length_;
 
   bitfield service_days_;
-  rs::train_physics physics_;
+
+  // the interned composition in base_timetable::compositions_, an index stays
+  // valid when the compositions are moved or (de)serialized
+  rs::train_physics::id composition_{rs::train_physics::INVALID};
+
+  // of the composition, needed without the timetable at hand
+  rs::FreightTrain freight_{rs::FreightTrain::NO};
+  rs::CTC ctc_{rs::CTC::NO};
 };
 
 }  // namespace soro::tt
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "soro/base/soro_types.h"
+#include "soro/base/time.h"
+
+#include "soro/timetable/interval.h"
+#include "soro/timetable/train.h"
+
+namespace soro::tt {
+
+// index over the event intervals of all trips in a timetable.
+//
+// all trips are stored sorted by their first departure. a segment tree over
+// this order holds the latest arrival of every range of trips, an overlap query
+// only descends into ranges reaching into the query interval. a single long
+// trip does not widen the search for all others, the query takes O(log n) per
+// overlapping trip.
+//
+// additionally the trips of every train are stored consecutively, sorted by
+// their first departure. since all trips of a train have the same duration
+// their arrivals are sorted as well, which allows answering window queries
+// for a single train with two binary searches.
+struct trip_index {
+  struct entry {
+    bool operator==(entry const& o) const = default;
+
+    interval interval_{};
+    train::trip trip_{};
+  };
+
+  // all trips with an event interval overlapping the given interval,
+  // sorted by first departure
+  std::vector<train::trip> overlapping(interval const& i) const;
+
+  // all trips of the given train with an event interval overlapping the given
+  // interval, sorted by first departure
+  std::span<entry const> overlapping(train::id const train_id,
+                                     interval const& i) const;
+
+  std::span<entry const> trips(train::id const train_id) const;
+
+  soro::size_t size() const noexcept;
+  bool empty() const noexcept;
+
+  // all trips, sorted by first departure
+  soro::vector<entry> by_departure_;
+
+  // segment tree over by_departure_, node n has the children 2n and 2n + 1.
+  // the second half are the leaves, by_departure_[i] is leaf i
+  soro::vector<absolute_time> latest_arrival_;
+
+  // trips of train t are train_trips_[train_offsets_[t], train_offsets_[t+1])
+  soro::vector<entry> train_trips_;
+  soro::vector<soro::size_t> train_offsets_;
+};
+
+trip_index make_trip_index(soro::vector<train> const& trains);
+
+}  // namespace soro::tt
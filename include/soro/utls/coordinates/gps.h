@@ -27,6 +27,26 @@ struct gps {
 };
 
 struct bounding_box {
+  void extend(gps const& p) {
+    south_west_.lon_ = std::min(south_west_.lon_, p.lon_);
+    south_west_.lat_ = std::min(south_west_.lat_, p.lat_);
+    north_east_.lon_ = std::max(north_east_.lon_, p.lon_);
+    north_east_.lat_ = std::max(north_east_.lat_, p.lat_);
+  }
+
+  // borders are inclusive, an empty bounding box contains nothing
+  bool contains(gps const& p) const {
+    return south_west_.lon_ <= p.lon_ && p.lon_ <= north_east_.lon_ &&
+           south_west_.lat_ <= p.lat_ && p.lat_ <= north_east_.lat_;
+  }
+
+  bool overlaps(bounding_box const& o) const {
+    return south_west_.lon_ <= o.north_east_.lon_ &&
+           o.south_west_.lon_ <= north_east_.lon_ &&
+           south_west_.lat_ <= o.north_east_.lat_ &&
+           o.south_west_.lat_ <= north_east_.lat_;
+  }
+
   gps south_west_{.lon_ = gps::MAX_INVALID, .lat_ = gps::MAX_INVALID};
   gps north_east_{.lon_ = gps::INVALID, .lat_ = gps::INVALID};
 };
@@ -37,10 +57,7 @@ bounding_box get_bounding_box(Range&& r) {
   bounding_box bb;
 
   for (auto const& p : r) {
-    bb.south_west_.lon_ = std::min(bb.south_west_.lon_, p.lon_);
-    bb.south_west_.lat_ = std::min(bb.south_west_.lat_, p.lat_);
-    bb.north_east_.lon_ = std::max(bb.north_east_.lon_, p.lon_);
-    bb.north_east_.lat_ = std::max(bb.north_east_.lat_, p.lat_);
+    bb.extend(p);
   }
 
   return bb;
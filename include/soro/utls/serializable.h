@@ -25,12 +25,21 @@ struct serializable {
 
   ~serializable() = default;
 
+  // written to a temporary file first and renamed to fp, readers which
+  // memory mapped an older fp keep their file until they unmap it
   void save(std::filesystem::path const& fp) const {
 #if defined(SERIALIZE)
     if (cista::holds_alternative<T>(mem_)) {
-      cista::buf mmap{
-          cista::mmap{fp.string().c_str(), cista::mmap::protection::WRITE}};
-      cista::serialize<MODE>(mmap, mem_.template as<T>());
+      auto tmp = fp;
+      tmp += ".tmp";
+
+      {
+        cista::buf mmap{
+            cista::mmap{tmp.string().c_str(), cista::mmap::protection::WRITE}};
+        cista::serialize<MODE>(mmap, mem_.template as<T>());
+      }
+
+      std::filesystem::rename(tmp, fp);
     } else {
       throw utl::fail(
           "Saving a deserialized object to a different path not yet "
@@ -122,61 +122,66 @@ bool interlocking_route::operator==(interlocking_route const& o) const {
   return this->id_ == o.id_;
 }
 
-namespace detail {
-
-utls::recursive_generator<route_node> from_to(
-    interlocking_route::ptr const ir,
-    decltype(ir->station_routes_)::const_iterator from_it, node::idx const from,
-    decltype(ir->station_routes_)::const_iterator to_it, node::idx const to,
-    infrastructure const& infra) {
-
-  utls::sassert(ir->station_routes_.size() > 1,
-                "Called from_to_impl with a single station route in IR {}, "
-                "call from_to_single_imple instead",
-                ir->id_);
-  utls::sassert(from_it != std::end(ir->station_routes_),
-                "Station route {} is not part of interlocking route {}, but "
-                "got it for iteration.",
-                *from_it, ir->id_);
-  utls::sassert(to_it != std::end(ir->station_routes_),
-                "Station route {} is not part of interlocking route {}, but "
-                "got it for iteration.",
-                *to_it, ir->id_);
+interlocking_route::iterator::iterator(sr_iterator const from_it,
+                                       node::idx const from,
+                                       sr_iterator const to_it,
+                                       node::idx const to,
+                                       infrastructure_t const* infra)
+    : sr_it_{from_it}, to_it_{to_it}, to_{to}, infra_{infra} {
   utls::sassert(std::distance(from_it, to_it) >= 0,
                 "To station route is located before from station route in "
                 "interlocking route iterator.");
-  utls::sassert(*from_it != *to_it,
-                "Don't call this with from == to, "
-                "since it will yield the wrong nodes.");
 
-  co_yield infra->station_routes_[*from_it]->from(from);
-  ++from_it;
+  auto const& sr = infra_->station_routes_[*sr_it_];
+  auto const nodes = sr->from_to(from, sr_it_ == to_it_ ? to_ : sr->size());
 
-  for (; from_it != to_it; ++from_it) {
-    co_yield infra->station_routes_[*from_it]->iterate();
+  node_it_ = nodes.begin();
+  node_end_ = nodes.end();
+
+  skip_exhausted();
+}
+
+void interlocking_route::iterator::skip_exhausted() {
+  while (node_it_ == node_end_ && sr_it_ != to_it_) {
+    ++sr_it_;
+
+    auto const& sr = infra_->station_routes_[*sr_it_];
+    auto const nodes = sr_it_ == to_it_ ? sr->to(to_) : sr->iterate();
+
+    node_it_ = nodes.begin();
+    node_end_ = nodes.end();
   }
+}
 
-  co_yield infra->station_routes_[*to_it]->to(to);
+interlocking_route::iterator& interlocking_route::iterator::operator++() {
+  ++node_it_;
+  skip_exhausted();
+  return *this;
 }
 
-}  // namespace detail
+interlocking_route::iterator interlocking_route::iterator::operator++(int) {
+  auto copy = *this;
+  ++(*this);
+  return copy;
+}
 
-utls::recursive_generator<route_node> interlocking_route::from_to(
+interlocking_route::range interlocking_route::from_to(
     station_route::id const from_sr, node::idx const from,
     station_route::id const to_sr, node::idx const to,
     infrastructure const& infra) const {
 
+  auto from_it = std::cbegin(this->station_routes_);
+  auto to_it = from_it;
+
   if (this->station_routes_.size() == 1) {
     utls::sassert(from_sr == to_sr,
                   "Only one station route in interlocking route {}, but "
                   "while iterating "
                   "got from {} and to {}.",
                   this->id_, from_sr, to_sr);
-
-    co_yield this->first_sr(infra)->from_to(from, to);
   } else {
-    auto from_it = utls::find(this->station_routes_, from_sr);
-    auto to_it = utls::find(this->station_routes_, to_sr);
+    from_it = utls::find(this->station_routes_, from_sr);
+    to_it = utls::find(this->station_routes_, to_sr);
 
     utls::sassert(from_it != std::end(this->station_routes_),
                   "Station route {} is not part of interlocking route {}, but "
@@ -186,41 +191,35 @@ utls::recursive_generator<route_node> interlocking_route::from_to(
                   "Station route {} is not part of interlocking route {}, but "
                   "got it for iteration.",
                   to_sr, this->id_);
-    utls::sassert(std::distance(from_it, to_it) >= 0,
-                  "To station route is located before from station route in "
-                  "interlocking route iterator.");
-
-    if (*from_it == *to_it) {
-      co_yield infra->station_routes_[*from_it]->from_to(from, to);
-    } else {
-      co_yield detail::from_to(this, from_it, from, to_it, to, infra);
-    }
   }
+
+  auto const* infra_t = infra.operator->();
+  return utls::make_range(iterator{from_it, from, to_it, to, infra_t},
+                          iterator{to_it, to, to_it, to, infra_t});
 }
 
-utls::recursive_generator<route_node> interlocking_route::to(
+interlocking_route::range interlocking_route::to(
     station_route::id const sr_id, node::idx const to,
     infrastructure const& infra) const {
-  co_yield this->from_to(this->station_routes_.front(), start_offset_, sr_id,
-                         to, infra);
+  return this->from_to(this->station_routes_.front(), start_offset_, sr_id, to,
+                       infra);
 }
 
-utls::recursive_generator<route_node> interlocking_route::from(
+interlocking_route::range interlocking_route::from(
     station_route::id const sr_id, node::idx const from,
     infrastructure const& infra) const {
-  co_yield this->from_to(sr_id, from, station_routes_.back(), end_offset_,
-                         infra);
+  return this->from_to(sr_id, from, station_routes_.back(), end_offset_, infra);
 }
 
-utls::recursive_generator<route_node> interlocking_route::iterate(
+interlocking_route::range interlocking_route::iterate(
     infrastructure const& infra) const {
-  if (station_routes_.size() == 1) {
-    co_yield this->first_sr(infra)->from_to(start_offset_, end_offset_);
-  } else {
-    co_yield detail::from_to(this, std::cbegin(station_routes_), start_offset_,
-                             std::cend(station_routes_) - 1, end_offset_,
-                             infra);
-  }
+  auto const from_it = std::cbegin(station_routes_);
+  auto const to_it = std::cend(station_routes_) - 1;
+
+  auto const* infra_t = infra.operator->();
+  return utls::make_range(
+      iterator{from_it, start_offset_, to_it, end_offset_, infra_t},
+      iterator{to_it, end_offset_, to_it, end_offset_, infra_t});
 }
 
 utls::generator<sub_path> interlocking_route::iterate_station_routes(
@@ -6,9 +6,11 @@
 #include "pugixml.hpp"
 
 #include "utl/enumerate.h"
+#include "utl/erase_duplicates.h"
 #include "utl/erase_if.h"
 #include "utl/get_or_create.h"
 #include "utl/logging.h"
+#include "utl/parallel_for.h"
 #include "utl/timer.h"
 #include "utl/verify.h"
 
@@ -35,6 +37,7 @@
 #include "soro/infrastructure/parsers/parse_station_coords.h"
 #include "soro/infrastructure/path/length.h"
 #include "soro/infrastructure/regulatory_data.h"
+#include "soro/infrastructure/spatial_index.h"
 
 #include "soro/rolling_stock/parse_train_series.h"
 
@@ -517,31 +520,46 @@ section::id parse_section_into_network(xml_node const& xml_rp_section,
   return section_id;
 }
 
-std::set<rail_plan_node_id> get_omitted_relevant_rp_nodes(
-    intermediate_station_route const& isr1) {
-  type_set const INTERLOCKING_DISCERNING_TYPES = {type::MAIN_SIGNAL};
+// all intermediate station routes with an identical path key share the same
+// station_route::path, since the key determines nodes and main signals
+struct path_key {
+  bool operator==(path_key const& o) const = default;
 
-  std::set<rail_plan_node_id> omitted_nodes;
+  cista::hash_t hash() const {
+    auto h = cista::hash_combine(cista::BASE_HASH, start_, end_);
 
-  for (auto const& omitted : isr1.omitted_rp_nodes_) {
-    if (INTERLOCKING_DISCERNING_TYPES.contains(omitted.type_)) {
-      omitted_nodes.insert(omitted.rp_node_id_);
+    for (auto const decision : course_) {
+      h = cista::hash_combine(h, static_cast<bool>(decision));
     }
+
+    for (auto const rp_node_id : omitted_relevant_rp_nodes_) {
+      h = cista::hash_combine(h, rp_node_id);
+    }
+
+    return h;
   }
 
-  return omitted_nodes;
-}
+  rail_plan_node_id start_{INVALID_RP_NODE_ID};
+  rail_plan_node_id end_{INVALID_RP_NODE_ID};
+  soro::vector<course_decision> course_;
+  soro::vector<rail_plan_node_id> omitted_relevant_rp_nodes_;
+};
 
-bool same_path(intermediate_station_route const& isr1,
-               intermediate_station_route const& isr2) {
-  auto const same_start = isr1.start_ == isr2.start_;
-  auto const same_end = isr1.end_ == isr2.end_;
-  auto const same_course = isr1.course_ == isr2.course_;
+path_key get_path_key(intermediate_station_route const& isr) {
+  type_set const INTERLOCKING_DISCERNING_TYPES = {type::MAIN_SIGNAL};
 
-  auto const same_omitted = get_omitted_relevant_rp_nodes(isr1) ==
-                            get_omitted_relevant_rp_nodes(isr2);
+  path_key key{.start_ = isr.start_, .end_ = isr.end_, .course_ = isr.course_};
 
-  return same_start && same_end && same_course && same_omitted;
+  for (auto const& omitted : isr.omitted_rp_nodes_) {
+    if (INTERLOCKING_DISCERNING_TYPES.contains(omitted.type_)) {
+      key.omitted_relevant_rp_nodes_.emplace_back(omitted.rp_node_id_);
+    }
+  }
+
+  utls::sort(key.omitted_relevant_rp_nodes_);
+  utl::erase_duplicates(key.omitted_relevant_rp_nodes_);
+
+  return key;
 }
 
 struct deduplicated_paths {
@@ -643,39 +661,40 @@ deduplicated_paths get_station_route_paths(infrastructure_t const& infra,
 
   auto const& graph = infra.graph_;
 
+  // first: assign every intermediate station route the index of its unique
+  // path, unique paths are numbered in the order of their first occurrence
+  soro::hash_map<path_key, soro::size_t> key_to_path_idx;
+  soro::vector<soro::size_t> isr_to_path_idx;
+  soro::vector<intermediate_station_route const*> path_idx_to_isr;
+
+  isr_to_path_idx.reserve(mats.intermediate_station_routes_.size());
+  for (auto const& i_sr : mats.intermediate_station_routes_) {
+    auto const [it, inserted] = key_to_path_idx.emplace(
+        get_path_key(i_sr), static_cast<soro::size_t>(path_idx_to_isr.size()));
+
+    if (inserted) {
+      path_idx_to_isr.emplace_back(&i_sr);
+    }
+
+    isr_to_path_idx.emplace_back(it->second);
+  }
+
+  // second: create the unique paths in parallel
   deduplicated_paths result;
-  result.station_route_id_to_path_id_.resize(
-      mats.intermediate_station_routes_.size());
+  result.path_store_.resize(path_idx_to_isr.size());
 
-  // this is just a helper data structure to help finding identical paths
-  // it maps the following: element::id -> [{sr_id, path::ptr}]
-  soro::vector<soro::vector<std::pair<element_id, station_route::path::ptr>>>
-      start_elements_to_isr_paths(graph.elements_.size());
+  utl::parallel_for_run(path_idx_to_isr.size(), [&](auto&& path_idx) {
+    auto const& i_sr = *path_idx_to_isr[path_idx];
 
-  for (auto const& i_sr : mats.intermediate_station_routes_) {
     auto start = graph.elements_[mats.rp_id_to_element_id_.at(i_sr.start_)];
     auto end = graph.elements_[mats.rp_id_to_element_id_.at(i_sr.end_)];
 
-    // check if there already exists an identical path
-    auto path_it = utls::find_if(
-        start_elements_to_isr_paths[start->id()], [&](auto&& pair) {
-          return same_path(mats.intermediate_station_routes_[pair.first], i_sr);
-        });
-
-    if (path_it != std::end(start_elements_to_isr_paths[start->id()])) {
-      // we found an identical path, use it
-      result.station_route_id_to_path_id_[i_sr.id_] = path_it->second;
-      continue;
-    }
-
-    // create new path
     auto nodes =
         get_path(i_sr, get_node(start, true), get_node(end, false)->id_);
     auto main_signals = get_main_signals(i_sr, nodes);
     auto [etcs_starts, etcs_ends] = get_etcs(nodes);
 
-    result.path_store_.emplace_back();
-    result.path_store_.back() = soro::make_unique<station_route::path>(
+    result.path_store_[path_idx] = soro::make_unique<station_route::path>(
         station_route::path{.start_ = start,
                             .end_ = end,
                             .course_ = i_sr.course_,
@@ -683,11 +702,20 @@ deduplicated_paths get_station_route_paths(infrastructure_t const& infra,
                             .main_signals_ = std::move(main_signals),
                             .etcs_starts_ = std::move(etcs_starts),
                             .etcs_ends_ = std::move(etcs_ends)});
-    auto const path_ptr = result.path_store_.back().get();
-    result.paths_.emplace_back(path_ptr);
+  });
+
+  result.paths_.reserve(result.path_store_.size());
+  for (auto const& path : result.path_store_) {
+    result.paths_.emplace_back(path.get());
+  }
 
-    result.station_route_id_to_path_id_[i_sr.id_] = path_ptr;
-    start_elements_to_isr_paths[start->id()].emplace_back(i_sr.id_, path_ptr);
+  // third: map every station route to its path
+  result.station_route_id_to_path_id_.resize(
+      mats.intermediate_station_routes_.size());
+  for (auto idx = 0U; idx < isr_to_path_idx.size(); ++idx) {
+    auto const& i_sr = mats.intermediate_station_routes_[idx];
+    result.station_route_id_to_path_id_[i_sr.id_] =
+        result.paths_[isr_to_path_idx[idx]];
   }
 
   return result;
@@ -744,6 +772,9 @@ void calculate_station_routes(infrastructure_t& infra,
     if (auto next = sr->path_->nodes_.back()->next_node_; next != nullptr) {
       auto const next_station =
           infra.element_to_station_.at(next->element_->id());
+      utl::verify(next_station != nullptr,
+                  "element {} after station route {} belongs to no station",
+                  next->element_->id(), i_sr.name_);
       sr->to_station_ = next_station != sr->station_
                             ? station::optional_ptr(next_station)
                             : station::optional_ptr(std::nullopt);
@@ -752,6 +783,9 @@ void calculate_station_routes(infrastructure_t& infra,
     if (auto inc = sr->path_->nodes_.front()->reverse_edges_; !inc.empty()) {
       auto const prev_station =
           infra.element_to_station_.at(inc.front()->element_->id());
+      utl::verify(prev_station != nullptr,
+                  "element {} before station route {} belongs to no station",
+                  inc.front()->element_->id(), i_sr.name_);
       sr->from_station_ = prev_station != sr->station_
                               ? station::optional_ptr(prev_station)
                               : station::optional_ptr(std::nullopt);
@@ -980,7 +1014,8 @@ void complete_borders(infrastructure_t& iss) {
 }
 
 auto get_element_to_station_map(infrastructure_t const& iss) {
-  soro::map<element_id, station::ptr> element_to_station;
+  soro::vector<station::ptr> element_to_station;
+  element_to_station.resize(iss.graph_.elements_.size());
 
   for (auto const& station : iss.stations_) {
     for (auto const& element : station->elements_) {
@@ -991,9 +1026,9 @@ auto get_element_to_station_map(infrastructure_t const& iss) {
   return element_to_station;
 }
 
-soro::map<soro::string, station::ptr> get_ds100_to_station(
+soro::hash_map<soro::string, station::ptr> get_ds100_to_station(
     soro::vector<station::ptr> const& stations) {
-  soro::map<soro::string, station::ptr> result;
+  soro::hash_map<soro::string, station::ptr> result;
 
   for (auto const& station : stations) {
     result[station->ds100_] = station;
@@ -1261,6 +1296,9 @@ infrastructure_t parse_iss(infrastructure_options const& options) {
                       options.exclusion_elements_, options.exclusion_graph_);
   }
 
+  // requires the positions and interlocking routes
+  iss.spatial_ = make_spatial_index(iss);
+
   log_stats(iss);
 
   iss.source_ = options.infrastructure_path_.filename().string();
@@ -17,7 +17,7 @@ using namespace soro::utls;
 
 soro::vector<gps> parse_station_coords(
     std::filesystem::path const& gps_path,
-    soro::map<soro::string, station::ptr> const& ds100_to_station) {
+    soro::hash_map<soro::string, station::ptr> const& ds100_to_station) {
   if (!std::filesystem::exists(gps_path)) {
     uLOG(warn) << "GPS coordinate path '" << gps_path << "' does not exist.";
     return {};
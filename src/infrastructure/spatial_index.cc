@@ -0,0 +1,315 @@
+#include "soro/infrastructure/spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+#include "utl/timer.h"
+
+#include "soro/utls/coordinates/angle.h"
+#include "soro/utls/sassert.h"
+
+#include "soro/infrastructure/infrastructure.h"
+
+namespace soro::infra {
+
+using namespace soro::utls;
+
+std::string_view to_string(spatial_index::kind const k) {
+  switch (k) {
+    case spatial_index::kind::ELEMENT: return "element";
+    case spatial_index::kind::STATION: return "station";
+    case spatial_index::kind::STATION_ROUTE: return "stationRoute";
+    case spatial_index::kind::INTERLOCKING_ROUTE: return "interlockingRoute";
+  }
+
+  return "not reachable";
+}
+
+bool is_empty(bounding_box const& bb) {
+  return bb.south_west_.lon_ > bb.north_east_.lon_;
+}
+
+void extend(bounding_box& bb, bounding_box const& other) {
+  bb.extend(other.south_west_);
+  bb.extend(other.north_east_);
+}
+
+// squared distance in degrees latitude, the longitude difference is scaled to
+// the latitude of the position. exact enough to rank nearby items.
+gps::precision squared_distance(gps const& p, bounding_box const& bb) {
+  auto const dlon =
+      std::max({bb.south_west_.lon_ - p.lon_, gps::precision{0.0},
+                p.lon_ - bb.north_east_.lon_}) *
+      std::cos(to_rad(p.lat_));
+  auto const dlat = std::max({bb.south_west_.lat_ - p.lat_, gps::precision{0.0},
+                              p.lat_ - bb.north_east_.lat_});
+  return dlon * dlon + dlat * dlat;
+}
+
+// distance of (x, y) along a Hilbert curve filling [0, 2^16)^2
+uint32_t hilbert(uint32_t x, uint32_t y) {
+  constexpr uint32_t n = 1U << 16U;
+
+  uint32_t d = 0;
+  for (uint32_t s = n / 2; s > 0; s /= 2) {
+    uint32_t const rx = (x & s) > 0 ? 1U : 0U;
+    uint32_t const ry = (y & s) > 0 ? 1U : 0U;
+    d += s * s * ((3U * rx) ^ ry);
+
+    if (ry == 0) {
+      if (rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+
+  return d;
+}
+
+struct item_box {
+  spatial_index::item item_;
+  bounding_box box_;
+};
+
+// items without a valid position are not part of the index
+std::vector<item_box> get_item_boxes(infrastructure_t const& infra) {
+  using kind = spatial_index::kind;
+
+  std::vector<item_box> result;
+
+  auto const& positions = infra.element_positions_;
+  if (positions.empty()) {
+    return result;
+  }
+
+  auto const add = [&](kind const k, soro::size_t const id,
+                       bounding_box const& bb) {
+    if (!is_empty(bb)) {
+      result.push_back({.item_ = {.kind_ = k, .id_ = id}, .box_ = bb});
+    }
+  };
+
+  auto const extend_by = [&](bounding_box& bb, element::ptr const e) {
+    auto const& position = positions[e->id()];
+    if (position.valid()) {
+      bb.extend(position);
+    }
+  };
+
+  for (auto const e : infra.graph_.elements_) {
+    bounding_box bb;
+    extend_by(bb, e);
+    add(kind::ELEMENT, e->id(), bb);
+  }
+
+  for (auto const s : infra.stations_) {
+    bounding_box bb;
+    for (auto const e : s->elements_) {
+      extend_by(bb, e);
+    }
+    add(kind::STATION, s->id_, bb);
+  }
+
+  for (auto const sr : infra.station_routes_) {
+    bounding_box bb;
+    for (auto const n : sr->nodes()) {
+      extend_by(bb, n->element_);
+    }
+    add(kind::STATION_ROUTE, sr->id_, bb);
+  }
+
+  infrastructure const wrapped(&infra);
+  for (auto const& ir : infra.interlocking_.routes_) {
+    bounding_box bb;
+    for (auto const& rn : ir.iterate(wrapped)) {
+      extend_by(bb, rn.node_->element_);
+    }
+    add(kind::INTERLOCKING_ROUTE, ir.id_, bb);
+  }
+
+  return result;
+}
+
+spatial_index make_spatial_index(infrastructure_t const& infra) {
+  utl::scoped_timer const timer("creating spatial index");
+
+  auto const item_boxes = get_item_boxes(infra);
+
+  spatial_index result;
+  if (item_boxes.empty()) {
+    return result;
+  }
+
+  bounding_box extent;
+  for (auto const& ib : item_boxes) {
+    extend(extent, ib.box_);
+  }
+
+  // the center of a box mapped onto the Hilbert curve grid
+  auto const to_grid = [](gps::precision const v, gps::precision const min,
+                          gps::precision const max) {
+    auto const range = max - min;
+    return range <= 0.0 ? 0U
+                        : static_cast<uint32_t>((v - min) / range * 0xFFFF);
+  };
+
+  std::vector<uint32_t> hilbert_values;
+  hilbert_values.reserve(item_boxes.size());
+  for (auto const& ib : item_boxes) {
+    auto const& bb = ib.box_;
+    auto const lon = (bb.south_west_.lon_ + bb.north_east_.lon_) / 2;
+    auto const lat = (bb.south_west_.lat_ + bb.north_east_.lat_) / 2;
+    hilbert_values.push_back(hilbert(
+        to_grid(lon, extent.south_west_.lon_, extent.north_east_.lon_),
+        to_grid(lat, extent.south_west_.lat_, extent.north_east_.lat_)));
+  }
+
+  std::vector<std::size_t> order(item_boxes.size());
+  std::iota(std::begin(order), std::end(order), 0);
+  std::stable_sort(std::begin(order), std::end(order),
+                   [&](auto&& i1, auto&& i2) {
+                     return hilbert_values[i1] < hilbert_values[i2];
+                   });
+
+  result.items_.reserve(order.size());
+  result.boxes_.reserve(order.size() + order.size() / 8 + 1);
+  for (auto const idx : order) {
+    result.items_.push_back(item_boxes[idx].item_);
+    result.boxes_.push_back(item_boxes[idx].box_);
+  }
+
+  // pack NODE_SIZE consecutive boxes into one node until one root is left
+  soro::size_t level_start = 0;
+  result.level_ends_.push_back(static_cast<soro::size_t>(order.size()));
+  while (result.level_ends_.back() - level_start > 1) {
+    auto const level_end = result.level_ends_.back();
+
+    for (auto i = level_start; i < level_end; i += spatial_index::NODE_SIZE) {
+      bounding_box node;
+      for (auto j = i; j < std::min(i + spatial_index::NODE_SIZE, level_end);
+           ++j) {
+        extend(node, result.boxes_[j]);
+      }
+      result.boxes_.push_back(node);
+    }
+
+    level_start = level_end;
+    result.level_ends_.push_back(
+        static_cast<soro::size_t>(result.boxes_.size()));
+  }
+
+  return result;
+}
+
+struct node_ref {
+  soro::size_t idx_;
+  soro::size_t level_;
+};
+
+// the box indices of the children of a node
+std::pair<soro::size_t, soro::size_t> children(
+    soro::vector<soro::size_t> const& level_ends, node_ref const& n) {
+  utls::sassert(n.level_ != 0, "leaves have no children");
+
+  auto const level_start = n.level_ == 1 ? 0 : level_ends[n.level_ - 2];
+  auto const node_start = level_ends[n.level_ - 1];
+
+  auto const first =
+      level_start + (n.idx_ - node_start) * spatial_index::NODE_SIZE;
+  auto const last =
+      std::min(first + spatial_index::NODE_SIZE, level_ends[n.level_ - 1]);
+
+  return {first, last};
+}
+
+std::vector<spatial_index::leaf> spatial_index::within(
+    bounding_box const& viewport, filter const& accept,
+    soro::size_t const limit) const {
+  std::vector<leaf> result;
+
+  if (empty() || limit == 0) {
+    return result;
+  }
+
+  std::vector<node_ref> stack;
+  stack.push_back(
+      {.idx_ = static_cast<soro::size_t>(boxes_.size() - 1),
+       .level_ = static_cast<soro::size_t>(level_ends_.size() - 1)});
+
+  while (!stack.empty() && result.size() < limit) {
+    auto const n = stack.back();
+    stack.pop_back();
+
+    if (!boxes_[n.idx_].overlaps(viewport)) {
+      continue;
+    }
+
+    if (n.level_ == 0) {
+      if (!accept || accept(items_[n.idx_])) {
+        result.push_back(n.idx_);
+      }
+      continue;
+    }
+
+    auto const [first, last] = children(level_ends_, n);
+    for (auto c = first; c < last; ++c) {
+      stack.push_back({.idx_ = c, .level_ = n.level_ - 1});
+    }
+  }
+
+  std::sort(std::begin(result), std::end(result));
+
+  return result;
+}
+
+std::vector<spatial_index::leaf> spatial_index::nearest(
+    gps const& position, soro::size_t const k, filter const& accept) const {
+  std::vector<leaf> result;
+
+  if (empty() || k == 0) {
+    return result;
+  }
+
+  // best first search, the distance to a node is a lower bound for the
+  // distances to all of its leaves, leaves are popped in order of distance
+  using entry = std::tuple<gps::precision, soro::size_t, soro::size_t>;
+  std::priority_queue<entry, std::vector<entry>, std::greater<>> queue;
+
+  auto const root = static_cast<soro::size_t>(boxes_.size() - 1);
+  queue.emplace(squared_distance(position, boxes_[root]), root,
+                static_cast<soro::size_t>(level_ends_.size() - 1));
+
+  while (!queue.empty() && result.size() < k) {
+    auto const idx = std::get<1>(queue.top());
+    auto const level = std::get<2>(queue.top());
+    queue.pop();
+
+    if (level == 0) {
+      if (!accept || accept(items_[idx])) {
+        result.push_back(idx);
+      }
+      continue;
+    }
+
+    auto const [first, last] =
+        children(level_ends_, node_ref{.idx_ = idx, .level_ = level});
+    for (auto c = first; c < last; ++c) {
+      queue.emplace(squared_distance(position, boxes_[c]), c, level - 1);
+    }
+  }
+
+  return result;
+}
+
+bool spatial_index::empty() const noexcept { return items_.empty(); }
+
+soro::size_t spatial_index::size() const noexcept {
+  return static_cast<soro::size_t>(items_.size());
+}
+
+}  // namespace soro::infra
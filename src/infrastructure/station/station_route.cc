@@ -1,9 +1,10 @@
 #include "soro/infrastructure/station/station_route.h"
 
+#include <tuple>
+
 #include "soro/infrastructure/station/station.h"
 #include "soro/infrastructure/station/station_route_graph.h"
 
-#include "soro/utls/coroutine/coro_map.h"
 #include "soro/utls/sassert.h"
 #include "soro/utls/std_wrapper/find_if_position.h"
 
@@ -141,53 +142,71 @@ std::pair<node::idx, node::idx> fast_forward_indices(station_route const& r,
   return indices;
 }
 
-utls::recursive_generator<route_node> station_route::iterate() const {
-  co_yield from_to(0, size());
-}
-
-utls::recursive_generator<route_node> station_route::from_to(
-    node::idx const from, node::idx const to) const {
+station_route::iterator::iterator(station_route const* sr,
+                                  node::idx const from, node::idx const to)
+    : sr_{sr}, node_idx_{from >= sr->size() ? to : from}, to_{to} {
   utls::sassert(from <= to, "To: {} is smaller than from: {}.", to, from);
 
-  if (from >= size()) {
-    co_return;
+  if (node_idx_ < to_) {
+    std::tie(omit_idx_, spl_idx_) = fast_forward_indices(*sr_, node_idx_);
+    set_current();
   }
+}
 
-  route_node result;
-  node::idx node_idx = from;
+void station_route::iterator::set_current() {
+  current_.node_ = sr_->nodes(node_idx_);
+  current_.extra_spl_ = speed_limit::optional_ptr{std::nullopt};
 
-  auto [omit_idx, spl_idx] = fast_forward_indices(*this, from);
+  current_.omitted_ = omit_idx_ < sr_->omitted_nodes_.size() &&
+                      sr_->omitted_nodes_[omit_idx_] == node_idx_;
 
-  for (; node_idx < to; ++node_idx) {
-    result.node_ = nodes(node_idx);
+  if (current_.omitted_) {
+    ++omit_idx_;
+  } else {
+    bool const extra_spl =
+        spl_idx_ < sr_->extra_speed_limits_.size() &&
+        sr_->extra_speed_limits_[spl_idx_].node_->id_ == current_.node_->id_;
 
-    result.omitted_ = omit_idx < omitted_nodes_.size() &&
-                      omitted_nodes_[omit_idx] == node_idx;
+    if (extra_spl) {
+      current_.extra_spl_ =
+          speed_limit::optional_ptr(&sr_->extra_speed_limits_[spl_idx_++]);
+    }
+  }
+}
 
-    if (result.omitted_) {
-      ++omit_idx;
-    } else {
-      bool const extra_spl =
-          spl_idx < extra_speed_limits_.size() &&
-          extra_speed_limits_[spl_idx].node_->id_ == result.node_->id_;
+station_route::iterator& station_route::iterator::operator++() {
+  utls::sassert(node_idx_ < to_, "incrementing end station route iterator");
 
-      if (extra_spl) {
-        result.extra_spl_ =
-            speed_limit::optional_ptr(&extra_speed_limits_[spl_idx++]);
-      }
-    }
+  ++node_idx_;
 
-    co_yield result;
+  if (node_idx_ < to_) {
+    set_current();
   }
+
+  return *this;
+}
+
+station_route::iterator station_route::iterator::operator++(int) {
+  auto copy = *this;
+  ++(*this);
+  return copy;
+}
+
+station_route::range station_route::iterate() const {
+  return from_to(0, size());
+}
+
+station_route::range station_route::from_to(node::idx const from,
+                                            node::idx const to) const {
+  return utls::make_range(iterator{this, from, to}, iterator{this, to, to});
 }
 
-utls::recursive_generator<route_node> station_route::from(
-    node::idx from) const {
-  co_yield from_to(from, size());
+station_route::range station_route::from(node::idx const from) const {
+  return from_to(from, size());
 }
 
-utls::recursive_generator<route_node> station_route::to(node::idx to) const {
-  co_yield from_to(0, to);
+station_route::range station_route::to(node::idx const to) const {
+  return from_to(0, to);
 }
 
-}  // namespace soro::infra
\ No newline at end of file
+}  // namespace soro::infra
@@ -0,0 +1,164 @@
+#include "soro/rolling_stock/force_model.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "utl/verify.h"
+
+#include "soro/utls/sassert.h"
+#include "soro/utls/std_wrapper/find_if.h"
+#include "soro/utls/std_wrapper/sort.h"
+
+#include "soro/si/constants.h"
+
+namespace soro::rs {
+
+using coefficients = force_model::coefficients;
+
+template <typename Polynomial>
+coefficients get_coefficients(Polynomial const& p) {
+  return {.a_ = get<0>(p.factors_).val_,
+          .b_ = get<1>(p.factors_).val_,
+          .c_ = get<2>(p.factors_).val_};
+}
+
+coefficients operator+(coefficients const& c1, coefficients const& c2) {
+  return {.a_ = c1.a_ + c2.a_, .b_ = c1.b_ + c2.b_, .c_ = c1.c_ + c2.c_};
+}
+
+coefficients operator-(coefficients const& c1, coefficients const& c2) {
+  return {.a_ = c1.a_ - c2.a_, .b_ = c1.b_ - c2.b_, .c_ = c1.c_ - c2.c_};
+}
+
+coefficients operator/(coefficients const& c, si::precision const d) {
+  return {.a_ = c.a_ / d, .b_ = c.b_ / d, .c_ = c.c_ / d};
+}
+
+si::precision evaluate(coefficients const& c, si::precision const x) {
+  return (c.a_ * x + c.b_) * x + c.c_;
+}
+
+soro::size_t force_model::segment(si::precision const v) const {
+  auto const it = std::upper_bound(std::begin(bounds_), std::end(bounds_), v);
+
+  utl::verify(it != std::end(bounds_),
+              "speed {} m/s outside of the force model defined up to {} m/s",
+              v, bounds_.empty() ? 0.0 : bounds_.back());
+
+  return static_cast<soro::size_t>(std::distance(std::begin(bounds_), it));
+}
+
+soro::size_t force_model::segment(si::precision const v,
+                                  soro::size_t hint) const {
+  while (hint > 0 && v < bounds_[hint - 1]) {
+    --hint;
+  }
+
+  while (hint < bounds_.size() && v >= bounds_[hint]) {
+    ++hint;
+  }
+
+  utl::verify(hint < bounds_.size() && v < bounds_[hint],
+              "speed {} m/s outside of the force model defined up to {} m/s",
+              v, bounds_.empty() ? 0.0 : bounds_.back());
+
+  return hint;
+}
+
+si::force force_model::tractive_force(si::speed const v) const {
+  return si::force{evaluate(tractive_[segment(v.val_)], v.val_)};
+}
+
+si::force force_model::resistive_force(si::speed const v) const {
+  return si::force{evaluate(resistive_, v.val_)};
+}
+
+si::acceleration force_model::acceleration(si::speed const v) const {
+  return si::acceleration{evaluate(acceleration_[segment(v.val_)], v.val_)};
+}
+
+void force_model::acceleration(std::span<si::speed const> const vs,
+                               std::span<si::acceleration> const out) const {
+  utl::verify(vs.size() == out.size(), "output size {} differs from input {}",
+              out.size(), vs.size());
+
+  soro::size_t current = 0;
+  for (std::size_t i = 0; i < vs.size();) {
+    current = segment(vs[i].val_, current);
+
+    // all following speeds in the segment share its coefficients
+    auto const& c = acceleration_[current];
+    auto const from = current == 0
+                          ? std::numeric_limits<si::precision>::lowest()
+                          : bounds_[current - 1];
+    auto const to = bounds_[current];
+
+    do {
+      out[i] = si::acceleration{evaluate(c, vs[i].val_)};
+      ++i;
+    } while (i < vs.size() && vs[i].val_ >= from && vs[i].val_ < to);
+  }
+}
+
+force_model make_force_model(soro::vector<traction_vehicle> const& vehicles,
+                             si::weight const weight,
+                             si::speed const max_speed) {
+  utls::expect(!vehicles.empty(), "force model requires a traction vehicle");
+
+  force_model result;
+  result.max_speed_ = max_speed;
+
+  // the model is only defined where every tractive curve is defined
+  auto domain_end = std::numeric_limits<si::precision>::max();
+
+  for (auto const& vehicle : vehicles) {
+    utls::expect(!vehicle.tractive_curve_.pieces_.empty(),
+                 "traction vehicle without tractive curve");
+
+    result.resistive_ =
+        result.resistive_ + get_coefficients(vehicle.resistance_curve_);
+    result.max_speed_ = std::min(result.max_speed_, vehicle.max_speed_);
+    domain_end =
+        std::min(domain_end, vehicle.tractive_curve_.pieces_.back().to_.val_);
+  }
+
+  for (auto const& vehicle : vehicles) {
+    for (auto const& piece : vehicle.tractive_curve_.pieces_) {
+      if (piece.to_.val_ <= domain_end) {
+        result.bounds_.emplace_back(piece.to_.val_);
+      }
+    }
+  }
+
+  utls::sort(result.bounds_);
+  result.bounds_.erase(
+      std::unique(std::begin(result.bounds_), std::end(result.bounds_)),
+      std::end(result.bounds_));
+
+  auto const mass = weight.val_ * si::MASS_FACTOR.val_;
+
+  result.tractive_.reserve(result.bounds_.size());
+  result.acceleration_.reserve(result.bounds_.size());
+
+  for (auto const bound : result.bounds_) {
+    coefficients tractive;
+
+    // a piecewise function uses the first piece with v < to_, for all speeds
+    // in the current segment this is the first piece ending at or after it
+    for (auto const& vehicle : vehicles) {
+      auto const piece =
+          utls::find_if(vehicle.tractive_curve_.pieces_,
+                        [&](auto&& p) { return p.to_.val_ >= bound; });
+      utls::sassert(piece != std::end(vehicle.tractive_curve_.pieces_));
+
+      tractive = tractive + get_coefficients(piece->piece_);
+    }
+
+    result.tractive_.emplace_back(tractive);
+    result.acceleration_.emplace_back((tractive - result.resistive_) / mass);
+  }
+
+  return result;
+}
+
+}  // namespace soro::rs
@@ -1,12 +1,7 @@
 #include "soro/rolling_stock/train_physics.h"
 
-#include "soro/utls/std_wrapper/accumulate.h"
-#include "soro/utls/std_wrapper/min_element.h"
-
 namespace soro::rs {
 
-using namespace soro::utls;
-
 #if !defined(SERIALIZE)
 train_physics::train_physics(soro::vector<traction_vehicle> tvs,
                              si::weight const carriage_weight,
@@ -17,33 +12,49 @@ train_physics::train_physics(soro::vector<traction_vehicle> tvs,
       length_{length},
       max_speed_{max_speed},
       ctc_(ctc),
-      freight_(freight) {}
+      freight_(freight),
+      model_{make_force_model(vehicles_, carriage_weight_, max_speed_)} {}
 #endif
 
+train_physics train_physics::make(soro::vector<traction_vehicle> tvs,
+                                  si::weight const carriage_weight,
+                                  si::length const length,
+                                  si::speed const max_speed, CTC const ctc,
+                                  FreightTrain const freight) {
+  train_physics result;
+
+  result.vehicles_ = std::move(tvs);
+  result.carriage_weight_ = carriage_weight;
+  result.length_ = length;
+  result.max_speed_ = max_speed;
+  result.ctc_ = ctc;
+  result.freight_ = freight;
+  result.model_ = make_force_model(result.vehicles_, result.carriage_weight_,
+                                   result.max_speed_);
+
+  return result;
+}
+
 si::length train_physics::length() const { return length_; }
 
 si::weight train_physics::weight() const { return carriage_weight_; }
 
-si::speed train_physics::max_speed() const {
-  auto const vehicle_max_speed =
-      utls::min_element(vehicles_, [](auto&& v1, auto&& v2) {
-        return v1.max_speed_ < v2.max_speed_;
-      })->max_speed_;
-  return std::min(vehicle_max_speed, max_speed_);
-}
+si::speed train_physics::max_speed() const { return model_.max_speed_; }
 
 si::force train_physics::tractive_force(si::speed const v) const {
-  return accumulate(vehicles_, si::ZERO<si::force>, [&](auto&& acc, auto&& vh) {
-    return acc + vh.tractive_curve_(v);
-  });
+  return model_.tractive_force(v);
 }
 
 si::force train_physics::resistive_force(si::speed const v) const {
-  return accumulate(vehicles_, si::ZERO<si::force>, [&](auto&& acc, auto&& vh) {
-    return acc + vh.resistance_curve_(v);
-  });
+  return model_.resistive_force(v);
 }
 
+si::acceleration train_physics::acceleration(si::speed const v) const {
+  return model_.acceleration(v);
+}
+
+force_model const& train_physics::model() const { return model_; }
+
 si::acceleration train_physics::deacceleration() const {
   return vehicles_.front().deacceleration_;
 }
@@ -0,0 +1,192 @@
+#include "soro/runtime/batch_runtime.h"
+
+#include <array>
+#include <utility>
+
+#include "utl/verify.h"
+
+#include "soro/utls/sassert.h"
+
+#include "soro/runtime/interval.h"
+#include "soro/runtime/runtime_phases.h"
+
+namespace soro::runtime {
+
+using namespace soro::si;
+using namespace soro::tt;
+using namespace soro::infra;
+
+namespace {
+
+using lane_values = std::array<precision, BATCH_LANES>;
+using lane_mask = std::array<bool, BATCH_LANES>;
+
+struct lane {
+  runtime_state state_;
+
+  // acceleration steps of the current interval, empty without acceleration
+  runtime_results accel_;
+};
+
+// advances the acceleration phase of the interval at idx for all lanes in
+// lockstep, lanes already done or not accelerating are masked out.
+// the polynomial segment of a lane is searched once and then followed, the
+// integration step works on plain arrays and is left to the compiler to
+// vectorize. the steps of a lane equal the ones of accelerate().
+void accelerate_lanes(std::span<lane> lanes, soro::size_t const idx) {
+  lane_values speed{};
+  lane_values distance{};
+  lane_values max_speed{};
+  lane_values max_distance{};
+  lane_values a{};
+  lane_values b{};
+  lane_values c{};
+  lane_mask active{};
+
+  std::array<rs::force_model const*, BATCH_LANES> models{};
+  std::array<soro::size_t, BATCH_LANES> segments{};
+
+  auto const set_coefficients = [&](auto const l) {
+    auto const& coefficients = models[l]->acceleration_[segments[l]];
+    a[l] = coefficients.a_;
+    b[l] = coefficients.b_;
+    c[l] = coefficients.c_;
+  };
+
+  bool any_active = false;
+
+  for (auto l = 0U; l < lanes.size(); ++l) {
+    auto& ln = lanes[l];
+    auto const& tp = *ln.state_.physics_;
+    auto const& prev = (*ln.state_.intervals_)[idx - 1];
+    auto const& interval = (*ln.state_.intervals_)[idx];
+
+    ln.accel_.clear();
+
+    speed[l] = ln.state_.current_.speed_.val_;
+    max_speed[l] = interval.max_speed(tp).val_;
+    max_distance[l] = (interval.distance_ - prev.distance_).val_;
+    active[l] = speed[l] < max_speed[l];
+
+    if (active[l]) {
+      ln.accel_.emplace_back(ZERO<time>, ZERO<length>, from_m_s(speed[l]));
+      any_active = true;
+
+      models[l] = &tp.model();
+      segments[l] = models[l]->segment(speed[l]);
+      set_coefficients(l);
+    }
+  }
+
+  auto const dt = as_s(DELTA_T);
+
+  while (any_active) {
+    for (auto l = 0U; l < BATCH_LANES; ++l) {
+      auto const acceleration = (a[l] * speed[l] + b[l]) * speed[l] + c[l];
+      auto const next_speed = speed[l] + acceleration * dt;
+      auto const next_distance =
+          distance[l] + (speed[l] + next_speed) * 0.5 * dt;
+
+      speed[l] = active[l] ? next_speed : speed[l];
+      distance[l] = active[l] ? next_distance : distance[l];
+    }
+
+    any_active = false;
+    for (auto l = 0U; l < lanes.size(); ++l) {
+      if (!active[l]) {
+        continue;
+      }
+
+      auto& accel = lanes[l].accel_;
+      accel.emplace_back(static_cast<precision>(accel.size()) * DELTA_T,
+                         from_m(distance[l]), from_m_s(speed[l]));
+
+      active[l] = speed[l] < max_speed[l] && distance[l] < max_distance[l];
+      any_active = any_active || active[l];
+
+      if (!active[l]) {
+        a[l] = b[l] = c[l] = 0.0;
+        continue;
+      }
+
+      // the speed changes little per step, the segment is at most a few away
+      auto const segment = models[l]->segment(speed[l], segments[l]);
+      if (segment != segments[l]) {
+        segments[l] = segment;
+        set_coefficients(l);
+      }
+    }
+  }
+
+  for (auto l = 0U; l < lanes.size(); ++l) {
+    limit_distance(lanes[l].accel_, from_m(max_distance[l]));
+  }
+}
+
+void run_batch(std::span<train const> const variants,
+               base_timetable const& bt,
+               std::span<interval_list const> const lists,
+               std::span<timestamps> const results) {
+  utls::sassert(variants.size() <= BATCH_LANES, "too many variants in batch");
+
+  std::vector<lane> lanes;
+  lanes.reserve(variants.size());
+  for (auto l = 0U; l < variants.size(); ++l) {
+    lanes.emplace_back(lane{
+        .state_ = runtime_state{variants[l], variants[l].physics(bt), lists[l]},
+        .accel_ = {}});
+  }
+
+  auto const interval_count = lists.front().size();
+  for (soro::size_t idx = 1; idx < interval_count; ++idx) {
+    accelerate_lanes(lanes, idx);
+
+    for (auto& ln : lanes) {
+      ln.state_.advance(idx, ln.accel_);
+    }
+  }
+
+  for (auto l = 0U; l < lanes.size(); ++l) {
+    results[l] = std::move(lanes[l].state_.ts_);
+  }
+}
+
+}  // namespace
+
+std::vector<timestamps> batch_runtime_calculation(
+    std::span<train const> const variants, base_timetable const& bt,
+    infrastructure const& infra, type_set const& record_types) {
+  std::vector<timestamps> result(variants.size());
+
+  if (variants.empty()) {
+    return result;
+  }
+
+  interval_cache cache;
+
+  std::vector<interval_list> lists;
+  lists.reserve(variants.size());
+  for (auto const& variant : variants) {
+    lists.emplace_back(
+        cache.get(variant, variant.physics(bt), record_types, infra));
+  }
+
+  // the cache hands out the same geometry for variants sharing it
+  for (auto const& list : lists) {
+    utl::verify(list.geometry_ == lists.front().geometry_,
+                "batch variants must share the same interval geometry");
+  }
+
+  for (std::size_t offset = 0; offset < variants.size();
+       offset += BATCH_LANES) {
+    auto const count = std::min(BATCH_LANES, variants.size() - offset);
+
+    run_batch(variants.subspan(offset, count), bt,
+              std::span<interval_list const>{lists}.subspan(offset, count),
+              std::span<timestamps>{result}.subspan(offset, count));
+  }
+
+  return result;
+}
+
+}  // namespace soro::runtime
@@ -1,5 +1,7 @@
 #include "soro/runtime/interval.h"
 
+#include "utl/logging.h"
+
 #include "soro/utls/sassert.h"
 
 #include "soro/runtime/runtime_physics.h"
@@ -53,15 +55,14 @@ bool adjust_speed_limits(interval_list& list, rs::train_physics const& tp) {
     auto& prev_interval = list[idx - 1];
     auto& interval = list[idx];
 
-    auto const initial_speed = std::min(interval.limit_left_, tp.max_speed());
+    auto const initial_speed = interval.max_speed(tp);
     if (interval.limit_right_ >= initial_speed && !interval.is_halt()) {
       continue;
     }
 
     auto const target_speed = interval.target_speed(tp);
-    auto const& deaccel_results = brake(tp, initial_speed, target_speed);
-
-    auto const braking_path_length = deaccel_results.back().distance_;
+    auto const braking_path_length =
+        brake_profile{tp, initial_speed, target_speed}.distance_;
     auto const interval_length = interval.distance_ - prev_interval.distance_;
 
     if (interval_length >= braking_path_length) {
@@ -72,7 +73,7 @@ bool adjust_speed_limits(interval_list& list, rs::train_physics const& tp) {
 
     si::speed new_speed = initial_speed - from_m_s(1.0);
     while (new_speed > target_speed &&
-           brake(tp, new_speed, target_speed).back().distance_ >=
+           brake_profile{tp, new_speed, target_speed}.distance_ >=
                interval_length) {
       new_speed -= from_m_s(1.0);
     }
@@ -148,21 +149,24 @@ speed_limit_duo get_speed_limit(train_node const& tn, train const& train,
   return result;
 }
 
-auto insert_last_signal_spl(si::speed const new_limit, interval_list& list,
+using border = interval_geometry::border;
+
+auto insert_last_signal_spl(si::speed const new_limit,
+                            std::vector<border>& borders,
                             soro::size_t last_ms_idx) {
 
-  if (last_ms_idx >= list.size()) {
-    return list.size();
+  if (last_ms_idx >= borders.size()) {
+    return borders.size();
   }
 
-  auto const replaced_limit = list.at(last_ms_idx).limit_right_;
+  auto const replaced_limit = borders.at(last_ms_idx).limit_right_;
 
-  while (last_ms_idx < list.size() &&
-         list.at(last_ms_idx).limit_right_ == replaced_limit) {
-    list.at(last_ms_idx).limit_right_ = new_limit;
+  while (last_ms_idx < borders.size() &&
+         borders.at(last_ms_idx).limit_right_ == replaced_limit) {
+    borders.at(last_ms_idx).limit_right_ = new_limit;
 
-    if (last_ms_idx < list.size() - 1) {
-      list.at(last_ms_idx + 1).limit_left_ = new_limit;
+    if (last_ms_idx < borders.size() - 1) {
+      borders.at(last_ms_idx + 1).limit_left_ = new_limit;
     }
     ++last_ms_idx;
   }
@@ -170,11 +174,26 @@ auto insert_last_signal_spl(si::speed const new_limit, interval_list& list,
   return last_ms_idx;
 }
 
-interval_list get_interval_list(train const& train, type_set const& event_types,
-                                infrastructure const& infra) {
+soro::size_t get_sequence_point_idx(train const& train, train_node const& tn) {
+  auto const use_sp =
+      tn.sequence_point_.has_value() && (*tn.sequence_point_)->is_halt();
+
+  if (!use_sp) {
+    return interval_geometry::NO_SEQUENCE_POINT;
+  }
+
+  return static_cast<soro::size_t>(&(**tn.sequence_point_) -
+                                   train.sequence_points_.data());
+}
+
+interval_geometry get_interval_geometry(train const& train,
+                                        type_set const& event_types,
+                                        infrastructure const& infra) {
   utls::sassert(!train.break_out_ && !train.break_in_, "Not supported yet");
 
-  interval_list list;
+  interval_geometry geometry;
+  auto& borders = geometry.borders_;
+  auto& events = geometry.events_;
 
   length current_distance = ZERO<length>;
 
@@ -185,7 +204,8 @@ interval_list get_interval_list(train const& train, type_set const& event_types,
   si::speed prev_limit = si::INVALID<si::speed>;
   si::speed current_limit = get_initial_spl(train, infra);
 
-  std::vector<event> current_events;
+  // the events of the interval currently being built start here
+  soro::size_t events_begin = 0;
 
   for (auto const& tn : train.iterate(infra)) {
     current_distance += tn.node_->element_->get_distance(prev_element);
@@ -199,8 +219,9 @@ interval_list get_interval_list(train const& train, type_set const& event_types,
 
     if (spl_duo.last_signal_.has_value()) {
       auto const ms_limit = (*spl_duo.last_signal_)->limit_;
-      auto const updated_to = insert_last_signal_spl(ms_limit, list, last_ms);
-      if (updated_to == list.size()) {
+      auto const updated_to =
+          insert_last_signal_spl(ms_limit, borders, last_ms);
+      if (updated_to == borders.size()) {
         prev_limit = ms_limit;
         current_limit = ms_limit;
       }
@@ -212,37 +233,160 @@ interval_list get_interval_list(train const& train, type_set const& event_types,
     }
 
     if (tn.node_->is(type::MAIN_SIGNAL)) {
-      last_ms = list.size();
+      last_ms = borders.size();
     }
 
     if (event_types.contains(tn.node_->type())) {
-      current_events.emplace_back(tn.node_, current_distance);
+      events.emplace_back(tn.node_, current_distance);
     }
 
     if (BORDER_TYPES.contains(tn.node_->type()) || spl_duo.here_.has_value()) {
-      auto const use_sp =
-          tn.sequence_point_.has_value() && (*tn.sequence_point_)->is_halt();
-
-      auto const sp = use_sp ? sequence_point::optional_ptr{tn.sequence_point_}
-                             : sequence_point::optional_ptr{std::nullopt};
-      interval const new_interval(current_distance, prev_limit, current_limit,
-                                  sp, current_events);
-
-      if (!list.empty() && list.back().distance_ == current_distance) {
-        list.back().append(new_interval);
+      auto const sp_idx = get_sequence_point_idx(train, tn);
+      auto const events_end = static_cast<soro::size_t>(events.size());
+
+      if (!borders.empty() && borders.back().distance_ == current_distance) {
+        // events are stored in order, so merging two borders at the same
+        // distance only has to extend the event range of the former one
+        auto& last = borders.back();
+
+        utls::sassert(!(last.is_halt() &&
+                        sp_idx != interval_geometry::NO_SEQUENCE_POINT),
+                      "Merging two intervals where both have a sequence point");
+
+        last.limit_right_ = current_limit;
+        last.events_end_ = events_end;
+        if (sp_idx != interval_geometry::NO_SEQUENCE_POINT) {
+          last.sequence_point_idx_ = sp_idx;
+        }
       } else {
-        list.push_back(new_interval);
+        borders.push_back(border{.distance_ = current_distance,
+                                 .limit_left_ = prev_limit,
+                                 .limit_right_ = current_limit,
+                                 .sequence_point_idx_ = sp_idx,
+                                 .events_begin_ = events_begin,
+                                 .events_end_ = events_end});
       }
 
       prev_limit = current_limit;
-      current_events = {};
+      events_begin = events_end;
     }
   }
 
-  while (adjust_speed_limits(list, train.physics_))
+  return geometry;
+}
+
+interval_list bind_interval_list(
+    std::shared_ptr<interval_geometry const> geometry, train const& train,
+    rs::train_physics const& physics) {
+  interval_list list;
+  list.intervals_.reserve(geometry->borders_.size());
+
+  std::span<event const> const events{geometry->events_};
+
+  for (auto const& b : geometry->borders_) {
+    utls::sassert(!b.is_halt() ||
+                      b.sequence_point_idx_ < train.sequence_points_.size(),
+                  "sequence point index {} out of bounds for train {}",
+                  b.sequence_point_idx_, train.id_);
+
+    auto const sp =
+        b.is_halt()
+            ? sequence_point::optional_ptr(
+                  &train.sequence_points_[b.sequence_point_idx_])
+            : sequence_point::optional_ptr(std::nullopt);
+
+    list.intervals_.emplace_back(
+        b.distance_, b.limit_left_, b.limit_right_, sp,
+        events.subspan(b.events_begin_, b.events_end_ - b.events_begin_));
+  }
+
+  list.geometry_ = std::move(geometry);
+
+  while (adjust_speed_limits(list, physics))
     ;
 
   return list;
 }
 
+interval_list get_interval_list(train const& train,
+                                rs::train_physics const& physics,
+                                type_set const& event_types,
+                                infrastructure const& infra) {
+  auto geometry = std::make_shared<interval_geometry const>(
+      get_interval_geometry(train, event_types, infra));
+  return bind_interval_list(std::move(geometry), train, physics);
+}
+
+interval_cache::key get_cache_key(train const& train,
+                                  type_set const& event_types) {
+  using point_kind = interval_cache::point_kind;
+
+  interval_cache::key key;
+  key.freight_ = train.freight();
+  key.path_.assign(std::begin(train.path_), std::end(train.path_));
+  key.event_types_.assign(std::begin(event_types), std::end(event_types));
+
+  key.points_.reserve(train.sequence_points_.size());
+  for (auto const& sp : train.sequence_points_) {
+    auto const kind = sp.has_transit_time() ? point_kind::CHECKPOINT
+                      : sp.is_halt()        ? point_kind::HALT
+                                            : point_kind::PASS;
+    key.points_.emplace_back(sp.station_route_, kind);
+  }
+
+  return key;
+}
+
+cista::hash_t interval_cache::key_hash::operator()(key const& k) const {
+  auto h = cista::hash_combine(cista::BASE_HASH, static_cast<bool>(k.freight_));
+
+  for (auto const ir_id : k.path_) {
+    h = cista::hash_combine(h, ir_id);
+  }
+
+  for (auto const& [sr_id, kind] : k.points_) {
+    h = cista::hash_combine(h, sr_id, static_cast<uint8_t>(kind));
+  }
+
+  for (auto const t : k.event_types_) {
+    h = cista::hash_combine(h, static_cast<type_id>(t));
+  }
+
+  return h;
+}
+
+interval_list interval_cache::get(train const& train,
+                                  rs::train_physics const& physics,
+                                  type_set const& event_types,
+                                  infrastructure const& infra) {
+  auto key = get_cache_key(train, event_types);
+
+  {
+    std::shared_lock const lock{mutex_};
+    if (auto const it = cache_.find(key); it != std::end(cache_)) {
+      ++hits_;
+      return bind_interval_list(it->second, train, physics);
+    }
+  }
+
+  // computed without holding the lock, when two threads compute the same
+  // geometry concurrently the first inserted one is kept
+  auto geometry = std::make_shared<interval_geometry const>(
+      get_interval_geometry(train, event_types, infra));
+  ++misses_;
+
+  {
+    std::unique_lock const lock{mutex_};
+    cache_.emplace(std::move(key), geometry);
+  }
+
+  return bind_interval_list(std::move(geometry), train, physics);
+}
+
+void interval_cache::report() const {
+  uLOG(utl::info) << "interval cache: " << cache_.size()
+                  << " distinct geometries, " << hits_ << " hits, " << misses_
+                  << " misses";
+}
+
 }  // namespace soro::runtime
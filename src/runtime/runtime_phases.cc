@@ -0,0 +1,223 @@
+#include "soro/runtime/runtime_phases.h"
+
+#include <algorithm>
+
+#include "utl/verify.h"
+
+#include "soro/utls/sassert.h"
+
+namespace soro::runtime {
+
+using namespace soro::si;
+using namespace soro::tt;
+using namespace soro::infra;
+
+interval_phases::interval_phases(
+    std::span<runtime_result const> const accel_results, speed current_speed,
+    interval const& prev_interval, interval const& interval,
+    rs::train_physics const& tp)
+    : accel_results_{accel_results} {
+  auto const interval_length = interval.distance_ - prev_interval.distance_;
+
+  // Acceleration phase
+  if (has_accel_phase()) {
+    accel_ = accel_results_.back();
+    accel_.speed_ = std::min(accel_.speed_, interval.max_speed(tp));
+    current_speed = accel_.speed_;
+  }
+
+  // Deacceleration phase, determined before coasting phase
+  auto const target_speed = interval.target_speed(tp);
+  if (current_speed > target_speed) {
+    deaccel_profile_.emplace(tp, current_speed, target_speed);
+    utl::verify(deaccel_profile_->distance_ <= interval_length,
+                "Not enough distance to deaccel");
+  }
+
+  // if acceleration distance and deacceleration distance is larger than
+  // available distance don't accelerate to top speed, but stop before.
+  if (has_accel_phase() && has_deaccel_phase() &&
+      accel_.distance_ + deaccel_profile_->distance_ >= interval_length) {
+    auto step = accel_results_.size() - 1;
+    while (true) {
+      utl::verify(step != 0, "Undefined behaviour starting here.");
+      --step;
+
+      auto const& candidate = accel_results_[step];
+      if (candidate.speed_ <= target_speed) {
+        deaccel_profile_.reset();
+        break;
+      }
+
+      deaccel_profile_.emplace(tp, candidate.speed_, target_speed);
+      if (deaccel_profile_->distance_ + candidate.distance_ <=
+          interval_length) {
+        break;
+      }
+    }
+
+    accel_ = accel_results_[step];
+    current_speed = accel_.speed_;
+  }
+
+  if (has_deaccel_phase()) {
+    deaccel_ = deaccel_profile_->last();
+  }
+
+  utl::verify(accel_.distance_ + deaccel_.distance_ <= interval_length ||
+                  !has_accel_phase() || !has_deaccel_phase(),
+              "Not enough distance to accel and deaccel");
+
+  // Coasting phase
+  auto const coast_distance =
+      interval_length - accel_.distance_ - deaccel_.distance_;
+  if (coast_distance > ZERO<length>) {
+    coast_profile_.emplace(current_speed, coast_distance);
+    coast_ = coast_profile_->last();
+  }
+
+  utl::verify(has_accel_phase() || has_coast_phase() || has_deaccel_phase(),
+              "There must be at least one phase!");
+}
+
+speed interval_phases::end_speed() const {
+  auto result = accel_.speed_;
+  result = has_coast_phase() ? coast_.speed_ : result;
+  result = has_deaccel_phase() ? deaccel_.speed_ : result;
+  return result;
+}
+
+time interval_phases::duration() const {
+  return accel_.time_ + coast_.time_ + deaccel_.time_;
+}
+
+time interval_phases::event_time(length const delta_distance) const {
+  if (has_accel_phase() && delta_distance <= accel_.distance_) {
+    for (auto const& accel_result : accel_results_) {
+      if (accel_result.distance_ >= delta_distance) {
+        return accel_result.time_;
+      }
+    }
+  } else if (has_coast_phase() &&
+             delta_distance <= accel_.distance_ + coast_.distance_) {
+    auto const t = coast_profile_->reaching(accel_.distance_, delta_distance);
+    if (t.has_value()) {
+      return accel_.time_ + *t;
+    }
+  } else if (has_deaccel_phase() &&
+             delta_distance <=
+                 accel_.distance_ + coast_.distance_ + deaccel_.distance_) {
+    auto const t = deaccel_profile_->reaching(
+        accel_.distance_ + coast_.distance_, delta_distance);
+    if (t.has_value()) {
+      return accel_.time_ + coast_.time_ + *t;
+    }
+  }
+
+  throw utl::fail("Could not find event time in phases!");
+}
+
+namespace {
+
+void add_timestamp(timestamps& ts, relative_time const arrival,
+                   relative_time const departure, element::ptr const element) {
+  utls::sassert(ts.times_.empty() || valid(arrival),
+                "Only the first timestamp can have invalid arrival");
+  utls::sassert(departure >= arrival);
+  // TODO(julian) reenable this, after improving the condition.
+  // elements on the same kilometrage do not necessarily have to be
+  // in ascending order
+  // utls::sassert(ts.times_.empty() || arrival >=
+  // ts.times_.back().departure_);
+
+  if (element->is(type::HALT)) {
+    ts.halt_indices_.push_back(ts.times_.size());
+  }
+
+  ts.times_.emplace_back(arrival, departure, element);
+}
+
+}  // namespace
+
+runtime_state::runtime_state(train const& train,
+                             rs::train_physics const& physics,
+                             interval_list const& intervals)
+    : train_{&train}, physics_{&physics}, intervals_{&intervals} {
+  utls::sassert(!train.break_in_ && !train.break_out_, "Not supported.");
+  utls::sassert(intervals.front().is_halt(),
+                "First event must be the departure halt.");
+
+  for (auto const& event : intervals.front().events_) {
+    add_timestamp(ts_, train.sequence_points_.front().departure_,
+                  train.first_departure(), event.node_->element_);
+  }
+}
+
+runtime_results runtime_state::accelerate(soro::size_t const idx) const {
+  auto const& prev_interval = (*intervals_)[idx - 1];
+  auto const& interval = (*intervals_)[idx];
+
+  auto const max_speed = interval.max_speed(*physics_);
+  if (current_.speed_ >= max_speed) {
+    return {};
+  }
+
+  return soro::accelerate(*physics_, current_.speed_, max_speed,
+                          interval.distance_ - prev_interval.distance_);
+}
+
+void runtime_state::advance(
+    soro::size_t const idx,
+    std::span<runtime_result const> const accel_results) {
+  auto const& prev_interval = (*intervals_)[idx - 1];
+  auto const& interval = (*intervals_)[idx];
+
+  auto const interval_length = interval.distance_ - prev_interval.distance_;
+  utls::sassert(!is_zero(interval_length), "No intervals with length 0.");
+
+  interval_phases const p(accel_results, current_.speed_, prev_interval,
+                          interval, *physics_);
+
+  auto const start_time = train_->first_departure();
+  auto const interval_start_departure =
+      start_time + si_to_relative_time(current_.time_);
+
+  current_.speed_ = p.end_speed();
+  current_.time_ += p.duration();
+  current_.distance_ += interval_length;
+
+  auto const interval_end_arrival =
+      start_time + si_to_relative_time(current_.time_);
+  auto interval_end_departure = interval_end_arrival;
+
+  if (interval.is_halt()) {
+    auto const earliest_possible_dep =
+        interval_end_arrival + interval.min_stop_time();
+    auto const planned_dep = interval.departure();
+
+    interval_end_departure = std::max(planned_dep, earliest_possible_dep);
+
+    auto const stand_time = interval_end_departure - interval_end_arrival;
+    current_.time_ += relative_to_si_time(stand_time);
+  }
+
+  for (auto const& event : interval.events_) {
+    if (event.distance_ == interval.distance_) {
+      add_timestamp(ts_, interval_end_arrival, interval_end_departure,
+                    event.node_->element_);
+      continue;
+    }
+
+    auto const event_time =
+        p.event_time(event.distance_ - prev_interval.distance_);
+    auto const time_stamp =
+        interval_start_departure + si_to_relative_time(event_time);
+
+    add_timestamp(ts_, time_stamp, time_stamp, event.node_->element_);
+  }
+
+  utl::verify(current_.speed_ <= interval.limit_right_,
+              "Going over speed limit is not allowed!");
+}
+
+}  // namespace soro::runtime
@@ -10,18 +10,94 @@ namespace soro {
 
 using namespace soro::si;
 
+namespace {
+
+time step_time(std::size_t const step) {
+  return static_cast<precision>(step) * DELTA_T;
+}
+
+}  // namespace
+
+brake_profile::brake_profile(rs::train_physics const& tp,
+                             speed const initial_speed,
+                             speed const target_speed)
+    : initial_speed_{initial_speed},
+      target_speed_{target_speed},
+      deacceleration_{tp.deacceleration()} {
+  utl::verify(initial_speed > target_speed,
+              "Target speed higher than current speed in deacceleration!");
+
+  speed const delta_speed = initial_speed - target_speed;
+  time const braking_time = -delta_speed / deacceleration_;
+
+  distance_ = (0.5 * deacceleration_ * pow<2>(braking_time)) +
+              (initial_speed * braking_time);
+
+  for (auto t = ZERO<time>; t < braking_time; t += DELTA_T) {
+    ++steps_;
+  }
+}
+
+runtime_result brake_profile::last() const {
+  return {step_time(steps_), distance_, target_speed_};
+}
+
+std::optional<time> brake_profile::reaching(length const offset,
+                                            length const delta) const {
+  length distance = ZERO<length>;
+  speed current_speed = initial_speed_;
+
+  for (std::size_t step = 0; step <= steps_; ++step) {
+    auto const d = step == steps_ && steps_ > 0 ? distance_ : distance;
+    if (offset + d >= delta) {
+      return step_time(step);
+    }
+
+    distance += current_speed * DELTA_T;
+    current_speed += deacceleration_ * DELTA_T;
+  }
+
+  return std::nullopt;
+}
+
+coast_profile::coast_profile(speed const current_speed, length const distance)
+    : speed_{current_speed}, distance_{distance} {
+  for (auto d = ZERO<length>; d < distance; d += current_speed * DELTA_T) {
+    ++steps_;
+  }
+}
+
+runtime_result coast_profile::last() const {
+  return {step_time(steps_), steps_ > 0 ? distance_ : ZERO<length>, speed_};
+}
+
+std::optional<time> coast_profile::reaching(length const offset,
+                                            length const delta) const {
+  length distance = ZERO<length>;
+
+  for (std::size_t step = 0; step <= steps_; ++step) {
+    auto const d = step == steps_ && steps_ > 0 ? distance_ : distance;
+    if (offset + d >= delta) {
+      return step_time(step);
+    }
+
+    distance += speed_ * DELTA_T;
+  }
+
+  return std::nullopt;
+}
+
 runtime_results coast(speed const current_speed, length const distance) {
-  auto const total_time = distance / current_speed;
+  coast_profile const profile(current_speed, distance);
 
   runtime_results coasting_results;
-  coasting_results.reserve(
-      static_cast<size_t>(as_precision(total_time / DELTA_T)));
+  coasting_results.reserve(profile.steps_ + 1);
 
   time current_time = ZERO<time>;
   length current_distance = ZERO<length>;
   coasting_results.emplace_back(current_time, current_distance, current_speed);
 
-  while (current_distance < distance) {
+  for (std::size_t step = 0; step < profile.steps_; ++step) {
     current_time += DELTA_T;
     current_distance += current_speed * DELTA_T;
     coasting_results.emplace_back(current_time, current_distance,
@@ -29,7 +105,7 @@ runtime_results coast(speed const current_speed, length const distance) {
   }
 
   if (coasting_results.size() > 1) {
-    coasting_results.back().distance_ = distance;
+    coasting_results.back() = profile.last();
   }
 
   return coasting_results;
@@ -37,36 +113,26 @@ runtime_results coast(speed const current_speed, length const distance) {
 
 runtime_results brake(rs::train_physics const& tp, speed const initial_speed,
                       speed const target_speed) {
-  utl::verify(initial_speed > target_speed,
-              "Target speed higher than current speed in deacceleration!");
-
-  speed const delta_speed = initial_speed - target_speed;
-  time const braking_time = -delta_speed / tp.deacceleration();
+  brake_profile const profile(tp, initial_speed, target_speed);
 
   runtime_results deaccel_results;
-  deaccel_results.reserve(
-      static_cast<size_t>(as_s(braking_time) / as_s(DELTA_T)));
-
-  length const braking_distance =
-      (0.5 * tp.deacceleration() * pow<2>(braking_time)) +
-      (initial_speed * braking_time);
+  deaccel_results.reserve(profile.steps_ + 1);
 
   time current_time = ZERO<time>;
   length current_distance = ZERO<length>;
   speed current_speed = initial_speed;
   deaccel_results.emplace_back(current_time, current_distance, current_speed);
 
-  while (current_time < braking_time) {
+  for (std::size_t step = 0; step < profile.steps_; ++step) {
     current_time += DELTA_T;
     current_distance += current_speed * DELTA_T;
-    current_speed += tp.deacceleration() * DELTA_T;
+    current_speed += profile.deacceleration_ * DELTA_T;
 
     deaccel_results.emplace_back(current_time, current_distance, current_speed);
   }
 
   if (deaccel_results.size() > 1) {
-    deaccel_results.back().distance_ = braking_distance;
-    deaccel_results.back().speed_ = target_speed;
+    deaccel_results.back() = profile.last();
   }
 
   return deaccel_results;
@@ -86,11 +152,7 @@ runtime_results accelerate(rs::train_physics const& tp,
   while (current_speed < tp.max_speed() && current_speed < target_speed &&
          current_distance < max_distance) {
 
-    force const tractive = tp.tractive_force(current_speed);
-    force const resistive = tp.resistive_force(current_speed);
-
-    acceleration const acceleration =
-        (tractive - resistive) / (tp.weight() * MASS_FACTOR);
+    acceleration const acceleration = tp.acceleration(current_speed);
 
     speed const prev_speed = current_speed;
     current_speed += acceleration * DELTA_T;
@@ -100,15 +162,21 @@ runtime_results accelerate(rs::train_physics const& tp,
     rr.emplace_back(current_time, current_distance, current_speed);
   }
 
-  if (rr.back().distance_ > max_distance) {
-    rr.pop_back();
+  limit_distance(rr, max_distance);
 
-    if (rr.size() > 1) {
-      rr.back().distance_ = max_distance;
-    }
+  return rr;
+}
+
+void limit_distance(runtime_results& accel_results, length const max_distance) {
+  if (accel_results.empty() || accel_results.back().distance_ <= max_distance) {
+    return;
   }
 
-  return rr;
+  accel_results.pop_back();
+
+  if (accel_results.size() > 1) {
+    accel_results.back().distance_ = max_distance;
+  }
 }
 
-}  // namespace soro
\ No newline at end of file
+}  // namespace soro
@@ -0,0 +1,755 @@
+#include "soro/simulation/monte_carlo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "utl/concat.h"
+#include "utl/erase_duplicates.h"
+#include "utl/logging.h"
+#include "utl/parallel_for.h"
+#include "utl/timer.h"
+#include "utl/verify.h"
+
+#include "soro/utls/sassert.h"
+#include "soro/utls/std_wrapper/any_of.h"
+#include "soro/utls/std_wrapper/contains.h"
+#include "soro/utls/std_wrapper/sort.h"
+
+#include "soro/runtime/runtime.h"
+#include "soro/simulation/disruption.h"
+
+namespace soro::simulation {
+
+using namespace soro::tt;
+using namespace soro::infra;
+
+duration2 delay_distribution::sample(double const u) const {
+  utls::sassert(!cdf_.empty(), "sampling from empty delay distribution");
+
+  auto const it = std::upper_bound(std::begin(cdf_), std::end(cdf_), u);
+  auto const idx = std::min(
+      static_cast<std::size_t>(std::distance(std::begin(cdf_), it)),
+      cdf_.size() - 1);
+
+  return delays_[idx];
+}
+
+void add_delay(delay_distribution& dist, time_t const delay_s,
+               probability_t const prob) {
+  if (zero(prob)) {
+    return;
+  }
+
+  dist.delays_.emplace_back(static_cast<duration2::rep>(delay_s));
+  dist.cdf_.emplace_back(
+      (dist.cdf_.empty() ? 0.0 : dist.cdf_.back()) + static_cast<double>(prob));
+}
+
+void normalize(delay_distribution& dist) {
+  utl::verify(!dist.cdf_.empty() && dist.cdf_.back() > 0.0,
+              "delay distribution without probability mass");
+
+  auto const total = dist.cdf_.back();
+  for (auto& c : dist.cdf_) {
+    c /= total;
+  }
+}
+
+delay_distribution make_halt_delay_distribution() {
+  delay_distribution result;
+
+  for (auto const [delay, prob] : get_halt_distribution()) {
+    add_delay(result, delay.d_, prob);
+  }
+
+  normalize(result);
+  return result;
+}
+
+delay_distribution make_runtime_delay_distribution() {
+  delay_distribution result;
+
+  // the delay does not depend on the arrival, the speed only spreads the
+  // probability mass, so the marginal over the speed is the delay distribution
+  auto const origin = utls::unixtime{0};
+  auto const dist =
+      get_runtime_distribution(origin, kilometer_per_hour{uint16_t{100}});
+
+  for (auto const [arrival, speeds] : dist) {
+    add_delay(result, arrival.t_ - origin.t_, subsum(speeds));
+  }
+
+  normalize(result);
+  return result;
+}
+
+template <typename InFn, typename OutFn>
+std::vector<ordering_node::id> get_topological_order(std::size_t const node_count,
+                                                     InFn const& in,
+                                                     OutFn const& out) {
+  std::vector<ordering_node::id> result;
+  result.reserve(node_count);
+
+  std::vector<soro::size_t> in_degree(node_count);
+  for (ordering_node::id id = 0; id < node_count; ++id) {
+    in_degree[id] = static_cast<soro::size_t>(in(id).size());
+    if (in_degree[id] == 0) {
+      result.emplace_back(id);
+    }
+  }
+
+  for (std::size_t idx = 0; idx < result.size(); ++idx) {
+    for (auto const succ : out(result[idx])) {
+      if (--in_degree[succ] == 0) {
+        result.emplace_back(succ);
+      }
+    }
+  }
+
+  utl::verify(result.size() == node_count,
+              "ordering graph contains a cycle, can not sample delays");
+
+  return result;
+}
+
+std::vector<ordering_node::id> get_topological_order(ordering_graph const& og) {
+  return get_topological_order(
+      og.nodes_.size(),
+      [&](ordering_node::id const id) -> auto const& {
+        return og.nodes_[id].in_;
+      },
+      [&](ordering_node::id const id) -> auto const& {
+        return og.nodes_[id].out_;
+      });
+}
+
+monte_carlo_model make_monte_carlo_model(ordering_graph const& og,
+                                         infrastructure const& infra,
+                                         timetable const& tt) {
+  utl::scoped_timer const timer("creating monte carlo model");
+
+  monte_carlo_model model;
+  model.nodes_.resize(og.nodes_.size());
+  model.topological_order_ = get_topological_order(og);
+  model.halt_delays_ = make_halt_delay_distribution();
+  model.runtime_delays_ = make_runtime_delay_distribution();
+
+  runtime::interval_cache cache;
+
+  runtime::timestamps ts;
+  std::vector<soro::size_t> ms_indices;
+  auto current_train = train::INVALID;
+
+  for (auto const& [trip, node_range] : og.trip_to_nodes_) {
+    auto const& train = tt->trains_[trip.train_id_];
+
+    // trips are ordered by train, only calculate the runtime once per train
+    if (current_train != train.id_) {
+      current_train = train.id_;
+      ts = runtime::runtime_calculation(train, train.physics(*tt), infra,
+                                        {type::MAIN_SIGNAL, type::HALT}, cache);
+
+      ms_indices.clear();
+      for (auto idx = 0U; idx < ts.times_.size(); ++idx) {
+        if (ts.times_[idx].element_->is(type::MAIN_SIGNAL)) {
+          ms_indices.emplace_back(idx);
+        }
+      }
+    }
+
+    auto const [from, to] = node_range;
+    auto const node_count = to - from;
+
+    utls::sassert(ms_indices.size() + 1 == node_count,
+                  "train {} has {} main signals for {} ordering nodes",
+                  train.id_, ms_indices.size(), node_count);
+
+    for (auto k = 0U; k < node_count; ++k) {
+      auto& node = model.nodes_[from + k];
+
+      auto const start = k == 0 ? train.first_departure()
+                                : ts.times_[ms_indices[k - 1]].departure_;
+      auto const end = k + 1 == node_count ? train.last_arrival()
+                                           : ts.times_[ms_indices[k]].arrival_;
+
+      node.scheduled_start_ = relative_to_absolute(trip.anchor_, start);
+      node.scheduled_end_ = std::max(node.scheduled_start_,
+                                     relative_to_absolute(trip.anchor_, end));
+    }
+
+    // every halt but the final arrival can be extended by a dwell delay,
+    // it is attributed to the node the train occupies while halting
+    for (auto h = 0U; h + 1 < ts.halt_indices_.size(); ++h) {
+      auto const halt_idx = ts.halt_indices_[h];
+      auto const k = static_cast<soro::size_t>(std::distance(
+          std::begin(ms_indices),
+          std::lower_bound(std::begin(ms_indices), std::end(ms_indices),
+                           halt_idx)));
+      ++model.nodes_[from + k].halts_;
+    }
+  }
+
+  return model;
+}
+
+// splitmix64 finalizer, a bijection with good avalanche behaviour
+constexpr uint64_t mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27U)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31U);
+}
+
+// a counter based random number generator: the number only depends on its
+// coordinates, not on the order in which numbers are drawn
+double uniform(uint64_t const seed, uint64_t const replication,
+               uint64_t const node, uint64_t const stream) {
+  auto const h = mix(seed ^ mix(replication ^ mix(node ^ mix(stream))));
+  // the upper 53 bits as a double in [0, 1)
+  return static_cast<double>(h >> 11U) * 0x1.0p-53;
+}
+
+// runs fn for every index, in parallel if the options allow it
+template <typename Fn>
+void for_each_idx(monte_carlo_options const& opts, std::size_t const count,
+                  Fn&& fn) {
+  if (opts.parallel_) {
+    utl::parallel_for_run(count, fn);
+  } else {
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      fn(idx);
+    }
+  }
+}
+
+// the runtime delay uses stream 0, the halts of a node streams 1..n
+constexpr uint64_t RUNTIME_STREAM = 0;
+
+// the disruptions resolved to the nodes of the ordering graph
+struct node_disruptions {
+  using edges = std::vector<ordering_node::id>;
+
+  node_disruptions(disruption const& d, ordering_graph const& og)
+      : extra_delay_(og.nodes_.size(), duration2::zero()),
+        closed_(og.nodes_.size()) {
+    for (auto const& delay : d.delays_) {
+      utl::verify(delay.node_ < og.nodes_.size(),
+                  "delayed node {} not in ordering graph", delay.node_);
+
+      extra_delay_[delay.node_] += delay.extra_;
+    }
+
+    if (!d.closures_.empty()) {
+      for (auto const& node : og.nodes_) {
+        for (auto const& closure : d.closures_) {
+          if (closure.ir_ == node.ir_id_) {
+            closed_[node.id_].emplace_back(closure.closed_);
+          }
+        }
+      }
+    }
+
+    // a single pass over closures sorted by start delays past all of them
+    for (auto& closed : closed_) {
+      utls::sort(closed, [](auto&& c1, auto&& c2) {
+        return c1.start_ < c2.start_;
+      });
+    }
+
+    for (auto const [from, to] : d.reversed_orders_) {
+      reverse(from, to, og);
+    }
+
+    if (!d.reversed_orders_.empty()) {
+      order_ = get_topological_order(
+          og.nodes_.size(),
+          [&](ordering_node::id const id) -> auto const& { return in(og, id); },
+          [&](ordering_node::id const id) -> auto const& {
+            return out(og, id);
+          });
+    }
+  }
+
+  // from -> to becomes to -> from, only the two nodes get their own edges
+  void reverse(ordering_node::id const from, ordering_node::id const to,
+               ordering_graph const& og) {
+    utl::verify(from < og.nodes_.size() && to < og.nodes_.size(),
+                "reversed order {} -> {} not in ordering graph", from, to);
+    utl::verify(og.nodes_[from].train_id_ != og.nodes_[to].train_id_,
+                "can not reverse the order within train {}",
+                og.nodes_[from].train_id_);
+    utl::verify(utls::contains(in(og, to), from),
+                "no ordering edge {} -> {} to reverse", from, to);
+
+    auto& to_in = overlay(in_, og.nodes_[to].in_, to);
+    auto& from_out = overlay(out_, og.nodes_[from].out_, from);
+
+    std::erase(to_in, from);
+    std::erase(from_out, to);
+
+    overlay(in_, og.nodes_[from].in_, from).emplace_back(to);
+    overlay(out_, og.nodes_[to].out_, to).emplace_back(from);
+  }
+
+  static edges& overlay(soro::hash_map<ordering_node::id, edges>& m,
+                        edges const& original, ordering_node::id const id) {
+    auto it = m.find(id);
+    if (it == std::end(m)) {
+      it = m.emplace(id, original).first;
+    }
+    return it->second;
+  }
+
+  edges const& in(ordering_graph const& og, ordering_node::id const id) const {
+    auto const it = in_.find(id);
+    return it == std::end(in_) ? og.nodes_[id].in_ : it->second;
+  }
+
+  edges const& out(ordering_graph const& og, ordering_node::id const id) const {
+    auto const it = out_.find(id);
+    return it == std::end(out_) ? og.nodes_[id].out_ : it->second;
+  }
+
+  std::vector<ordering_node::id> const& order(
+      monte_carlo_model const& model) const {
+    return order_.empty() ? model.topological_order_ : order_;
+  }
+
+  std::vector<duration2> extra_delay_;
+  std::vector<std::vector<interval>> closed_;
+
+  // the edges of nodes touched by a reversed order and the resulting order
+  soro::hash_map<ordering_node::id, edges> in_;
+  soro::hash_map<ordering_node::id, edges> out_;
+  std::vector<ordering_node::id> order_;
+};
+
+// the nodes a disruption changes directly. does not reverse anything, the
+// reversed orders may refer to a graph with earlier reversals applied
+std::vector<ordering_node::id> get_seeds(disruption const& d,
+                                         ordering_graph const& og) {
+  std::vector<ordering_node::id> seeds;
+
+  for (auto const& delay : d.delays_) {
+    seeds.emplace_back(delay.node_);
+  }
+
+  if (!d.closures_.empty()) {
+    for (auto const& node : og.nodes_) {
+      if (utls::any_of(d.closures_,
+                       [&](auto&& c) { return c.ir_ == node.ir_id_; })) {
+        seeds.emplace_back(node.id_);
+      }
+    }
+  }
+
+  for (auto const [from, to] : d.reversed_orders_) {
+    seeds.emplace_back(from);
+    seeds.emplace_back(to);
+  }
+
+  utl::erase_duplicates(seeds);
+
+  return seeds;
+}
+
+absolute_time sample_end(monte_carlo_model const& model,
+                         ordering_graph const& og,
+                         monte_carlo_options const& opts,
+                         node_disruptions const& nd, uint64_t const replication,
+                         ordering_node::id const id,
+                         std::span<absolute_time const> const ends) {
+  auto const& dists = opts.distributions_;
+  auto const& node = model.nodes_[id];
+
+  // trains never run ahead of their schedule
+  auto start = node.scheduled_start_;
+  for (auto const in : nd.in(og, id)) {
+    start = std::max(start, ends[in]);
+  }
+
+  for (auto const& closed : nd.closed_[id]) {
+    if (start >= closed.start_ && start < closed.end_) {
+      start = closed.end_;
+    }
+  }
+
+  auto delay = nd.extra_delay_[id];
+
+  if (dists.use_runtime_dists()) {
+    delay += model.runtime_delays_.sample(
+        uniform(opts.seed_, replication, id, RUNTIME_STREAM));
+  }
+
+  if (dists.use_halt_dists()) {
+    for (auto h = 0U; h < node.halts_; ++h) {
+      delay += model.halt_delays_.sample(
+          uniform(opts.seed_, replication, id, RUNTIME_STREAM + 1 + h));
+    }
+  }
+
+  return start + (node.scheduled_end_ - node.scheduled_start_) + delay;
+}
+
+void run_replication(monte_carlo_model const& model, ordering_graph const& og,
+                     monte_carlo_options const& opts,
+                     node_disruptions const& nd, uint64_t const replication,
+                     std::span<absolute_time> const ends) {
+  for (auto const id : nd.order(model)) {
+    ends[id] = sample_end(model, og, opts, nd, replication, id, ends);
+  }
+}
+
+duration2 get_delay(monte_carlo_model const& model, ordering_node::id const id,
+                    absolute_time const end) {
+  return sc::duration_cast<duration2>(end - model.nodes_[id].scheduled_end_);
+}
+
+// per node delay histograms over all replications, the last bin of a node
+// counts every delay beyond the tracked range. nodes ending ahead of their
+// schedule, e.g. after a negative extra delay, count as on time
+struct histograms {
+  histograms(soro::size_t const node_count, monte_carlo_options const& opts)
+      : bin_width_{opts.bin_width_},
+        bins_per_node_{opts.bin_count_ + 1},
+        counts_(static_cast<std::size_t>(node_count) * bins_per_node_),
+        delay_sums_(node_count) {}
+
+  std::span<uint32_t> counts(soro::size_t const idx) {
+    return {counts_.data() + std::size_t{idx} * bins_per_node_,
+            bins_per_node_};
+  }
+
+  void add(soro::size_t const idx, duration2 const delay) {
+    auto const late = std::max(delay, duration2::zero());
+    auto const bin = std::min(
+        static_cast<soro::size_t>(late.count() / bin_width_.count()),
+        bins_per_node_ - 1);
+
+    ++counts(idx)[bin];
+    delay_sums_[idx] += static_cast<uint64_t>(late.count());
+  }
+
+  duration2 bin_width_;
+  soro::size_t bins_per_node_;
+
+  std::vector<uint32_t> counts_;
+  std::vector<uint64_t> delay_sums_;
+};
+
+monte_carlo_result make_empty_result(soro::size_t const node_count,
+                                     monte_carlo_options const& opts) {
+  monte_carlo_result result;
+  result.levels_ = opts.quantiles_;
+  result.replications_ = opts.replications_;
+  result.quantiles_.resize(std::size_t{node_count} * result.levels_.size());
+  result.mean_delay_.resize(node_count);
+  return result;
+}
+
+void write_node_result(monte_carlo_result& result, ordering_node::id const id,
+                       std::span<uint32_t const> const counts,
+                       uint64_t const delay_sum,
+                       monte_carlo_options const& opts) {
+  auto const out = std::span{result.quantiles_}.subspan(
+      std::size_t{id} * result.levels_.size(), result.levels_.size());
+
+  for (auto l = 0U; l < result.levels_.size(); ++l) {
+    auto const target = std::max(
+        uint64_t{1},
+        static_cast<uint64_t>(std::ceil(
+            result.levels_[l] * static_cast<double>(opts.replications_))));
+
+    uint64_t seen = 0;
+    soro::size_t bin = 0;
+    for (; bin < counts.size(); ++bin) {
+      seen += counts[bin];
+      if (seen >= target) {
+        break;
+      }
+    }
+
+    out[l] = opts.bin_width_ *
+             static_cast<duration2::rep>(std::min(bin, opts.bin_count_));
+  }
+
+  result.mean_delay_[id] = static_cast<double>(delay_sum) /
+                           static_cast<double>(opts.replications_);
+}
+
+void check_inputs(monte_carlo_model const& model, ordering_graph const& og,
+                  monte_carlo_options const& opts) {
+  utl::verify(model.nodes_.size() == og.nodes_.size(),
+              "model for {} nodes used with ordering graph of {} nodes",
+              model.nodes_.size(), og.nodes_.size());
+  utl::verify(opts.replications_ > 0, "no replications requested");
+  utl::verify(opts.block_size_ > 0, "block size must not be zero");
+  utl::verify(opts.bin_width_ > duration2::zero(), "bin width must be > 0");
+}
+
+monte_carlo_result simulate_monte_carlo(
+    monte_carlo_model const& model, ordering_graph const& og,
+    monte_carlo_options const& opts, disruption const& d,
+    std::span<ordering_node::id const> const nodes) {
+  utl::scoped_timer const timer("monte carlo delay simulation");
+
+  check_inputs(model, og, opts);
+
+  auto const node_count = static_cast<soro::size_t>(og.nodes_.size());
+  for (auto const id : nodes) {
+    utls::expect(id < node_count, "requested node {} not in ordering graph",
+                 id);
+  }
+
+  node_disruptions const nd(d, og);
+
+  histograms hists(static_cast<soro::size_t>(nodes.size()), opts);
+
+  auto const block_size = std::min(opts.block_size_, opts.replications_);
+  std::vector<absolute_time> block_ends(std::size_t{block_size} * node_count);
+
+  for (soro::size_t block_start = 0; block_start < opts.replications_;
+       block_start += block_size) {
+    auto const count = std::min(block_size, opts.replications_ - block_start);
+
+    for_each_idx(opts, count, [&](auto&& r) {
+      run_replication(
+          model, og, opts, nd, block_start + r,
+          std::span{block_ends}.subspan(std::size_t{r} * node_count,
+                                        node_count));
+    });
+
+    // every node is only written by one thread and the replications of a
+    // node are always added in the same order
+    for_each_idx(opts, nodes.size(), [&](auto&& idx) {
+      auto const id = nodes[idx];
+      for (auto r = 0U; r < count; ++r) {
+        auto const end = block_ends[std::size_t{r} * node_count + id];
+        hists.add(static_cast<soro::size_t>(idx), get_delay(model, id, end));
+      }
+    });
+  }
+
+  auto result = make_empty_result(node_count, opts);
+  for (auto idx = 0U; idx < nodes.size(); ++idx) {
+    write_node_result(result, nodes[idx], hists.counts(idx),
+                      hists.delay_sums_[idx], opts);
+  }
+
+  return result;
+}
+
+monte_carlo_result simulate_monte_carlo(monte_carlo_model const& model,
+                                        ordering_graph const& og,
+                                        monte_carlo_options const& opts,
+                                        disruption const& d) {
+  std::vector<ordering_node::id> all(og.nodes_.size());
+  std::iota(std::begin(all), std::end(all), ordering_node::id{0});
+  return simulate_monte_carlo(model, og, opts, d, all);
+}
+
+monte_carlo_result simulate_monte_carlo(monte_carlo_model const& model,
+                                        ordering_graph const& og,
+                                        monte_carlo_options const& opts) {
+  return simulate_monte_carlo(model, og, opts, disruption{});
+}
+
+// recomputes the statistics of the given nodes from the stored replications
+void update_results(monte_carlo_state& state, monte_carlo_model const& model,
+                    std::span<ordering_node::id const> const nodes) {
+  auto const node_count = static_cast<soro::size_t>(model.nodes_.size());
+
+  histograms hists(static_cast<soro::size_t>(nodes.size()), state.opts_);
+
+  for_each_idx(state.opts_, nodes.size(), [&](auto&& idx) {
+    auto const id = nodes[idx];
+    for (auto r = 0U; r < state.opts_.replications_; ++r) {
+      hists.add(static_cast<soro::size_t>(idx),
+                get_delay(model, id,
+                          state.ends_[std::size_t{r} * node_count + id]));
+    }
+  });
+
+  for (auto idx = 0U; idx < nodes.size(); ++idx) {
+    write_node_result(state.result_, nodes[idx], hists.counts(idx),
+                      hists.delay_sums_[idx], state.opts_);
+  }
+}
+
+monte_carlo_state make_monte_carlo_state(monte_carlo_model const& model,
+                                         ordering_graph const& og,
+                                         monte_carlo_options const& opts,
+                                         disruption d) {
+  utl::scoped_timer const timer("monte carlo delay simulation, keeping state");
+
+  check_inputs(model, og, opts);
+
+  auto const node_count = static_cast<soro::size_t>(og.nodes_.size());
+  node_disruptions const nd(d, og);
+
+  monte_carlo_state state;
+  state.opts_ = opts;
+  state.disruption_ = std::move(d);
+  state.ends_.resize(std::size_t{opts.replications_} * node_count);
+  state.result_ = make_empty_result(node_count, opts);
+
+  for_each_idx(opts, opts.replications_, [&](auto&& r) {
+    run_replication(
+        model, og, opts, nd, r,
+        std::span{state.ends_}.subspan(std::size_t{r} * node_count,
+                                       node_count));
+  });
+
+  std::vector<ordering_node::id> all(node_count);
+  std::iota(std::begin(all), std::end(all), ordering_node::id{0});
+  update_results(state, model, all);
+
+  return state;
+}
+
+// all nodes reachable from the seeds, in topological order
+std::vector<ordering_node::id> get_cone(
+    monte_carlo_model const& model, ordering_graph const& og,
+    node_disruptions const& nd,
+    std::span<ordering_node::id const> const seeds) {
+  std::vector<bool> reached(og.nodes_.size(), false);
+  std::vector<ordering_node::id> stack(std::begin(seeds), std::end(seeds));
+
+  for (auto const seed : seeds) {
+    reached[seed] = true;
+  }
+
+  while (!stack.empty()) {
+    auto const id = stack.back();
+    stack.pop_back();
+
+    for (auto const out : nd.out(og, id)) {
+      if (!reached[out]) {
+        reached[out] = true;
+        stack.emplace_back(out);
+      }
+    }
+  }
+
+  std::vector<ordering_node::id> cone;
+  for (auto const id : nd.order(model)) {
+    if (reached[id]) {
+      cone.emplace_back(id);
+    }
+  }
+
+  return cone;
+}
+
+std::vector<ordering_node::id> resimulate(monte_carlo_state& state,
+                                          monte_carlo_model const& model,
+                                          ordering_graph const& og,
+                                          disruption const& added,
+                                          duration2 const tolerance) {
+  utl::scoped_timer const timer("incremental monte carlo delay simulation");
+
+  utl::verify(state.ends_.size() ==
+                  std::size_t{state.opts_.replications_} * og.nodes_.size(),
+              "monte carlo state does not belong to the ordering graph");
+
+  auto accumulated = state.disruption_;
+  utl::concat(accumulated.delays_, added.delays_);
+  utl::concat(accumulated.closures_, added.closures_);
+  utl::concat(accumulated.reversed_orders_, added.reversed_orders_);
+
+  // the new disruptions decide where to start, the accumulated ones how
+  // every node of the cone is sampled. resolving the accumulated disruptions
+  // verifies them, the state stays as it is if they are invalid
+  node_disruptions const nd(accumulated, og);
+  auto const seeds = get_seeds(added, og);
+  state.disruption_ = std::move(accumulated);
+
+  auto const cone = get_cone(model, og, nd, seeds);
+  if (cone.empty()) {
+    return {};
+  }
+
+  auto const node_count = og.nodes_.size();
+  constexpr auto NOT_IN_CONE = std::numeric_limits<soro::size_t>::max();
+
+  std::vector<soro::size_t> cone_idx(node_count, NOT_IN_CONE);
+  for (auto idx = 0U; idx < cone.size(); ++idx) {
+    cone_idx[cone[idx]] = idx;
+  }
+
+  std::vector<bool> is_seed(cone.size(), false);
+  for (auto const id : seeds) {
+    is_seed[cone_idx[id]] = true;
+  }
+
+  // changed[r * cone.size() + i]: cone node i changed in replication r
+  std::vector<uint8_t> changed(std::size_t{state.opts_.replications_} *
+                               cone.size());
+
+  for_each_idx(state.opts_, state.opts_.replications_, [&](auto&& r) {
+    auto const ends =
+        std::span{state.ends_}.subspan(r * node_count, node_count);
+    auto const changed_in_r =
+        std::span{changed}.subspan(r * cone.size(), cone.size());
+
+    for (auto idx = 0U; idx < cone.size(); ++idx) {
+      auto const id = cone[idx];
+
+      // only nodes depending on a changed node have to be sampled again,
+      // the propagation stops where the arrival stays the same
+      auto const dirty =
+          is_seed[idx] ||
+          utls::any_of(nd.in(og, id), [&](auto&& in) {
+            return cone_idx[in] != NOT_IN_CONE && changed_in_r[cone_idx[in]];
+          });
+
+      if (!dirty) {
+        continue;
+      }
+
+      auto const end = sample_end(model, og, state.opts_, nd, r, id, ends);
+      auto const diff = end > ends[id] ? end - ends[id] : ends[id] - end;
+
+      if (sc::duration_cast<duration2>(diff) > tolerance) {
+        ends[id] = end;
+        changed_in_r[idx] = 1;
+      }
+    }
+  });
+
+  std::vector<ordering_node::id> result;
+  for (auto idx = 0U; idx < cone.size(); ++idx) {
+    for (auto r = 0U; r < state.opts_.replications_; ++r) {
+      if (changed[std::size_t{r} * cone.size() + idx] != 0) {
+        result.emplace_back(cone[idx]);
+        break;
+      }
+    }
+  }
+
+  update_results(state, model, result);
+
+  return result;
+}
+
+std::span<duration2 const> monte_carlo_result::quantiles(
+    ordering_node::id const id) const {
+  return {quantiles_.data() + std::size_t{id} * levels_.size(),
+          levels_.size()};
+}
+
+duration2 monte_carlo_result::quantile(ordering_node::id const id,
+                                       soro::size_t const quantile_idx) const {
+  utls::expect(quantile_idx < levels_.size(), "quantile {} not computed",
+               quantile_idx);
+  return quantiles(id)[quantile_idx];
+}
+
+absolute_time monte_carlo_result::arrival(
+    monte_carlo_model const& model, ordering_node::id const id,
+    soro::size_t const quantile_idx) const {
+  return model.nodes_[id].scheduled_end_ + quantile(id, quantile_idx);
+}
+
+}  // namespace soro::simulation
@@ -65,7 +65,8 @@ ordering_graph::ordering_graph(infra::infrastructure const& infra,
     : ordering_graph(infra, tt, filter{}) {}
 
 ordering_graph::ordering_graph(infra::infrastructure const& infra,
-                               tt::timetable const& tt, filter const& filter) {
+                               tt::timetable const& tt, filter const& filter,
+                               std::stop_token const& stop) {
   utl::scoped_timer const timer("creating ordering graph");
 
   ordering_node::id glob_current_node_id = 0;
@@ -80,12 +81,19 @@ ordering_graph::ordering_graph(infra::infrastructure const& infra,
     }
   };
 
+  runtime::interval_cache il_cache;
+
   auto const generate_route_orderings = [&](train const& train) {
     soro::vector<timestamp> times;
 
-    for (auto const anchor : train.departures(filter.interval_)) {
+    for (auto const& trip :
+         tt->trip_index_.overlapping(train.id_, filter.interval_)) {
+      auto const anchor = trip.trip_.anchor_;
+
       if (times.empty()) {
-        times = runtime_calculation(train, infra, {type::MAIN_SIGNAL}).times_;
+        times = runtime_calculation(train, train.physics(*tt), infra,
+                                    {type::MAIN_SIGNAL}, il_cache)
+                    .times_;
 
         utls::sasserts([&]() {
           auto const ms_count = utls::count_if(times, [](auto&& t) {
@@ -177,9 +185,15 @@ ordering_graph::ordering_graph(infra::infrastructure const& infra,
       continue;
     }
 
+    if (stop.stop_requested()) {
+      return;
+    }
+
     generate_route_orderings(train);
   }
 
+  il_cache.report();
+
   utl::parallel_for(orderings, [](auto&& usage_order) {
     utls::sort(usage_order, [](auto&& usage1, auto&& usage2) {
       return usage1.from_ < usage2.from_;
@@ -188,6 +202,10 @@ ordering_graph::ordering_graph(infra::infrastructure const& infra,
 
   // create edges according to the sorted orderings
   for (auto const& usage_order : orderings) {
+    if (stop.stop_requested()) {
+      return;
+    }
+
     for (auto [from, to] : utl::pairwise(usage_order)) {
       // if the .from timestamps for the orderings are equal then we are just
       // betting that we don't introduce a cycle into the ordering graph
@@ -203,6 +221,10 @@ ordering_graph::ordering_graph(infra::infrastructure const& infra,
     utl::erase_duplicates(node.in_);
   }
 
+  if (stop.stop_requested()) {
+    return;
+  }
+
   remove_transitive_edges(*this);
 
   print_ordering_graph_stats(*this);
@@ -0,0 +1,112 @@
+#include "soro/simulation/scenario_batch.h"
+
+#include <ostream>
+
+#include "utl/logging.h"
+#include "utl/parallel_for.h"
+#include "utl/timer.h"
+
+#include "soro/utls/sassert.h"
+
+namespace soro::simulation {
+
+using namespace soro::tt;
+using namespace soro::infra;
+
+std::span<duration2 const> scenario_table::quantiles(
+    soro::size_t const scenario_idx, soro::size_t const trip_idx) const {
+  utls::expect(scenario_idx < scenarios_.size() && trip_idx < trips_.size(),
+               "no entry for scenario {} and trip {}", scenario_idx, trip_idx);
+
+  auto const row = std::size_t{scenario_idx} * trips_.size() + trip_idx;
+  return {quantiles_.data() + row * levels_.size(), levels_.size()};
+}
+
+double scenario_table::mean_delay(soro::size_t const scenario_idx,
+                                  soro::size_t const trip_idx) const {
+  utls::expect(scenario_idx < scenarios_.size() && trip_idx < trips_.size(),
+               "no entry for scenario {} and trip {}", scenario_idx, trip_idx);
+
+  return mean_delay_[std::size_t{scenario_idx} * trips_.size() + trip_idx];
+}
+
+void scenario_table::write_csv(std::ostream& out) const {
+  out << "scenario,train,anchor,mean";
+  for (auto const level : levels_) {
+    out << ",q" << level;
+  }
+  out << '\n';
+
+  for (soro::size_t s = 0; s < scenarios_.size(); ++s) {
+    for (soro::size_t t = 0; t < trips_.size(); ++t) {
+      out << scenarios_[s] << ',' << trips_[t].train_id_ << ','
+          << trips_[t].anchor_.time_since_epoch().count() << ','
+          << mean_delay(s, t);
+
+      for (auto const q : quantiles(s, t)) {
+        out << ',' << q.count();
+      }
+
+      out << '\n';
+    }
+  }
+}
+
+scenario_batch::scenario_batch(infrastructure const& infra,
+                               timetable const& tt,
+                               ordering_graph::filter const& filter,
+                               monte_carlo_options opts)
+    : og_{infra, tt, filter},
+      model_{make_monte_carlo_model(og_, infra, tt)},
+      opts_{std::move(opts)} {
+  // scenarios run concurrently, a single scenario runs sequentially
+  opts_.parallel_ = false;
+
+  trips_.reserve(og_.trip_to_nodes_.size());
+  trip_ends_.reserve(og_.trip_to_nodes_.size());
+
+  for (auto const& [trip, nodes] : og_.trip_to_nodes_) {
+    utls::sassert(nodes.first < nodes.second, "trip without nodes");
+
+    trips_.emplace_back(trip);
+    trip_ends_.emplace_back(nodes.second - 1);
+  }
+}
+
+scenario_table scenario_batch::run(std::span<scenario const> scenarios) const {
+  utl::scoped_timer const timer("running scenario batch");
+
+  scenario_table table;
+  table.trips_ = trips_;
+  table.levels_ = opts_.quantiles_;
+
+  table.scenarios_.reserve(scenarios.size());
+  for (auto const& s : scenarios) {
+    table.scenarios_.emplace_back(s.name_);
+  }
+
+  auto const row_count = scenarios.size() * trips_.size();
+  table.quantiles_.resize(row_count * table.levels_.size());
+  table.mean_delay_.resize(row_count);
+
+  // every scenario writes only its own rows, and only the trip ends get
+  // histograms
+  utl::parallel_for_run(scenarios.size(), [&](auto&& s) {
+    auto const result = simulate_monte_carlo(
+        model_, og_, opts_, scenarios[s].disruption_, trip_ends_);
+
+    for (auto t = 0U; t < trips_.size(); ++t) {
+      auto const row = s * trips_.size() + t;
+      auto const q = result.quantiles(trip_ends_[t]);
+
+      std::copy(std::begin(q), std::end(q),
+                std::begin(table.quantiles_) +
+                    static_cast<std::ptrdiff_t>(row * table.levels_.size()));
+      table.mean_delay_[row] = result.mean_delay_[trip_ends_[t]];
+    }
+  });
+
+  return table;
+}
+
+}  // namespace soro::simulation
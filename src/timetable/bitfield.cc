@@ -1,6 +1,7 @@
 #include "soro/timetable/bitfield.h"
 
 #include <array>
+#include <bit>
 
 #include "utl/verify.h"
 
@@ -44,25 +45,85 @@ bitfield::anchor_time idx_to_date(bitfield::anchor_time const first_date,
   return {first_date + days(idx)};
 }
 
+using block_t = bitfield::bitset::block_t;
+constexpr auto const BLOCK_BITS = bitfield::bitset::bits_per_block;
+
+// the bits [from, from + n) of the block containing from, shifted to the
+// lowest positions. requires the range to not cross a block boundary.
+block_t get_bits(bitfield::bitset const& bs, std::size_t const from,
+                 std::size_t const n) {
+  auto const block = bs.blocks_[from / BLOCK_BITS] >> (from % BLOCK_BITS);
+  return n == BLOCK_BITS ? block : block & ((block_t{1} << n) - 1);
+}
+
+// returns the index of the first set bit in [from, to), to if there is none
+std::size_t next_set_idx(bitfield::bitset const& bs, std::size_t from,
+                         std::size_t const to) {
+  while (from < to) {
+    auto const block_end = std::min(to, (from / BLOCK_BITS + 1) * BLOCK_BITS);
+    auto const bits = get_bits(bs, from, block_end - from);
+
+    if (bits != 0) {
+      return from + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+
+    from = block_end;
+  }
+
+  return to;
+}
+
+// returns the index of the last set bit in [from, to), to if there is none
+std::size_t prev_set_idx(bitfield::bitset const& bs, std::size_t const from,
+                         std::size_t const to) {
+  auto block_end = to;
+
+  while (from < block_end) {
+    auto const block_start =
+        std::max(from, ((block_end - 1) / BLOCK_BITS) * BLOCK_BITS);
+    auto const bits = get_bits(bs, block_start, block_end - block_start);
+
+    if (bits != 0) {
+      return block_start + BLOCK_BITS - 1 -
+             static_cast<std::size_t>(std::countl_zero(bits));
+    }
+
+    block_end = block_start;
+  }
+
+  return to;
+}
+
+// returns the number of set bits in [from, to)
+std::size_t count_set(bitfield::bitset const& bs, std::size_t from,
+                      std::size_t const to) {
+  std::size_t result = 0;
+
+  while (from < to) {
+    auto const block_end = std::min(to, (from / BLOCK_BITS + 1) * BLOCK_BITS);
+    result += static_cast<std::size_t>(
+        std::popcount(get_bits(bs, from, block_end - from)));
+    from = block_end;
+  }
+
+  return result;
+}
+
 bitfield::iterator::iterator(bitfield const* bitfield, idx_t const idx)
     : bitfield_{bitfield}, idx_{idx} {
   utls::expect(idx_ <= get_end_idx(bitfield), "got invalid idx");
 
-  if (idx_ != get_end_idx(bitfield) &&
-      !bitfield_->at(idx_to_date(bitfield_->first_date_, idx_))) {
-    this->operator++();
-  }
+  idx_ = static_cast<idx_t>(
+      next_set_idx(bitfield_->bitset_, idx_, get_end_idx(bitfield_)));
 
   utls::ensure(idx_ <= get_end_idx(bitfield), "created invalid idx");
 }
 
 bitfield::iterator& bitfield::iterator::operator++() {
   utls::expect(idx_ < get_end_idx(bitfield_), "incrementing end iterator");
-  ++idx_;
 
-  while (idx_ < get_end_idx(bitfield_) && !bitfield_->bitset_[idx_]) {
-    ++idx_;
-  }
+  idx_ = static_cast<idx_t>(
+      next_set_idx(bitfield_->bitset_, idx_ + 1U, get_end_idx(bitfield_)));
 
   utls::ensure(idx_ <= get_end_idx(bitfield_), "created invalid iterator");
   utls::ensure(idx_ == get_end_idx(bitfield_) || bitfield_->bitset_[idx_],
@@ -121,11 +182,11 @@ bool bitfield::ok() const noexcept {
 
 std::vector<bitfield::anchor_time> bitfield::get_set_days() const {
   std::vector<bitfield::anchor_time> result;
+  result.reserve(this->count());
 
-  for (auto i = 0UL; i < BITSIZE; ++i) {
-    if (this->bitset_.test(i)) {
-      result.push_back(idx_to_date(this->first_date_, i));
-    }
+  for (auto i = next_set_idx(bitset_, 0, BITSIZE); i < BITSIZE;
+       i = next_set_idx(bitset_, i + 1, BITSIZE)) {
+    result.push_back(idx_to_date(this->first_date_, i));
   }
 
   return result;
@@ -200,6 +261,28 @@ bool bitfield::equivalent(bitfield const& o) const noexcept {
   }
 }
 
+bitfield operator&(bitfield const& lhs, bitfield const& rhs) noexcept {
+  auto copy = lhs;
+  copy &= rhs;
+  return copy;
+}
+
+bitfield bitfield::operator&=(bitfield const& o) noexcept {
+  if (o.last_date_ < this->first_date_ || this->last_date_ < o.first_date_) {
+    this->bitset_ = bitset{};
+    return *this;
+  }
+
+  // overlapping ranges, so the distance between the first dates is < BITSIZE
+  if (this->first_date_ <= o.first_date_) {
+    this->bitset_ &= o.bitset_ << distance(this->first_date_, o.first_date_);
+  } else {
+    this->bitset_ &= o.bitset_ >> distance(o.first_date_, this->first_date_);
+  }
+
+  return *this;
+}
+
 bitfield operator|(bitfield const& lhs, bitfield const& rhs) noexcept {
   auto copy = lhs;
   copy |= rhs;
@@ -232,9 +315,7 @@ soro::size_t bitfield::count() const noexcept {
 absolute_time bitfield::first_set_date() const noexcept {
   utls::expect(bitset_.any(), "no bits set in bitfield, procedure will fail");
 
-  std::size_t first_set_idx = 0;
-
-  while (!bitset_.test(first_set_idx)) ++first_set_idx;
+  auto const first_set_idx = next_set_idx(bitset_, 0, get_end_idx(this));
 
   return absolute_time{idx_to_date(first_date_, first_set_idx)};
 }
@@ -242,13 +323,30 @@ absolute_time bitfield::first_set_date() const noexcept {
 absolute_time bitfield::last_set_date() const noexcept {
   utls::expect(bitset_.any(), "no bits set in bitfield, procedure will fail");
 
-  std::size_t last_set_idx = distance(first_date_, last_date_);
-
-  while (!bitset_.test(last_set_idx)) --last_set_idx;
+  auto const last_set_idx = prev_set_idx(bitset_, 0, get_end_idx(this));
 
   return absolute_time{idx_to_date(first_date_, last_set_idx)};
 }
 
+soro::size_t bitfield::count(anchor_time const from,
+                             anchor_time const to) const noexcept {
+  if (to < from || to < first_date_ || last_date_ < from) {
+    return 0;
+  }
+
+  auto const from_idx = distance(first_date_, std::max(from, first_date_));
+  auto const to_idx = distance(first_date_, std::min(to, last_date_)) + 1;
+
+  return utls::narrow<soro::size_t>(count_set(bitset_, from_idx, to_idx));
+}
+
+bitfield bitfield::shifted(date::days const offset) const noexcept {
+  auto copy = *this;
+  copy.first_date_ += offset;
+  copy.last_date_ += offset;
+  return copy;
+}
+
 bitfield make_bitfield(bitfield::anchor_time const first_date,
                        bitfield::anchor_time const last_date,
                        const char* const bitmask) {
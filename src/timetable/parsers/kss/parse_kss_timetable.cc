@@ -1,22 +1,34 @@
 #include "soro/timetable/parsers/kss/parse_kss_timetable.h"
 
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "pugixml.hpp"
 
-#include "utl/concat.h"
 #include "utl/enumerate.h"
 #include "utl/logging.h"
 #include "utl/parallel_for.h"
 #include "utl/timer.h"
+#include "utl/verify.h"
 
 #include "soro/base/error.h"
 
+#include "soro/utls/file/loaded_file.h"
 #include "soro/utls/parse_fp.h"
 #include "soro/utls/parse_int.h"
 #include "soro/utls/sassert.h"
 #include "soro/utls/statistics.h"
+#include "soro/utls/std_wrapper/accumulate.h"
 #include "soro/utls/std_wrapper/any_of.h"
+#include "soro/utls/std_wrapper/sort.h"
 #include "soro/utls/string.h"
 
 #include "soro/timetable/bitfield.h"
@@ -336,10 +348,79 @@ utls::result<rs::train_physics> parse_characteristic(
   auto const ctc = static_cast<rs::CTC>(
       utls::equal(charac_xml.child_value("trainProtection"), "true"));
 
-  return rs::train_physics{tvs, carriage_weight, length, max_speed,
-                           ctc, freight};
+  return rs::train_physics::make(std::move(tvs), carriage_weight, length,
+                                 max_speed, ctc, freight);
 }
 
+// interns the compositions of all parsed construction trains.
+// the key consists of the raw characteristic values, so equal compositions are
+// only parsed once and all their trains share one train_physics.
+// safe to use from multiple threads at once.
+struct composition_table {
+  static std::string get_key(xml_node const charac_xml) {
+    std::string key;
+
+    for (auto const traction_unit_xml :
+         charac_xml.child("tractionUnits").children()) {
+      auto const series_xml =
+          traction_unit_xml.child("tractionUnitDesignSeries");
+
+      key += series_xml.child_value("designSeries");
+      key += '|';
+      key += series_xml.child("designSeries").attribute("Nr").value();
+      key += '|';
+      key += series_xml.child_value("variante");
+      key += ';';
+    }
+
+    for (auto const value : {"totalLength", "totalWeight", "maxVelocity",
+                             "relevantStopPositionMode", "trainProtection"}) {
+      key += charac_xml.child_value(value);
+      key += ';';
+    }
+
+    return key;
+  }
+
+  utls::result<rs::train_physics::id> get(
+      xml_node const charac_xml, rs::rolling_stock const& rolling_stock) {
+    auto key = get_key(charac_xml);
+
+    {
+      std::shared_lock const lock{mutex_};
+      if (auto const it = key_to_id_.find(key); it != std::end(key_to_id_)) {
+        return it->second;
+      }
+    }
+
+    auto phys = parse_characteristic(charac_xml, rolling_stock);
+    if (!phys) {
+      return utls::propagate(phys);
+    }
+
+    std::unique_lock const lock{mutex_};
+
+    // another thread might have inserted the same composition in the meantime
+    auto const [it, inserted] = key_to_id_.emplace(
+        std::move(key), static_cast<rs::train_physics::id>(store_.size()));
+    if (inserted) {
+      store_.emplace_back(std::move(*phys));
+    }
+
+    return it->second;
+  }
+
+  // references into the store remain valid while it grows
+  rs::train_physics const& operator[](rs::train_physics::id const id) const {
+    std::shared_lock const lock{mutex_};
+    return store_[id];
+  }
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, rs::train_physics::id> key_to_id_;
+  std::deque<rs::train_physics> store_;
+};
+
 utls::result<void> is_supported(stop_sequence const& stop_sequence,
                                 infrastructure const& infra, train const& t) {
 
@@ -398,7 +479,9 @@ train::number parse_train_number(xml_node const train_number_xml) {
 }
 
 utls::result<train> parse_construction_train(
-    xml_node const construction_train_xml, infrastructure const& infra) {
+    xml_node const construction_train_xml, infrastructure const& infra,
+    composition_table& compositions,
+    interlocking_transformation_cache& ir_cache) {
   train t;
 
   t.number_ = parse_train_number(construction_train_xml.child("trainNumber"));
@@ -415,11 +498,13 @@ utls::result<train> parse_construction_train(
 
   auto const characteristic_xml =
       construction_train_xml.child("characteristic");
-  auto phys = parse_characteristic(characteristic_xml, infra->rolling_stock_);
-  if (!phys) {
-    return utls::propagate(phys);
+  auto const composition =
+      compositions.get(characteristic_xml, infra->rolling_stock_);
+  if (!composition) {
+    return utls::propagate(composition);
   }
-  t.physics_ = std::move(*phys);
+
+  t.set_composition(*composition, compositions[*composition]);
 
   if (auto supported = is_supported(*train_sequence, infra, t); !supported) {
     return utls::propagate(supported);
@@ -429,7 +514,7 @@ utls::result<train> parse_construction_train(
   t.break_out_ = train_sequence->break_out_;
 
   auto transformed =
-      transform_to_interlocking(*train_sequence, t.physics_.freight(), infra);
+      ir_cache.get(*train_sequence, t.freight(), infra);
 
   if (!transformed) {
     return utls::propagate(transformed);
@@ -441,69 +526,200 @@ utls::result<train> parse_construction_train(
   return t;
 }
 
-utls::result<soro::vector<train>> parse_kss_train(xml_node const train_xml,
-                                                  infrastructure const& infra) {
-  soro::vector<train> result;
-
+// parses all construction trains of the given train into trains.
+// a train is only kept when all its construction trains could be parsed.
+utls::result<void> parse_kss_train(xml_node const train_xml,
+                                   infrastructure const& infra,
+                                   composition_table& compositions,
+                                   interlocking_transformation_cache& ir_cache,
+                                   soro::vector<train>& trains) {
   // don't parse worked on trains
   auto const train_status = train_xml.attribute("trainStatus").value();
   if (!utls::equal(train_status, "freig")) {
     return std::unexpected(error::kss::WORKED_ON_TRAIN);
   }
 
+  auto const first_new = trains.size();
+
   for (auto const construction_train_xml :
        train_xml.child("fineConstruction").children("constructionTrain")) {
 
-    auto const train = parse_construction_train(construction_train_xml, infra);
+    auto train = parse_construction_train(construction_train_xml, infra,
+                                          compositions, ir_cache);
 
     if (!train) {
+      trains.resize(first_new);
       return utls::propagate(train);
     }
 
-    result.emplace_back(*train);
+    trains.emplace_back(std::move(*train));
   }
 
-  return result;
+  return {};
 }
 
-utls::result<soro::vector<train>> parse_timetable_file(
-    std::filesystem::path const& fp, infrastructure const& infra,
-    error::stats& stats) {
-  soro::vector<train> result;
+// yields the <tag>...</tag> elements of an xml document one after another as
+// views into the document, without building a dom for the whole document.
+// elements with the given tag must not be nested.
+struct element_reader {
+  element_reader(utls::loaded_file const& file, char const* const tag)
+      : xml_{reinterpret_cast<char const*>(file.data()),  // NOLINT
+             file.size()},
+        open_{"<" + std::string{tag}},
+        close_{"</" + std::string{tag} + ">"} {}
+
+  std::optional<std::string_view> next() {
+    while (true) {
+      auto const start = xml_.find(open_, pos_);
+      if (start == std::string_view::npos) {
+        return std::nullopt;
+      }
 
-  auto const loaded_file = utls::load_file(fp);
+      // skip elements only sharing the prefix, e.g. <trainNumber> for <train
+      auto const after = start + open_.size();
+      if (after == xml_.size() ||
+          (xml_[after] != '>' &&
+           std::isspace(static_cast<unsigned char>(xml_[after])) == 0)) {
+        pos_ = after;
+        continue;
+      }
+
+      auto const end = xml_.find(close_, after);
+      utl::verify(end != std::string_view::npos, "unterminated element {}>",
+                  open_);
+
+      pos_ = end + close_.size();
+      return xml_.substr(start, pos_ - start);
+    }
+  }
+
+  std::string_view xml_;
+  std::string open_;
+  std::string close_;
+  std::size_t pos_{0};
+};
+
+// the elements are parsed without the xml declaration of the document,
+// so take the encoding from the declaration of the whole document
+xml_encoding get_encoding(utls::loaded_file const& file) {
+  std::string_view const xml{
+      reinterpret_cast<char const*>(file.data()),  // NOLINT
+      file.size()};
+
+  // without a declaration the document is utf-8
+  auto const declaration_end = xml.find("?>");
+  if (!xml.starts_with("<?xml") || declaration_end == std::string_view::npos) {
+    return encoding_utf8;
+  }
 
-  xml_document file_xml;
-  auto success = file_xml.load_buffer(
-      reinterpret_cast<void const*>(loaded_file.data()), loaded_file.size());
+  xml_document d;
+  auto success =
+      d.load_buffer(reinterpret_cast<void const*>(file.data()),
+                    declaration_end + 2, parse_declaration, encoding_utf8);
+  utl::verify(success, "bad xml declaration in {}: {}", file.path_,
+              success.description());
 
-  utl::verify(success,
-              "pugixml error '{}' while parsing {} from kss timetable {}!",
-              success.description(), fp);
+  std::string name = d.first_child().attribute("encoding").as_string("UTF-8");
+  std::ranges::transform(name, std::begin(name), [](unsigned char const c) {
+    return static_cast<char>(std::toupper(c));
+  });
 
-  auto const timetable_xml =
-      file_xml.child("KSS").child("railml").child("timetable");
+  // the elements are found by scanning for ascii tags, which only works for
+  // encodings using single bytes for ascii characters
+  std::optional<xml_encoding> encoding;
+  if (name == "UTF-8" || name == "US-ASCII") {
+    encoding = encoding_utf8;
+  } else if (name == "ISO-8859-1" || name == "LATIN1") {
+    encoding = encoding_latin1;
+  }
 
-  for (auto const train_xml : timetable_xml.children("train")) {
-    auto const trains = parse_kss_train(train_xml, infra);
+  utl::verify(encoding.has_value(), "unknown encoding {} in kss timetable {}",
+              name, file.path_);
 
-    if (!trains) {
-      stats.count(trains);
-      continue;
-    }
+  return *encoding;
+}
 
-    utl::concat(result, *trains);
+std::size_t count_occurrences(std::string_view const str,
+                              std::string_view const pattern) {
+  std::size_t result = 0;
+
+  for (auto pos = str.find(pattern); pos != std::string_view::npos;
+       pos = str.find(pattern, pos + pattern.size())) {
+    ++result;
   }
 
   return result;
 }
 
+// streams the trains of a kss file into the given shard.
+// only the dom of a single train is held in memory at any time.
+void parse_timetable_file(std::filesystem::path const& fp,
+                          infrastructure const& infra,
+                          composition_table& compositions,
+                          interlocking_transformation_cache& ir_cache,
+                          error::stats& stats, soro::vector<train>& shard) {
+  auto const loaded_file = utls::load_file(fp);
+  auto const encoding = get_encoding(loaded_file);
+
+  std::string_view const xml{
+      reinterpret_cast<char const*>(loaded_file.data()),  // NOLINT
+      loaded_file.size()};
+  shard.reserve(static_cast<soro::size_t>(
+      shard.size() + count_occurrences(xml, "</constructionTrain>")));
+
+  xml_document train_doc;
+  element_reader reader{loaded_file, "train"};
+
+  for (auto train_str = reader.next(); train_str.has_value();
+       train_str = reader.next()) {
+    auto const success = train_doc.load_buffer(
+        train_str->data(), train_str->size(), parse_default, encoding);
+
+    utl::verify(success, "bad xml while parsing train from {}: {}", fp,
+                success.description());
+
+    auto const parsed = parse_kss_train(train_doc.child("train"), infra,
+                                        compositions, ir_cache, shard);
+
+    if (!parsed) {
+      stats.count(parsed);
+    }
+  }
+}
+
 void set_ids(soro::vector<train>& trains) {
   for (auto [id, train] : utl::enumerate(trains)) {
     train.id_ = static_cast<train::id>(id);
   }
 }
 
+// the parsing threads intern the compositions in the order they finish, so
+// the compositions are renumbered by their key and the trains remapped,
+// giving the same ids for the same timetable on every run
+soro::vector<rs::train_physics> move_compositions(
+    composition_table& compositions, soro::vector<train>& trains) {
+  std::vector<std::pair<std::string_view, rs::train_physics::id>> by_key;
+  by_key.reserve(compositions.key_to_id_.size());
+  for (auto const& [key, id] : compositions.key_to_id_) {
+    by_key.emplace_back(key, id);
+  }
+  utls::sort(by_key);
+
+  soro::vector<rs::train_physics> result;
+  result.reserve(static_cast<soro::size_t>(by_key.size()));
+  std::vector<rs::train_physics::id> new_ids(by_key.size());
+  for (auto const& [key, old_id] : by_key) {
+    new_ids[old_id] = static_cast<rs::train_physics::id>(result.size());
+    result.emplace_back(std::move(compositions.store_[old_id]));
+  }
+
+  for (auto& train : trains) {
+    train.composition_ = new_ids[train.composition_];
+  }
+
+  return result;
+}
+
 infra::version get_required_infra_version(timetable_options const& opts) {
   utls::expect(fs::is_directory(opts.timetable_path_),
                "timetable path {} is not a directory", opts.timetable_path_);
@@ -513,15 +729,20 @@ infra::version get_required_infra_version(timetable_options const& opts) {
   auto const first_fp = begin(fs::directory_iterator{opts.timetable_path_});
   auto const first_file = utls::load_file(first_fp->path());
 
+  // only parse the version description instead of the whole file
+  auto const version_str =
+      element_reader{first_file, "spurplanVersionDescription"}.next();
+  utl::verify(version_str.has_value(),
+              "no infrastructure version description in kss timetable {}",
+              first_fp->path());
+
   xml_document tt_xml;
-  auto success = tt_xml.load_buffer(
-      reinterpret_cast<void const*>(first_file.data()), first_file.size());
-  utl::verify(success,
-              "pugixml error '{}' while parsing {} from kss timetable {}!",
-              success.description(), *first_fp);
+  auto success = tt_xml.load_buffer(version_str->data(), version_str->size(),
+                                    parse_default, get_encoding(first_file));
+  utl::verify(success, "bad xml while parsing version from {}: {}",
+              first_fp->path(), success.description());
 
-  auto const version_xml =
-      tt_xml.child("KSS").child("header").child("spurplanVersionDescription");
+  auto const version_xml = tt_xml.child("spurplanVersionDescription");
 
   version v;
 
@@ -553,13 +774,16 @@ utls::result<base_timetable> parse_kss_timetable(
 
   utl::scoped_timer const timetable_timer("parsing kss timetable");
   error::stats stats("parsing kss timetable");
+  composition_table compositions;
+  interlocking_transformation_cache ir_cache;
 
   base_timetable bt;
   bt.source_ = opts.timetable_path_.filename().string();
 
+  // every timetable file is parsed into its own shard of trains
   struct work_item {
     fs::path timetable_file_;
-    utls::result<soro::vector<train>> result_;
+    soro::vector<train> trains_;
   };
 
   std::vector<work_item> work_todo;
@@ -573,25 +797,36 @@ utls::result<base_timetable> parse_kss_timetable(
   }
 
   utl::parallel_for_run(work_todo.size(), [&](auto&& work_id) {
-    work_todo[work_id].result_ =
-        parse_timetable_file(work_todo[work_id].timetable_file_, infra, stats);
+    parse_timetable_file(work_todo[work_id].timetable_file_, infra,
+                         compositions, ir_cache, stats,
+                         work_todo[work_id].trains_);
   });
 
-  for (auto const& work_item : work_todo) {
-    if (!work_item.result_) {
-      return utls::propagate(work_item.result_);
+  bt.trains_.reserve(utls::accumulate(
+      work_todo, soro::size_t{0}, [](auto&& acc, auto&& work_item) {
+        return acc + static_cast<soro::size_t>(work_item.trains_.size());
+      }));
+
+  // move the trains out of the shards, releasing every shard right away
+  for (auto& work_item : work_todo) {
+    for (auto& train : work_item.trains_) {
+      bt.trains_.emplace_back(std::move(train));
     }
 
-    utl::concat(bt.trains_, *work_item.result_);
+    work_item.trains_ = soro::vector<train>{};
   }
 
   set_ids(bt.trains_);
 
+  bt.compositions_ = move_compositions(compositions, bt.trains_);
+
   bt.interval_ = get_interval(bt.trains_);
 
   uLOG(utl::info) << "total trains runs successfully parsed: "
-                  << bt.trains_.size();
+                  << bt.trains_.size() << " with " << bt.compositions_.size()
+                  << " distinct compositions";
   stats.report();
+  ir_cache.report();
 
   return bt;
 }
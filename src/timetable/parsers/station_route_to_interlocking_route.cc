@@ -170,32 +170,32 @@ utls::result<first_ir> get_first_ir(stop_sequence const& stop_sequence,
   return std::unexpected(error::route_transform::NO_UNIQUE_FIRST_IR);
 }
 
-soro::vector<sequence_point> get_sequence_points(interlocking_route const& ir,
-                                                 stop_sequence const& ss,
-                                                 rs::FreightTrain const freight,
-                                                 std::size_t const last_prefix,
-                                                 std::size_t const new_prefix,
-                                                 infrastructure const& infra) {
-  soro::vector<sequence_point> result;
+std::vector<std::size_t> get_sequence_point_idxs(
+    interlocking_route const& ir, stop_sequence const& ss,
+    rs::FreightTrain const freight, std::size_t const last_prefix,
+    std::size_t const new_prefix, infrastructure const& infra) {
+  std::vector<std::size_t> result;
 
   for (auto sp_idx = last_prefix; sp_idx < new_prefix; ++sp_idx) {
-    auto const sequence_point = ss.points_[sp_idx];
+    auto const& sequence_point = ss.points_[sp_idx];
 
     auto const sr_node_idx = sequence_point.get_node_idx(freight, infra);
 
     if (sr_node_idx.has_value() &&
         ir.contains(sequence_point.station_route_, *sr_node_idx)) {
-      result.emplace_back(sequence_point);
+      result.emplace_back(sp_idx);
     }
   }
 
   return result;
 }
 
-utls::result<interlocking_transformation> transform_to_interlocking(
+using transformation_value = interlocking_transformation_cache::value;
+
+utls::result<transformation_value> get_transformation(
     stop_sequence const& stop_sequence, FreightTrain const freight,
     infrastructure const& infra) {
-  interlocking_transformation result;
+  transformation_value result;
 
   auto const& irs = infra->interlocking_;
 
@@ -217,9 +217,9 @@ utls::result<interlocking_transformation> transform_to_interlocking(
 
   result.path_.emplace_back(first_ir->id_);
   utl::concat(
-      result.sequence_points_,
-      get_sequence_points(*current_ir, stop_sequence, freight, 0,
-                          current_cover.stop_sequence_offset_ + 1, infra));
+      result.sequence_point_idxs_,
+      get_sequence_point_idxs(*current_ir, stop_sequence, freight, 0,
+                              current_cover.stop_sequence_offset_ + 1, infra));
 
   while (!current_cover.covers(stop_sequence, freight, infra)) {
     auto const candidates = get_candidates(
@@ -242,12 +242,11 @@ utls::result<interlocking_transformation> transform_to_interlocking(
     current_ir = &irs.routes_[longest_prefix_routes.front()];
 
     result.path_.emplace_back(current_ir->id_);
-    utl::concat(
-        result.sequence_points_,
-        get_sequence_points(*current_ir, stop_sequence, freight,
-                            current_cover.stop_sequence_offset_,
-                            current_cover.stop_sequence_offset_ + prefix_length,
-                            infra));
+    utl::concat(result.sequence_point_idxs_,
+                get_sequence_point_idxs(
+                    *current_ir, stop_sequence, freight,
+                    current_cover.stop_sequence_offset_,
+                    current_cover.stop_sequence_offset_ + prefix_length, infra));
 
     // the current cover + the current interlocking route cover more
     // than the given stop sequence.
@@ -277,10 +276,101 @@ utls::result<interlocking_transformation> transform_to_interlocking(
     auto const measurable_points = utls::count_if(
         stop_sequence.points_, [](auto&& sp) { return sp.is_measurable(); });
 
-    utls::ensure(measurable_points == result.sequence_points_.size());
+    utls::ensure(measurable_points == result.sequence_point_idxs_.size());
   });
 
   return result;
 }
 
+utls::result<interlocking_transformation> to_interlocking_transformation(
+    utls::result<transformation_value> const& value,
+    stop_sequence const& stop_sequence) {
+  if (!value) {
+    return utls::propagate(value);
+  }
+
+  interlocking_transformation result;
+  result.path_ = value->path_;
+
+  result.sequence_points_.reserve(value->sequence_point_idxs_.size());
+  for (auto const sp_idx : value->sequence_point_idxs_) {
+    result.sequence_points_.emplace_back(stop_sequence.points_[sp_idx]);
+  }
+
+  return result;
+}
+
+utls::result<interlocking_transformation> transform_to_interlocking(
+    stop_sequence const& stop_sequence, FreightTrain const freight,
+    infrastructure const& infra) {
+  return to_interlocking_transformation(
+      get_transformation(stop_sequence, freight, infra), stop_sequence);
+}
+
+interlocking_transformation_cache::key get_cache_key(
+    stop_sequence const& stop_sequence, FreightTrain const freight) {
+  using point_kind = interlocking_transformation_cache::point_kind;
+
+  interlocking_transformation_cache::key key;
+  key.freight_ = freight;
+  key.break_in_ = stop_sequence.break_in_;
+  key.break_out_ = stop_sequence.break_out_;
+
+  key.points_.reserve(stop_sequence.points_.size());
+  for (auto const& sp : stop_sequence.points_) {
+    auto const kind = sp.has_transit_time() ? point_kind::CHECKPOINT
+                      : sp.is_halt()        ? point_kind::HALT
+                                            : point_kind::PASS;
+    key.points_.emplace_back(sp.station_route_, kind);
+  }
+
+  return key;
+}
+
+cista::hash_t interlocking_transformation_cache::key_hash::operator()(
+    key const& k) const {
+  auto h = cista::hash_combine(cista::BASE_HASH, static_cast<bool>(k.freight_),
+                               k.break_in_, k.break_out_);
+
+  for (auto const& [sr_id, kind] : k.points_) {
+    h = cista::hash_combine(h, sr_id, static_cast<uint8_t>(kind));
+  }
+
+  return h;
+}
+
+utls::result<interlocking_transformation> interlocking_transformation_cache::get(
+    stop_sequence const& stop_sequence, FreightTrain const freight,
+    infrastructure const& infra) {
+  auto key = get_cache_key(stop_sequence, freight);
+
+  {
+    std::shared_lock const lock{mutex_};
+    if (auto const it = cache_.find(key); it != std::end(cache_)) {
+      ++hits_;
+      return to_interlocking_transformation(it->second, stop_sequence);
+    }
+  }
+
+  // computed without holding the lock, when two threads compute the same
+  // transformation concurrently the first inserted one is kept
+  auto value = get_transformation(stop_sequence, freight, infra);
+  ++misses_;
+
+  auto result = to_interlocking_transformation(value, stop_sequence);
+
+  {
+    std::unique_lock const lock{mutex_};
+    cache_.emplace(std::move(key), std::move(value));
+  }
+
+  return result;
+}
+
+void interlocking_transformation_cache::report() const {
+  uLOG(utl::info) << "interlocking transformation cache: " << cache_.size()
+                  << " distinct stop sequences, " << hits_ << " hits, "
+                  << misses_ << " misses";
+}
+
 }  // namespace soro::tt
\ No newline at end of file
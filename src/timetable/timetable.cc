@@ -6,6 +6,7 @@
 #include "soro/timetable/base_timetable.h"
 #include "soro/timetable/parsers/kss/parse_kss_timetable.h"
 #include "soro/timetable/timetable_error.h"
+#include "soro/timetable/trip_index.h"
 
 namespace soro::tt {
 
@@ -17,9 +18,16 @@ timetable_source get_source_type(timetable_options const& opts) {
   return timetable_source::NOT_FOUND;
 }
 
+// the trip index does not depend on the source, every parser only provides
+// the trains
+void add_trip_index(base_timetable& bt) {
+  bt.trip_index_ = make_trip_index(bt.trains_);
+}
+
 timetable::timetable(base_timetable&& bt) {
   mem_ = std::move(bt);
   access_ = std::addressof(std::get<base_timetable>(mem_));
+  add_trip_index(std::get<base_timetable>(mem_));
 }
 
 timetable::timetable(timetable_options const& opts,
@@ -43,6 +51,7 @@ timetable::timetable(timetable_options const& opts,
   }
 
   access_ = std::addressof(std::get<base_timetable>(mem_));
+  add_trip_index(std::get<base_timetable>(mem_));
 }
 
 utls::result<timetable> try_parsing_timetable(
@@ -1,9 +1,11 @@
 #include "soro/timetable/train.h"
 
 #include "soro/utls/narrow.h"
+#include "soro/utls/sassert.h"
 #include "soro/utls/std_wrapper/count_if.h"
 
 #include "soro/infrastructure/path/length.h"
+#include "soro/timetable/base_timetable.h"
 
 namespace soro::tt {
 
@@ -60,15 +62,28 @@ utls::it_range<train::iterator> train::departures() const {
   return departures(interval{});
 }
 
-FreightTrain train::freight() const { return this->physics_.freight(); }
+train_physics const& train::physics(base_timetable const& bt) const {
+  utls::expect(composition_ < bt.compositions_.size(),
+               "train {} without a composition of the timetable", id_);
+  return bt.compositions_[composition_];
+}
+
+void train::set_composition(train_physics::id const id,
+                            train_physics const& composition) {
+  composition_ = id;
+  freight_ = composition.freight();
+  ctc_ = composition.ctc();
+}
+
+FreightTrain train::freight() const { return freight_; }
 bool train::is_freight() const { return static_cast<bool>(this->freight()); }
 
 bool train::has_ctc() const { return static_cast<bool>(this->ctc()); };
-CTC train::ctc() const { return this->physics_.ctc(); }
+CTC train::ctc() const { return ctc_; }
 
 si::length train::path_length(infrastructure const& infra) const {
   return get_path_length_from_elements(
-      utls::coro_map(this->iterate(infra), [](auto&& rn) { return rn.node_; }));
+      this->iterate(infra), [](auto&& tn) { return tn.node_->element_; });
 }
 
 relative_time train::first_departure() const {
@@ -165,9 +180,12 @@ infra::interlocking_route const& train::last_interlocking_route(
   return infra->interlocking_.routes_[path_.back()];
 }
 
-utls::recursive_generator<route_node> iterate_train(
-    train const& t, infrastructure const& infra) {
-
+// returns the nodes of the train path that lie in the interlocking route at
+// path_idx. two following interlocking routes share the last and first node,
+// the shared node is only yielded by the former interlocking route.
+interlocking_route::range get_path_segment(train const& t,
+                                           soro::size_t const path_idx,
+                                           infrastructure const& infra) {
   if (t.path_.size() == 1) {
     auto const from_sr_id =
         t.break_in_ ? t.first_interlocking_route(infra).station_routes_.front()
@@ -185,14 +203,15 @@ utls::recursive_generator<route_node> iterate_train(
             ? t.first_interlocking_route(infra).end_offset_
             : *t.sequence_points_.back().get_node_idx(t.freight(), infra) + 1;
 
-    co_yield t.first_interlocking_route(infra).from_to(from_sr_id, from_idx,
-                                                       to_sr_id, to_idx, infra);
-    co_return;
+    return t.first_interlocking_route(infra).from_to(from_sr_id, from_idx,
+                                                     to_sr_id, to_idx, infra);
   }
 
-  if (t.break_in_) {
-    co_yield t.first_interlocking_route(infra).iterate(infra);
-  } else {
+  if (path_idx == 0) {
+    if (t.break_in_) {
+      return t.first_interlocking_route(infra).iterate(infra);
+    }
+
     utls::sassert(t.sequence_points_.front().is_halt(),
                   "First sequence point in non-breakin train {} is not a halt.",
                   t.id_);
@@ -206,53 +225,102 @@ utls::recursive_generator<route_node> iterate_train(
                   "sequence point in train {} does not.",
                   t.id_);
 
-    co_yield t.first_interlocking_route(infra).from(sr_id, *node_idx, infra);
+    return t.first_interlocking_route(infra).from(sr_id, *node_idx, infra);
   }
 
-  for (auto i = 1U; i < t.path_.size() - 1; ++i) {
-    auto const& ir = infra->interlocking_.routes_[t.path_[i]];
-    // skip the first element, we already yielded it
-    // two following interlocking routes share the first and last element
-    co_yield ir.from(ir.first_sr_id(), ir.start_offset_ + 1, infra);
+  auto const& ir = infra->interlocking_.routes_[t.path_[path_idx]];
+
+  // skip the first element, we already yielded it
+  if (path_idx < t.path_.size() - 1 || t.break_out_) {
+    return ir.from(ir.first_sr_id(), ir.start_offset_ + 1, infra);
   }
 
-  auto const last_ir = t.last_interlocking_route(infra);
-  if (t.break_out_) {
-    co_yield last_ir.from(last_ir.first_sr_id(), last_ir.start_offset_ + 1,
-                          infra);
-  } else {
-    utls::sassert(t.sequence_points_.back().is_halt(),
-                  "Last sequence point in non-breakout train {} is not a halt.",
-                  t.id_);
+  utls::sassert(t.sequence_points_.back().is_halt(),
+                "Last sequence point in non-breakout train {} is not a halt.",
+                t.id_);
 
-    auto const sr_id = t.sequence_points_.back().station_route_;
-    auto const node_idx =
-        t.sequence_points_.back().get_node_idx(t.freight(), infra);
+  auto const sr_id = t.sequence_points_.back().station_route_;
+  auto const node_idx =
+      t.sequence_points_.back().get_node_idx(t.freight(), infra);
 
-    utls::sassert(node_idx.has_value(),
-                  "All sequence points in a train must have a value. Last "
-                  "sequence point in train {} does not.",
-                  t.id_);
+  utls::sassert(node_idx.has_value(),
+                "All sequence points in a train must have a value. Last "
+                "sequence point in train {} does not.",
+                t.id_);
 
-    co_yield last_ir.from_to(last_ir.first_sr_id(), last_ir.start_offset_ + 1,
-                             sr_id, (*node_idx) + 1, infra);
+  return ir.from_to(ir.first_sr_id(), ir.start_offset_ + 1, sr_id,
+                    (*node_idx) + 1, infra);
+}
+
+train::node_iterator::node_iterator(train const* train,
+                                    infrastructure const* infra,
+                                    soro::size_t const path_idx)
+    : train_{train}, infra_{infra}, path_idx_{path_idx} {
+  if (path_idx_ < train_->path_.size()) {
+    enter_path_idx();
+    skip_exhausted();
+    set_current();
   }
 }
 
-utls::recursive_generator<train_node> train::iterate(
-    infrastructure const& infra) const {
-  uint32_t sp_idx = 0;
-  for (auto&& rn : iterate_train(*this, infra)) {
-    if (sp_idx < sequence_points_.size() &&
-        *sequence_points_[sp_idx].get_node(freight(), infra) == rn.node_) {
-
-      co_yield train_node(
-          rn, sequence_point::optional_ptr(&sequence_points_[sp_idx]));
-      ++sp_idx;
-    } else {
-      co_yield train_node(rn, {});
+void train::node_iterator::enter_path_idx() {
+  auto const segment = get_path_segment(*train_, path_idx_, *infra_);
+  ir_it_ = segment.begin();
+  ir_end_ = segment.end();
+}
+
+void train::node_iterator::skip_exhausted() {
+  while (ir_it_ == ir_end_) {
+    ++path_idx_;
+
+    if (path_idx_ == train_->path_.size()) {
+      ir_it_ = {};
+      ir_end_ = {};
+      return;
     }
+
+    enter_path_idx();
+  }
+}
+
+void train::node_iterator::set_current() {
+  if (path_idx_ == train_->path_.size()) {
+    return;
   }
+
+  auto const& sps = train_->sequence_points_;
+  auto const& rn = *ir_it_;
+
+  if (sp_idx_ < sps.size() &&
+      *sps[sp_idx_].get_node(train_->freight(), *infra_) == rn.node_) {
+    current_ = train_node(rn, sequence_point::optional_ptr(&sps[sp_idx_]));
+    ++sp_idx_;
+  } else {
+    current_ = train_node(rn, {});
+  }
+}
+
+train::node_iterator& train::node_iterator::operator++() {
+  utls::sassert(path_idx_ < train_->path_.size(),
+                "incrementing end train node iterator");
+
+  ++ir_it_;
+  skip_exhausted();
+  set_current();
+
+  return *this;
+}
+
+train::node_iterator train::node_iterator::operator++(int) {
+  auto copy = *this;
+  ++(*this);
+  return copy;
+}
+
+utls::it_range<train::node_iterator> train::iterate(
+    infrastructure const& infra) const {
+  return utls::make_range(node_iterator{this, &infra, 0},
+                          node_iterator{this, &infra, path_.size()});
 }
 
 }  // namespace soro::tt
@@ -0,0 +1,134 @@
+#include "soro/timetable/trip_index.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+#include "utl/timer.h"
+#include "utl/verify.h"
+
+#include "soro/utls/sassert.h"
+
+namespace soro::tt {
+
+// collects the overlapping trips below node, which covers the trips [lo, hi).
+// only trips before `to` depart early enough
+void collect_overlapping(trip_index const& idx, std::size_t const node,
+                         std::size_t const lo, std::size_t const hi,
+                         std::size_t const to, absolute_time const start,
+                         std::vector<train::trip>& result) {
+  if (lo >= to || idx.latest_arrival_[node] < start) {
+    return;
+  }
+
+  if (hi - lo == 1) {
+    result.emplace_back(idx.by_departure_[lo].trip_);
+    return;
+  }
+
+  auto const mid = lo + (hi - lo) / 2;
+  collect_overlapping(idx, 2 * node, lo, mid, to, start, result);
+  collect_overlapping(idx, 2 * node + 1, mid, hi, to, start, result);
+}
+
+std::vector<train::trip> trip_index::overlapping(interval const& i) const {
+  std::vector<train::trip> result;
+
+  if (!i.valid()) {
+    return result;
+  }
+
+  auto const to = std::upper_bound(
+      std::begin(by_departure_), std::end(by_departure_), i.end_,
+      [](auto&& t, auto&& e) { return t < e.interval_.start_; });
+
+  collect_overlapping(
+      *this, 1, 0, latest_arrival_.size() / 2,
+      static_cast<std::size_t>(std::distance(std::begin(by_departure_), to)),
+      i.start_, result);
+
+  return result;
+}
+
+std::span<trip_index::entry const> trip_index::trips(
+    train::id const train_id) const {
+  utl::verify(train_id + 1 < train_offsets_.size(),
+              "train id {} not in trip index", train_id);
+
+  return {train_trips_.data() + train_offsets_[train_id],
+          train_trips_.data() + train_offsets_[train_id + 1]};
+}
+
+std::span<trip_index::entry const> trip_index::overlapping(
+    train::id const train_id, interval const& i) const {
+  auto const all = trips(train_id);
+
+  if (!i.valid()) {
+    return {};
+  }
+
+  // all trips of a train have the same duration, so sorting by departure also
+  // sorts by arrival and the overlapping trips form a contiguous range
+  auto const from = std::lower_bound(
+      std::begin(all), std::end(all), i.start_,
+      [](auto&& e, auto&& t) { return e.interval_.end_ < t; });
+  auto const to = std::upper_bound(
+      from, std::end(all), i.end_,
+      [](auto&& t, auto&& e) { return t < e.interval_.start_; });
+
+  return {from, to};
+}
+
+soro::size_t trip_index::size() const noexcept {
+  return static_cast<soro::size_t>(by_departure_.size());
+}
+
+bool trip_index::empty() const noexcept { return by_departure_.empty(); }
+
+trip_index make_trip_index(soro::vector<train> const& trains) {
+  utl::scoped_timer const timer("creating trip index");
+
+  trip_index result;
+
+  result.train_offsets_.reserve(trains.size() + 1);
+  result.train_offsets_.emplace_back(0);
+
+  for (auto const& train : trains) {
+    utls::sassert(train.id_ + 1 == result.train_offsets_.size(),
+                  "train id {} does not match its position", train.id_);
+
+    for (auto const anchor : train.departures()) {
+      auto const ei = train.event_interval(anchor);
+
+      result.train_trips_.emplace_back(trip_index::entry{
+          .interval_ = ei,
+          .trip_ = train::trip{.train_id_ = train.id_, .anchor_ = anchor}});
+    }
+
+    result.train_offsets_.emplace_back(
+        static_cast<soro::size_t>(result.train_trips_.size()));
+  }
+
+  result.by_departure_ = result.train_trips_;
+  std::stable_sort(std::begin(result.by_departure_),
+                   std::end(result.by_departure_), [](auto&& e1, auto&& e2) {
+                     return e1.interval_.start_ < e2.interval_.start_;
+                   });
+
+  // leaves without a trip never reach into a query interval
+  auto const leaves = std::bit_ceil(std::max(
+      static_cast<std::size_t>(result.by_departure_.size()), std::size_t{1}));
+  result.latest_arrival_.resize(static_cast<soro::size_t>(2 * leaves),
+                                absolute_time::min());
+  for (auto i = 0U; i < result.by_departure_.size(); ++i) {
+    result.latest_arrival_[leaves + i] = result.by_departure_[i].interval_.end_;
+  }
+  for (auto node = leaves - 1; node > 0; --node) {
+    result.latest_arrival_[node] = std::max(
+        result.latest_arrival_[2 * node], result.latest_arrival_[2 * node + 1]);
+  }
+
+  return result;
+}
+
+}  // namespace soro::tt
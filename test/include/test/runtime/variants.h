@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "soro/timetable/timetable.h"
+
+namespace soro::runtime::test {
+
+// variants of the train using the compositions of the timetable that share
+// its freight flag, at most max_variants of those accepted by keep
+template <typename Keep>
+std::vector<tt::train> get_variants(tt::train const& t,
+                                    tt::timetable const& timetable,
+                                    std::size_t const max_variants,
+                                    Keep const& keep) {
+  auto const& compositions = timetable->compositions_;
+  std::vector<tt::train> variants;
+
+  for (auto id = 0U;
+       id < compositions.size() && variants.size() < max_variants; ++id) {
+    auto const& composition = compositions[id];
+    if (composition.freight() != t.freight()) {
+      continue;
+    }
+
+    auto variant = t;
+    variant.set_composition(id, composition);
+
+    if (keep(variant)) {
+      variants.emplace_back(std::move(variant));
+    }
+  }
+
+  return variants;
+}
+
+inline std::vector<tt::train> get_variants(tt::train const& t,
+                                           tt::timetable const& timetable,
+                                           std::size_t const max_variants) {
+  return get_variants(t, timetable, max_variants,
+                      [](tt::train const&) { return true; });
+}
+
+}  // namespace soro::runtime::test
@@ -5,7 +5,6 @@
 #include "fmt/format.h"
 #include "utl/enumerate.h"
 
-#include "soro/utls/coroutine/coro_map.h"
 #include "soro/utls/graph/traversal.h"
 #include "soro/utls/std_wrapper/contains_if.h"
 
@@ -101,10 +100,10 @@ void check_interlocking_routes(infrastructure const& infra) {
 void check_interlocking_route_lengths(infrastructure const& infra) {
   for (auto const& ir : infra->interlocking_.routes_) {
     auto const e1 = get_path_length_from_elements(
-        utls::coro_map(ir.iterate(infra), [](auto&& rn) { return rn.node_; }));
+        ir.iterate(infra), [](auto&& rn) { return rn.node_->element_; });
 
     auto const s1 = get_path_length_from_sections(
-        utls::coro_map(ir.iterate(infra), [](auto&& rn) { return rn.node_; }));
+        ir.iterate(infra), [](auto&& rn) { return rn.node_->element_; });
 
     CHECK_MESSAGE((e1 == s1),
                   "Different lengths from the two length calculation funs");
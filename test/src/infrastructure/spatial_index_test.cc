@@ -0,0 +1,131 @@
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/infrastructure/spatial_index.h"
+
+#include "test/file_paths.h"
+
+namespace soro::infra::test {
+
+using kind = spatial_index::kind;
+
+void check_elements(infrastructure const& infra) {
+  auto const& index = infra->spatial_;
+
+  std::size_t positioned = 0;
+  for (auto const e : infra->graph_.elements_) {
+    positioned += infra->element_positions_[e->id()].valid() ? 1 : 0;
+  }
+
+  auto const elements = std::ranges::count_if(
+      index.items_, [](auto&& item) { return item.kind_ == kind::ELEMENT; });
+  CHECK_EQ(static_cast<std::size_t>(elements), positioned);
+
+  for (auto leaf = 0U; leaf < index.size(); ++leaf) {
+    auto const& item = index.items_[leaf];
+    if (item.kind_ == kind::ELEMENT) {
+      CHECK(index.boxes_[leaf].contains(infra->element_positions_[item.id_]));
+    }
+  }
+}
+
+void check_tree(spatial_index const& index) {
+  REQUIRE_FALSE(index.level_ends_.empty());
+  CHECK_EQ(index.level_ends_.front(), index.size());
+  CHECK_EQ(index.level_ends_.back(), index.boxes_.size());
+
+  // the root covers every leaf
+  auto const& root = index.boxes_.back();
+  for (auto leaf = 0U; leaf < index.size(); ++leaf) {
+    CHECK(root.contains(index.boxes_[leaf].south_west_));
+    CHECK(root.contains(index.boxes_[leaf].north_east_));
+  }
+}
+
+void check_within(spatial_index const& index) {
+  auto const& root = index.boxes_.back();
+
+  auto const lon_mid = (root.south_west_.lon_ + root.north_east_.lon_) / 2;
+  auto const lat_mid = (root.south_west_.lat_ + root.north_east_.lat_) / 2;
+
+  auto south_west = root;
+  south_west.north_east_ = {.lon_ = lon_mid, .lat_ = lat_mid};
+
+  auto const only_stations = [](spatial_index::item const& item) {
+    return item.kind_ == kind::STATION;
+  };
+
+  for (auto const& viewport : {root, south_west}) {
+    std::vector<spatial_index::leaf> all;
+    std::vector<spatial_index::leaf> stations;
+    for (auto leaf = 0U; leaf < index.size(); ++leaf) {
+      if (index.boxes_[leaf].overlaps(viewport)) {
+        all.push_back(leaf);
+        if (only_stations(index.items_[leaf])) {
+          stations.push_back(leaf);
+        }
+      }
+    }
+
+    CHECK_EQ(index.within(viewport), all);
+    CHECK_EQ(index.within(viewport, only_stations), stations);
+  }
+
+  CHECK_EQ(index.within(root).size(), index.size());
+
+  auto const limit = std::min(index.size(), soro::size_t{3});
+  auto const limited = index.within(root, {}, limit);
+  CHECK_EQ(limited.size(), limit);
+  CHECK(std::ranges::is_sorted(limited));
+  CHECK(index.within(root, {}, 0).empty());
+}
+
+void check_nearest(spatial_index const& index) {
+  auto const& root = index.boxes_.back();
+
+  auto const is_element = [](spatial_index::item const& item) {
+    return item.kind_ == kind::ELEMENT;
+  };
+
+  // every element is its own nearest element
+  for (auto leaf = 0U; leaf < index.size(); leaf += 7) {
+    if (!is_element(index.items_[leaf])) {
+      continue;
+    }
+
+    auto const nearest =
+        index.nearest(index.boxes_[leaf].south_west_, 1, is_element);
+    REQUIRE_EQ(nearest.size(), 1);
+    CHECK_EQ(index.boxes_[nearest.front()].south_west_.lon_,
+             index.boxes_[leaf].south_west_.lon_);
+    CHECK_EQ(index.boxes_[nearest.front()].south_west_.lat_,
+             index.boxes_[leaf].south_west_.lat_);
+  }
+
+  auto const all = index.nearest(root.south_west_, index.size());
+  CHECK_EQ(all.size(), index.size());
+  CHECK(index.nearest(root.south_west_, 0).empty());
+}
+
+TEST_CASE("spatial index") {
+  for (auto const& infra : soro::test::get_infrastructure_scenarios()) {
+    auto const& index = (*infra)->spatial_;
+
+    if ((*infra)->element_positions_.empty()) {
+      CHECK(index.empty());
+      continue;
+    }
+
+    REQUIRE_FALSE(index.empty());
+
+    check_elements(*infra);
+    check_tree(index);
+    check_within(index);
+    check_nearest(index);
+  }
+}
+
+}  // namespace soro::infra::test
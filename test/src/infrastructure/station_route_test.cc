@@ -2,7 +2,7 @@
 
 #include "doctest/doctest.h"
 
-#include "soro/utls/coroutine/collect.h"
+#include <vector>
 
 #include "soro/infrastructure/path/length.h"
 
@@ -37,8 +37,10 @@ void check_station_route_members(station_route::ptr const sr) {
 }
 
 void check_station_route_iteration(station_route::ptr const sr) {
-  auto no_skipped_nodes = utls::collect<std::vector<node::ptr>>(
-      utls::coro_map(sr->iterate(), [](auto&& rn) { return rn.node_; }));
+  std::vector<node::ptr> no_skipped_nodes;
+  for (auto const& rn : sr->iterate()) {
+    no_skipped_nodes.emplace_back(rn.node_);
+  }
 
   CHECK_EQ(no_skipped_nodes.size(), sr->size());
 }
@@ -46,13 +48,13 @@ void check_station_route_iteration(station_route::ptr const sr) {
 void check_station_route_length(station_route::ptr const sr) {
   auto const e1 = get_path_length_from_elements(sr->nodes());
   auto const e2 = get_path_length_from_elements(
-      utls::coro_map(sr->iterate(), [](auto&& rn) { return rn.node_; }));
+      sr->iterate(), [](auto&& rn) { return rn.node_->element_; });
 
   CHECK_EQ(e1, e2);
 
   auto const s1 = get_path_length_from_sections(sr->nodes());
   auto const s2 = get_path_length_from_sections(
-      utls::coro_map(sr->iterate(), [](auto&& rn) { return rn.node_; }));
+      sr->iterate(), [](auto&& rn) { return rn.node_->element_; });
 
   CHECK_EQ(s1, s2);
 
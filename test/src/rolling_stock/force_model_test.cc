@@ -0,0 +1,113 @@
+#include "doctest/doctest.h"
+
+#include "utl/enumerate.h"
+
+#include "soro/base/fp_precision.h"
+#include "soro/si/constants.h"
+
+#include "soro/rolling_stock/force_model.h"
+
+namespace soro::rs::test {
+
+using namespace soro::utls;
+
+traction_vehicle make_vehicle(double const factor, si::speed const split,
+                              si::speed const end) {
+  auto const p1 = make_polynomial(tractive_force_3_t{-1.0 * factor},
+                                  tractive_force_2_t{2.0 * factor},
+                                  tractive_force_1_t{1000.0 * factor});
+  auto const p2 = make_polynomial(tractive_force_3_t{-0.5 * factor},
+                                  tractive_force_2_t{1.0 * factor},
+                                  tractive_force_1_t{800.0 * factor});
+
+  traction_vehicle tv;
+  tv.weight_ = si::from_ton(80.0);
+  tv.max_speed_ = end;
+  tv.tractive_curve_ = make_piecewise(make_piece(p1, si::speed{0.0}, split),
+                                      make_piece(p2, split, end));
+  tv.resistance_curve_ = make_polynomial(
+      drag_coefficient_t{0.01 * factor}, dampening_resistance_t{0.2 * factor},
+      rolling_resistance_t{50.0 * factor});
+
+  return tv;
+}
+
+TEST_CASE("force model equals summed vehicle curves") {
+  soro::vector<traction_vehicle> vehicles;
+  vehicles.emplace_back(
+      make_vehicle(1.0, si::from_m_s(20.0), si::from_m_s(50.0)));
+  vehicles.emplace_back(
+      make_vehicle(1.5, si::from_m_s(30.0), si::from_m_s(40.0)));
+
+  auto const weight = si::from_ton(400.0);
+  auto const model = make_force_model(vehicles, weight, si::from_m_s(45.0));
+
+  CHECK_EQ(model.bounds_.size(), std::size_t{3});
+  CHECK_EQ(model.max_speed_, si::from_m_s(40.0));
+
+  std::vector<si::speed> speeds;
+  for (auto v = 0.0; v < 40.0; v += 0.25) {
+    speeds.emplace_back(si::from_m_s(v));
+  }
+
+  std::vector<si::acceleration> accelerations(speeds.size());
+  model.acceleration(speeds, accelerations);
+
+  for (auto const [idx, v] : utl::enumerate(speeds)) {
+    auto tractive = si::ZERO<si::force>;
+    auto resistive = si::ZERO<si::force>;
+
+    for (auto const& vehicle : vehicles) {
+      tractive += vehicle.tractive_curve_(v);
+      resistive += vehicle.resistance_curve_(v);
+    }
+
+    auto const acceleration =
+        (tractive - resistive) / (weight * si::MASS_FACTOR);
+
+    CHECK(equal(model.tractive_force(v).val_, tractive.val_));
+    CHECK(equal(model.resistive_force(v).val_, resistive.val_));
+    CHECK(equal(model.acceleration(v).val_, acceleration.val_));
+    CHECK(equal(accelerations[idx].val_, acceleration.val_));
+  }
+}
+
+TEST_CASE("force model out of bounds throws") {
+  soro::vector<traction_vehicle> vehicles;
+  vehicles.emplace_back(
+      make_vehicle(1.0, si::from_m_s(20.0), si::from_m_s(50.0)));
+
+  auto const model =
+      make_force_model(vehicles, si::from_ton(400.0), si::from_m_s(50.0));
+
+  CHECK_THROWS(model.acceleration(si::from_m_s(50.0)));
+
+  std::vector<si::speed> const speeds{si::from_m_s(10.0), si::from_m_s(50.0)};
+  std::vector<si::acceleration> accelerations(speeds.size());
+  CHECK_THROWS(model.acceleration(speeds, accelerations));
+  CHECK_THROWS(model.acceleration(speeds, std::span{accelerations}.first(1)));
+}
+
+TEST_CASE("force model batch acceleration in any order") {
+  soro::vector<traction_vehicle> vehicles;
+  vehicles.emplace_back(
+      make_vehicle(1.0, si::from_m_s(20.0), si::from_m_s(50.0)));
+  vehicles.emplace_back(
+      make_vehicle(1.5, si::from_m_s(30.0), si::from_m_s(40.0)));
+
+  auto const model =
+      make_force_model(vehicles, si::from_ton(400.0), si::from_m_s(45.0));
+
+  std::vector<si::speed> const speeds{
+      si::from_m_s(35.0), si::from_m_s(5.0),  si::from_m_s(25.0),
+      si::from_m_s(5.5),  si::from_m_s(39.9), si::from_m_s(0.0)};
+
+  std::vector<si::acceleration> accelerations(speeds.size());
+  model.acceleration(speeds, accelerations);
+
+  for (auto const [idx, v] : utl::enumerate(speeds)) {
+    CHECK(equal(accelerations[idx].val_, model.acceleration(v).val_));
+  }
+}
+
+}  // namespace soro::rs::test
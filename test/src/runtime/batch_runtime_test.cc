@@ -0,0 +1,81 @@
+#include "doctest/doctest.h"
+
+#include "soro/runtime/batch_runtime.h"
+
+#include "test/file_paths.h"
+#include "test/runtime/variants.h"
+
+namespace soro::runtime::test {
+
+using namespace soro::tt;
+using namespace soro::infra;
+
+// the running time calculation is done in whole seconds
+constexpr auto const TOLERANCE = duration2{1};
+
+// only keeps variants the scalar calculation accepts
+std::vector<train> get_runnable_variants(train const& t, timetable const& tt,
+                                         infrastructure const& infra,
+                                         type_set const& record_types,
+                                         std::size_t const max_variants) {
+  return get_variants(t, tt, max_variants, [&](train const& variant) {
+    try {
+      std::ignore = runtime_calculation(variant, variant.physics(*tt), infra,
+                                        record_types);
+    } catch (std::exception const&) {
+      return false;
+    }
+
+    return true;
+  });
+}
+
+void check_within_tolerance(timestamps const& batch, timestamps const& scalar) {
+  REQUIRE_EQ(batch.times_.size(), scalar.times_.size());
+  CHECK_EQ(batch.halt_indices_, scalar.halt_indices_);
+
+  for (auto idx = 0U; idx < batch.times_.size(); ++idx) {
+    auto const& b = batch.times_[idx];
+    auto const& s = scalar.times_[idx];
+
+    CHECK_EQ(b.element_, s.element_);
+    CHECK_LE(std::chrono::abs(b.arrival_ - s.arrival_), TOLERANCE);
+    CHECK_LE(std::chrono::abs(b.departure_ - s.departure_), TOLERANCE);
+  }
+}
+
+TEST_CASE("batch runtime equals scalar runtime") {
+  type_set const record_types({type::HALT, type::MAIN_SIGNAL, type::EOTD});
+
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    auto const& infra = *scenario->infra_;
+    auto const& tt = scenario->timetable_;
+
+    for (auto const& train : tt->trains_) {
+      // more variants than lanes, to also cover a partially filled batch
+      auto const variants = get_runnable_variants(
+          train, tt, infra, record_types, BATCH_LANES + 3);
+
+      auto const batch =
+          batch_runtime_calculation(variants, *tt, infra, record_types);
+      REQUIRE_EQ(batch.size(), variants.size());
+
+      for (auto idx = 0U; idx < variants.size(); ++idx) {
+        auto const& variant = variants[idx];
+        check_within_tolerance(
+            batch[idx], runtime_calculation(variant, variant.physics(*tt),
+                                            infra, record_types));
+      }
+    }
+  }
+}
+
+TEST_CASE("batch runtime, no variants") {
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    CHECK(batch_runtime_calculation({}, *scenario->timetable_,
+                                    *scenario->infra_, {type::HALT})
+              .empty());
+  }
+}
+
+}  // namespace soro::runtime::test
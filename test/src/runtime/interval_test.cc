@@ -15,7 +15,8 @@ void check_interval_list(infrastructure const& infra, timetable const& tt) {
   for (auto const& train : tt->trains_) {
     type_set const event_types({type::HALT, type::EOTD, type::MAIN_SIGNAL});
 
-    auto const& intervals = get_interval_list(train, event_types, infra);
+    auto const& intervals =
+        get_interval_list(train, train.physics(*tt), event_types, infra);
 
     CHECK_MESSAGE(
         (intervals.back().distance_ == train.path_length(infra)),
@@ -99,4 +100,61 @@ TEST_CASE("interval") {
   for (auto const& scenario : soro::test::get_timetable_scenarios()) {
     check_interval_list(*scenario->infra_, scenario->timetable_);
   }
-}
\ No newline at end of file
+}
+void check_equal(interval_list const& l1, interval_list const& l2) {
+  REQUIRE_EQ(l1.size(), l2.size());
+
+  for (auto idx = 0U; idx < l1.size(); ++idx) {
+    auto const& i1 = l1[idx];
+    auto const& i2 = l2[idx];
+
+    CHECK_EQ(i1.distance_, i2.distance_);
+    CHECK_EQ(i1.limit_left_, i2.limit_left_);
+    CHECK_EQ(i1.limit_right_, i2.limit_right_);
+
+    REQUIRE_EQ(i1.is_halt(), i2.is_halt());
+    if (i1.is_halt()) {
+      CHECK_EQ(i1.departure(), i2.departure());
+      CHECK_EQ(i1.min_stop_time(), i2.min_stop_time());
+    }
+
+    REQUIRE_EQ(i1.events_.size(), i2.events_.size());
+    for (auto e_idx = 0U; e_idx < i1.events_.size(); ++e_idx) {
+      CHECK_EQ(i1.events_[e_idx].node_, i2.events_[e_idx].node_);
+      CHECK_EQ(i1.events_[e_idx].distance_, i2.events_[e_idx].distance_);
+    }
+  }
+}
+
+TEST_CASE("interval cache") {
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    type_set const event_types({type::HALT, type::EOTD, type::MAIN_SIGNAL});
+
+    interval_cache cache;
+
+    auto const& tt = scenario->timetable_;
+    for (auto const& train : tt->trains_) {
+      auto const& physics = train.physics(*tt);
+      auto const cached =
+          cache.get(train, physics, event_types, *scenario->infra_);
+      auto const uncached =
+          get_interval_list(train, physics, event_types, *scenario->infra_);
+
+      check_equal(cached, uncached);
+
+      // the sequence points are bound to the train, not to the geometry
+      for (auto const& interval : cached) {
+        if (interval.is_halt()) {
+          CHECK_GE(&**interval.sequence_point_, train.sequence_points_.data());
+          CHECK_LT(&**interval.sequence_point_,
+                   train.sequence_points_.data() +
+                       train.sequence_points_.size());
+        }
+      }
+    }
+
+    CHECK_EQ(cache.hits_.load() + cache.misses_.load(),
+             scenario->timetable_->trains_.size());
+    CHECK_EQ(cache.cache_.size(), cache.misses_.load());
+  }
+}
@@ -75,7 +75,8 @@ void check_delays(infrastructure const& infra, timetable const& tt) {
   auto avg_delay = duration2::zero();
 
   for (auto const& train : tt->trains_) {
-    auto const timestamps = runtime_calculation(train, infra, {type::HALT});
+    auto const timestamps =
+        runtime_calculation(train, train.physics(*tt), infra, {type::HALT});
 
     if (timestamps.times_.empty()) {
       continue;
@@ -159,7 +160,8 @@ void test_event_existance_in_timestamps(train const& tr, timestamps const& ts,
 void check_runtime_with_events(infrastructure const& infra, timetable const& tt,
                                type_set const& record_events) {
   for (auto const& train : tt->trains_) {
-    auto const timestamps = runtime_calculation(train, infra, record_events);
+    auto const timestamps =
+        runtime_calculation(train, train.physics(*tt), infra, record_events);
 
     if (record_events.contains(type::HALT)) {
       check_halt_count(train, timestamps);
@@ -187,4 +189,33 @@ TEST_CASE("runtime") {
   }
 }
 
+// the profiles reach every distance in the step the materialized results do
+template <typename Profile>
+void check_profile(Profile const& profile, runtime_results const& results) {
+  REQUIRE_EQ(profile.steps_ + 1, results.size());
+  CHECK_EQ(profile.last().time_, results.back().time_);
+  CHECK_EQ(profile.last().distance_, results.back().distance_);
+  CHECK_EQ(profile.last().speed_, results.back().speed_);
+
+  for (auto const& result : results) {
+    auto const reached =
+        profile.reaching(si::ZERO<si::length>, result.distance_);
+    REQUIRE(reached.has_value());
+    CHECK_LE(*reached, result.time_);
+  }
+}
+
+TEST_CASE("runtime physics, profiles equal the materialized results") {
+  for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+    for (auto const& composition : scenario->timetable_->compositions_) {
+      auto const max_speed = composition.max_speed();
+
+      check_profile(brake_profile{composition, max_speed, si::ZERO<si::speed>},
+                    brake(composition, max_speed, si::ZERO<si::speed>));
+      check_profile(coast_profile{max_speed, si::from_m(1000.0)},
+                    coast(max_speed, si::from_m(1000.0)));
+    }
+  }
+}
+
 }  // namespace soro::runtime::test
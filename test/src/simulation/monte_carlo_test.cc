@@ -0,0 +1,296 @@
+#include "doctest/doctest.h"
+
+#include <algorithm>
+
+#include "soro/utls/std_wrapper/contains.h"
+
+#include "soro/simulation/monte_carlo.h"
+
+#include "test/file_paths.h"
+
+namespace soro::simulation::test {
+
+using namespace soro::tt;
+using namespace soro::infra;
+
+void check_result(monte_carlo_result const& result,
+                  monte_carlo_model const& model, ordering_graph const& og) {
+  REQUIRE_EQ(result.quantiles_.size(),
+             og.nodes_.size() * result.levels_.size());
+  REQUIRE_EQ(result.mean_delay_.size(), og.nodes_.size());
+
+  for (auto const& node : og.nodes_) {
+    auto const quantiles = result.quantiles(node.id_);
+
+    CHECK_GE(quantiles.front(), duration2::zero());
+    CHECK(std::is_sorted(std::begin(quantiles), std::end(quantiles)));
+    CHECK_GE(result.mean_delay_[node.id_], 0.0);
+
+    // a train is never earlier at a later node of its trip
+    for (auto const out : node.out_) {
+      auto const& succ = og.nodes_[out];
+      if (succ.train_id_ == node.train_id_) {
+        CHECK_LE(result.arrival(model, node.id_, 0),
+                 result.arrival(model, succ.id_, 0));
+      }
+    }
+  }
+}
+
+TEST_SUITE("monte carlo") {
+
+  TEST_CASE("delay distributions are normalized") {
+    for (auto const& dist : {make_halt_delay_distribution(),
+                             make_runtime_delay_distribution()}) {
+      REQUIRE(!dist.cdf_.empty());
+      CHECK_EQ(dist.delays_.size(), dist.cdf_.size());
+      CHECK(std::is_sorted(std::begin(dist.cdf_), std::end(dist.cdf_)));
+      CHECK(std::is_sorted(std::begin(dist.delays_), std::end(dist.delays_)));
+      CHECK_EQ(dist.cdf_.back(), doctest::Approx(1.0));
+
+      CHECK_EQ(dist.sample(0.0), dist.delays_.front());
+      CHECK_EQ(dist.sample(0.999999999), dist.delays_.back());
+    }
+  }
+
+  TEST_CASE("monte carlo, follow") {
+    auto opts = soro::test::SMALL_OPTS;
+    opts.exclusions_ = true;
+    opts.interlocking_ = true;
+    opts.exclusion_graph_ = false;
+    opts.layout_ = false;
+
+    infrastructure const infra(opts);
+    timetable const tt(soro::test::FOLLOW_OPTS, infra);
+    ordering_graph const og(infra, tt);
+
+    auto const model = make_monte_carlo_model(og, infra, tt);
+    REQUIRE_EQ(model.nodes_.size(), og.nodes_.size());
+    REQUIRE_EQ(model.topological_order_.size(), og.nodes_.size());
+
+    for (auto const& node : model.nodes_) {
+      CHECK_LE(node.scheduled_start_, node.scheduled_end_);
+    }
+
+    monte_carlo_options mc_opts;
+    mc_opts.replications_ = 500;
+
+    auto const result = simulate_monte_carlo(model, og, mc_opts);
+    check_result(result, model, og);
+
+    SUBCASE("results do not depend on the block size") {
+      auto other_opts = mc_opts;
+      other_opts.block_size_ = 7;
+
+      auto const other = simulate_monte_carlo(model, og, other_opts);
+
+      CHECK_EQ(result.quantiles_, other.quantiles_);
+      CHECK_EQ(result.mean_delay_, other.mean_delay_);
+    }
+
+    SUBCASE("statistics of selected nodes only") {
+      std::vector<ordering_node::id> const nodes{
+          0, static_cast<ordering_node::id>(og.nodes_.size() - 1)};
+
+      auto const selected =
+          simulate_monte_carlo(model, og, mc_opts, disruption{}, nodes);
+
+      for (auto const id : nodes) {
+        CHECK(std::ranges::equal(selected.quantiles(id), result.quantiles(id)));
+        CHECK_EQ(selected.mean_delay_[id], result.mean_delay_[id]);
+      }
+    }
+
+    SUBCASE("the seed changes the samples") {
+      auto other_opts = mc_opts;
+      other_opts.seed_ = 42;
+
+      auto const other = simulate_monte_carlo(model, og, other_opts);
+      check_result(other, model, og);
+      CHECK_NE(result.mean_delay_, other.mean_delay_);
+    }
+
+    SUBCASE("without distributions every replication is the same") {
+      auto other_opts = mc_opts;
+      other_opts.distributions_.enable_halt_dists_ = enable_halt_dists::Off;
+      other_opts.distributions_.enable_runtime_dists_ =
+          enable_runtime_dists::Off;
+      other_opts.bin_width_ = duration2{1};
+
+      auto const other = simulate_monte_carlo(model, og, other_opts);
+      check_result(other, model, og);
+
+      for (auto const& node : og.nodes_) {
+        auto const quantiles = other.quantiles(node.id_);
+        CHECK_EQ(quantiles.front(), quantiles.back());
+        CHECK_EQ(other.mean_delay_[node.id_],
+                 doctest::Approx(quantiles.front().count()));
+      }
+    }
+
+    SUBCASE("invalid disruptions are rejected") {
+      disruption unknown_node;
+      unknown_node.delays_.push_back(
+          {.node_ = static_cast<ordering_node::id>(og.nodes_.size()),
+           .extra_ = duration2{60}});
+      CHECK_THROWS(std::ignore =
+                       simulate_monte_carlo(model, og, mc_opts, unknown_node));
+
+      auto const node = std::ranges::find_if(og.nodes_, [&](auto&& n) {
+        return std::ranges::any_of(n.out_, [&](auto&& out) {
+          return og.nodes_[out].train_id_ != n.train_id_;
+        });
+      });
+      REQUIRE_NE(node, std::end(og.nodes_));
+
+      auto const other = *std::ranges::find_if(node->out_, [&](auto&& out) {
+        return og.nodes_[out].train_id_ != node->train_id_;
+      });
+
+      // the edge only exists the other way around
+      disruption missing_edge;
+      missing_edge.reversed_orders_.emplace_back(other, node->id_);
+      CHECK_THROWS(std::ignore =
+                       simulate_monte_carlo(model, og, mc_opts, missing_edge));
+    }
+  }
+
+  TEST_CASE("monte carlo, early nodes count as on time") {
+    auto opts = soro::test::SMALL_OPTS;
+    opts.exclusions_ = true;
+    opts.interlocking_ = true;
+    opts.exclusion_graph_ = false;
+    opts.layout_ = false;
+
+    infrastructure const infra(opts);
+    timetable const tt(soro::test::FOLLOW_OPTS, infra);
+    ordering_graph const og(infra, tt);
+
+    auto const model = make_monte_carlo_model(og, infra, tt);
+
+    monte_carlo_options mc_opts;
+    mc_opts.replications_ = 50;
+    mc_opts.distributions_.enable_halt_dists_ = enable_halt_dists::Off;
+    mc_opts.distributions_.enable_runtime_dists_ = enable_runtime_dists::Off;
+
+    auto const first_trip = og.trip_to_nodes_.begin()->first;
+    auto const first_node = og.trip_nodes(first_trip).front();
+
+    disruption early;
+    early.delays_.push_back(
+        {.node_ = first_node.id_, .extra_ = duration2{-600}});
+
+    auto const result = simulate_monte_carlo(model, og, mc_opts, early);
+    check_result(result, model, og);
+
+    CHECK_EQ(result.mean_delay_[first_node.id_], 0.0);
+    CHECK_EQ(result.quantiles(first_node.id_).back(), duration2::zero());
+  }
+
+  TEST_CASE("monte carlo, incremental") {
+    auto opts = soro::test::SMALL_OPTS;
+    opts.exclusions_ = true;
+    opts.interlocking_ = true;
+    opts.exclusion_graph_ = false;
+    opts.layout_ = false;
+
+    infrastructure const infra(opts);
+    timetable const tt(soro::test::FOLLOW_OPTS, infra);
+    ordering_graph const og(infra, tt);
+
+    auto const model = make_monte_carlo_model(og, infra, tt);
+
+    monte_carlo_options mc_opts;
+    mc_opts.replications_ = 200;
+
+    auto const first_trip = og.trip_to_nodes_.begin()->first;
+    auto const first_node = og.trip_nodes(first_trip).front();
+
+    disruption late_departure;
+    late_departure.delays_.push_back(
+        {.node_ = first_node.id_, .extra_ = duration2{600}});
+
+    disruption closure;
+    closure.closures_.push_back(
+        {.ir_ = first_node.ir_id_,
+         .closed_ = {.start_ = model.nodes_[first_node.id_].scheduled_start_,
+                     .end_ = model.nodes_[first_node.id_].scheduled_start_ +
+                             minutes{20}}});
+
+    auto state = make_monte_carlo_state(model, og, mc_opts);
+
+    // the state keeps the same statistics as the plain simulation
+    auto const plain = simulate_monte_carlo(model, og, mc_opts);
+    CHECK_EQ(state.result_.quantiles_, plain.quantiles_);
+    CHECK_EQ(state.result_.mean_delay_, plain.mean_delay_);
+
+    SUBCASE("late departure") {
+      auto const changed = resimulate(state, model, og, late_departure);
+      CHECK(!changed.empty());
+      CHECK(utls::contains(changed, first_node.id_));
+
+      auto const full =
+          make_monte_carlo_state(model, og, mc_opts, late_departure);
+      CHECK_EQ(state.ends_, full.ends_);
+      CHECK_EQ(state.result_.quantiles_, full.result_.quantiles_);
+      CHECK_EQ(state.result_.mean_delay_, full.result_.mean_delay_);
+    }
+
+    SUBCASE("late departure and closure, one after another") {
+      std::ignore = resimulate(state, model, og, late_departure);
+      std::ignore = resimulate(state, model, og, closure);
+
+      disruption both = late_departure;
+      both.closures_ = closure.closures_;
+
+      auto const full = make_monte_carlo_state(model, og, mc_opts, both);
+      CHECK_EQ(state.ends_, full.ends_);
+      CHECK_EQ(state.result_.quantiles_, full.result_.quantiles_);
+    }
+
+    SUBCASE("order reversed and restored, one after another") {
+      auto const node = std::ranges::find_if(og.nodes_, [&](auto&& n) {
+        return std::ranges::any_of(n.out_, [&](auto&& out) {
+          return og.nodes_[out].train_id_ != n.train_id_;
+        });
+      });
+      REQUIRE_NE(node, std::end(og.nodes_));
+
+      auto const other = *std::ranges::find_if(node->out_, [&](auto&& out) {
+        return og.nodes_[out].train_id_ != node->train_id_;
+      });
+
+      disruption reversed;
+      reversed.reversed_orders_.emplace_back(node->id_, other);
+
+      disruption restored;
+      restored.reversed_orders_.emplace_back(other, node->id_);
+
+      std::ignore = resimulate(state, model, og, reversed);
+      std::ignore = resimulate(state, model, og, restored);
+
+      CHECK_EQ(state.ends_, make_monte_carlo_state(model, og, mc_opts).ends_);
+      CHECK_EQ(state.result_.quantiles_, plain.quantiles_);
+      CHECK_EQ(state.result_.mean_delay_, plain.mean_delay_);
+    }
+
+    SUBCASE("invalid disruptions leave the state as it is") {
+      disruption unknown_node = late_departure;
+      unknown_node.delays_.push_back(
+          {.node_ = static_cast<ordering_node::id>(og.nodes_.size()),
+           .extra_ = duration2{60}});
+
+      CHECK_THROWS(std::ignore = resimulate(state, model, og, unknown_node));
+      CHECK(state.disruption_.empty());
+      CHECK_EQ(state.result_.quantiles_, plain.quantiles_);
+      CHECK_EQ(state.ends_, make_monte_carlo_state(model, og, mc_opts).ends_);
+    }
+
+    SUBCASE("empty disruption changes nothing") {
+      CHECK(resimulate(state, model, og, disruption{}).empty());
+      CHECK_EQ(state.result_.quantiles_, plain.quantiles_);
+    }
+  }
+}
+
+}  // namespace soro::simulation::test
@@ -0,0 +1,90 @@
+#include "doctest/doctest.h"
+
+#include <sstream>
+
+#include "utl/erase_duplicates.h"
+
+#include "soro/simulation/scenario_batch.h"
+
+#include "test/file_paths.h"
+
+namespace soro::simulation::test {
+
+using namespace soro::tt;
+using namespace soro::infra;
+
+TEST_CASE("scenario batch, follow") {
+  auto opts = soro::test::SMALL_OPTS;
+  opts.exclusions_ = true;
+  opts.interlocking_ = true;
+  opts.exclusion_graph_ = false;
+  opts.layout_ = false;
+
+  infrastructure const infra(opts);
+  timetable const tt(soro::test::FOLLOW_OPTS, infra);
+
+  monte_carlo_options mc_opts;
+  mc_opts.replications_ = 200;
+
+  scenario_batch const batch(infra, tt, {}, mc_opts);
+  REQUIRE_EQ(batch.trips_.size(), 2);
+
+  auto const& og = batch.og_;
+  auto const first = og.trip_nodes(batch.trips_.front());
+
+  // the train of the first trip departs late
+  scenario late{.name_ = "late"};
+  late.disruption_.delays_.push_back(
+      {.node_ = first.front().id_, .extra_ = duration2{900}});
+
+  // the train of the second trip uses every contested route first
+  scenario swapped{.name_ = "swapped"};
+  for (auto const& node : first) {
+    for (auto const out : node.out_) {
+      if (og.nodes_[out].train_id_ != node.train_id_) {
+        swapped.disruption_.reversed_orders_.emplace_back(node.id_, out);
+      }
+    }
+  }
+  utl::erase_duplicates(swapped.disruption_.reversed_orders_);
+
+  std::vector<scenario> const scenarios = {scenario{.name_ = "baseline"}, late,
+                                           swapped};
+
+  auto const table = batch.run(scenarios);
+
+  REQUIRE_EQ(table.scenarios_.size(), scenarios.size());
+  REQUIRE_EQ(table.quantiles_.size(),
+             scenarios.size() * batch.trips_.size() * table.levels_.size());
+  REQUIRE_EQ(table.mean_delay_.size(), scenarios.size() * batch.trips_.size());
+
+  // the baseline equals a plain simulation of the shared model
+  auto const plain = simulate_monte_carlo(batch.model_, og, mc_opts);
+  for (auto t = 0U; t < batch.trips_.size(); ++t) {
+    auto const end = batch.trip_ends_[t];
+    auto const expected = plain.quantiles(end);
+    auto const actual = table.quantiles(0, t);
+
+    CHECK(std::equal(std::begin(expected), std::end(expected),
+                     std::begin(actual), std::end(actual)));
+    CHECK_EQ(table.mean_delay(0, t), plain.mean_delay_[end]);
+  }
+
+  // delaying a train never makes any trip earlier
+  for (auto t = 0U; t < batch.trips_.size(); ++t) {
+    CHECK_GE(table.mean_delay(1, t), table.mean_delay(0, t));
+  }
+  CHECK_GE(table.mean_delay(1, 0), table.mean_delay(0, 0) + 900.0);
+
+  std::stringstream ss;
+  table.write_csv(ss);
+
+  std::string line;
+  std::size_t lines = 0;
+  while (std::getline(ss, line)) {
+    ++lines;
+  }
+  CHECK_EQ(lines, 1 + scenarios.size() * batch.trips_.size());
+}
+
+}  // namespace soro::simulation::test
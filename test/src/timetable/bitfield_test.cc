@@ -1,5 +1,7 @@
 #include "doctest/doctest.h"
 
+#include <algorithm>
+
 #include "soro/utls/std_wrapper/count.h"
 
 #include "soro/timetable/bitfield.h"
@@ -353,6 +355,90 @@ TEST_SUITE("bitfield") {
     CHECK_EQ(bf, expected_result);
   }
 
+  TEST_CASE("iterate across block boundaries") {
+    bitfield::anchor_time const s = 2022_y / January / 1;
+    bitfield::anchor_time const t = s + soro::days{299};
+
+    std::vector<std::size_t> const set_idxs = {1, 63, 64, 127, 128, 200, 298};
+
+    std::string bits(300, '0');
+    for (auto const idx : set_idxs) {
+      bits[idx] = '1';
+    }
+
+    auto const bf = make_bitfield(s, t, bits.data());
+
+    std::vector<bitfield::anchor_time> expected;
+    for (auto const idx : set_idxs) {
+      expected.emplace_back(s + soro::days{idx});
+    }
+
+    std::vector<bitfield::anchor_time> iterated;
+    for (auto const day : bf) {
+      iterated.emplace_back(day);
+    }
+
+    CHECK_EQ(iterated, expected);
+    CHECK_EQ(bf.get_set_days(), expected);
+    CHECK_EQ(bf.first_set_date(), absolute_time{expected.front()});
+    CHECK_EQ(bf.last_set_date(), absolute_time{expected.back()});
+
+    for (auto from = 0U; from < 300U; from += 7U) {
+      for (auto to = from; to < 300U; to += 13U) {
+        auto const expected_count = static_cast<soro::size_t>(
+            std::count_if(std::begin(set_idxs), std::end(set_idxs),
+                          [&](auto&& idx) { return from <= idx && idx <= to; }));
+
+        CHECK_EQ(bf.count(s + soro::days{from}, s + soro::days{to}),
+                 expected_count);
+      }
+    }
+
+    CHECK_EQ(bf.count(s - soro::days{10}, t + soro::days{10}), bf.count());
+    CHECK_EQ(bf.count(t + soro::days{1}, t + soro::days{10}), 0U);
+  }
+
+  TEST_CASE("operator &= different first and last date") {
+    year_month_day const s1 = 2022_y / February / 22;
+    year_month_day const t1 = 2022_y / March / 2;
+
+    year_month_day const s2 = 2022_y / February / 26;
+    year_month_day const t2 = 2022_y / March / 6;
+
+    auto const bf1 = make_bitfield(s1, t1, "111111011");
+    auto const bf2 = make_bitfield(s2, t2, "101111111");
+
+    auto const result1 = bf1 & bf2;
+    CHECK_EQ(result1.first_date_, bf1.first_date_);
+    CHECK_EQ(result1.last_date_, bf1.last_date_);
+    CHECK_EQ(result1, make_bitfield(s1, t1, "000010011"));
+
+    auto const result2 = bf2 & bf1;
+    CHECK_EQ(result2, make_bitfield(s2, t2, "100110000"));
+
+    auto const disjoint = make_bitfield(2022_y / April / 1,
+                                        2022_y / April / 3, "111");
+    CHECK_EQ((bf1 & disjoint).count(), 0U);
+  }
+
+  TEST_CASE("shifted") {
+    year_month_day const s = 2022_y / February / 22;
+    year_month_day const t = 2022_y / March / 2;
+
+    auto const bf = make_bitfield(s, t, "101010101");
+    auto const next_day = bf.shifted(date::days{1});
+
+    CHECK_EQ(next_day.count(), bf.count());
+    CHECK_EQ(next_day.get_set_days().front(),
+             bitfield::anchor_time{s} + date::days{1});
+
+    for (auto const day : bf) {
+      CHECK(next_day[day + date::days{1}]);
+    }
+
+    CHECK_EQ(next_day.shifted(date::days{-1}), bf);
+  }
+
 #if !(defined(NDEBUG) || defined(SORO_SAN))
   TEST_CASE("construct bitfield throws - end before start") {
     year_month_day const s = 2022_y / February / 22;
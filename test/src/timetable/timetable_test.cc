@@ -4,8 +4,6 @@
 #include "range/v3/view/filter.hpp"
 #include "range/v3/view/transform.hpp"
 
-#include "soro/utls/coroutine/coro_map.h"
-
 #include "soro/infrastructure/infrastructure.h"
 #include "soro/infrastructure/path/length.h"
 #include "soro/timetable/timetable.h"
@@ -32,7 +30,7 @@ void check_no_invalids(train const& train) {
 
 void check_train_path_length(train const& train, infrastructure const& infra) {
   auto const e1 = get_path_length_from_elements(
-      utls::coro_map(train.iterate(infra), [](auto&& rn) { return rn.node_; }));
+      train.iterate(infra), [](auto&& rn) { return rn.node_->element_; });
 
   CHECK_MESSAGE((train.length_ == e1),
                 "Different lengths from the two length calculation funs");
@@ -125,11 +123,24 @@ void check_train(train const& train, infrastructure const& infra) {
   do_train_iterator_tests(train, infra);
 }
 
+void check_compositions(timetable const& tt) {
+  CHECK_LE(tt->compositions_.size(), tt->trains_.size());
+
+  for (auto const& train : tt->trains_) {
+    REQUIRE_LT(train.composition_, tt->compositions_.size());
+    CHECK_EQ(&train.physics(*tt), &tt->compositions_[train.composition_]);
+    CHECK_EQ(train.freight(), train.physics(*tt).freight());
+    CHECK_EQ(train.ctc(), train.physics(*tt).ctc());
+  }
+}
+
 void check_timetable(timetable const& tt, infrastructure const& infra) {
   for (auto const& train : tt->trains_) {
     check_train(train, infra);
   }
 
+  check_compositions(tt);
+
   soro::test::utls::check_continuous_ascending_ids(tt->trains_);
 }
 
@@ -151,4 +162,22 @@ TEST_CASE("timetable test") {
   }
 }
 
+TEST_CASE("timetable test, composition ids do not depend on parsing order") {
+  for (auto const& opts : soro::test::ALL_TIMETABLE_SCENARIO_OPTS) {
+    if (!opts.exists()) {
+      continue;
+    }
+
+    auto const& scenario = soro::test::get_timetable_scenario(opts);
+    auto const& tt = scenario.timetable_;
+    timetable const reparsed(opts.timetable_opts_, *scenario.infra_);
+
+    REQUIRE_EQ(tt->trains_.size(), reparsed->trains_.size());
+    REQUIRE_EQ(tt->compositions_.size(), reparsed->compositions_.size());
+    for (auto const& train : tt->trains_) {
+      CHECK_EQ(train.composition_, reparsed->trains_[train.id_].composition_);
+    }
+  }
+}
+
 }  // namespace soro::tt::test
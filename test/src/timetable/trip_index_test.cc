@@ -0,0 +1,150 @@
+#include "doctest/doctest.h"
+
+#include "soro/utls/std_wrapper/sort.h"
+
+#include "soro/timetable/timetable.h"
+#include "soro/timetable/trip_index.h"
+
+#include "test/file_paths.h"
+
+namespace soro::tt::test {
+
+using namespace date;
+
+train make_test_train(train::id const id, std::string const& bits,
+                      hours const first_departure, hours const last_arrival) {
+  train t;
+  t.id_ = id;
+  t.service_days_ =
+      make_bitfield(2022_y / March / 1, 2022_y / March / 9, bits.data());
+  t.sequence_points_.push_back(sequence_point{.departure_ = first_departure});
+  t.sequence_points_.push_back(sequence_point{.arrival_ = last_arrival});
+  return t;
+}
+
+soro::vector<train> get_test_trains() {
+  soro::vector<train> trains;
+  trains.emplace_back(make_test_train(0, "111111111", hours{8}, hours{16}));
+  trains.emplace_back(make_test_train(1, "101010101", hours{8}, hours{16}));
+  trains.emplace_back(make_test_train(2, "000000001", hours{22}, hours{26}));
+  trains.emplace_back(make_test_train(3, "100000000", hours{0}, hours{10}));
+  trains.emplace_back(make_test_train(4, "010101010", hours{12}, hours{13}));
+  return trains;
+}
+
+// reference implementation, checks the event interval of every trip
+std::vector<train::trip> brute_force_overlapping(
+    soro::vector<train> const& trains, interval const& i) {
+  std::vector<train::trip> result;
+
+  for (auto const& train : trains) {
+    for (auto const anchor : train.departures()) {
+      if (i.overlaps(train.event_interval(anchor))) {
+        result.emplace_back(
+            train::trip{.train_id_ = train.id_, .anchor_ = anchor});
+      }
+    }
+  }
+
+  utls::sort(result);
+
+  return result;
+}
+
+void check_trip_index(soro::vector<train> const& trains, trip_index const& idx,
+                      interval const& i) {
+  auto const expected = brute_force_overlapping(trains, i);
+
+  auto result = idx.overlapping(i);
+  utls::sort(result);
+  CHECK_EQ(result, expected);
+
+  std::vector<train::trip> per_train;
+  for (auto const& train : trains) {
+    for (auto const& e : idx.overlapping(train.id_, i)) {
+      CHECK_EQ(e.trip_.train_id_, train.id_);
+      CHECK(e.interval_.overlaps(i));
+      per_train.emplace_back(e.trip_);
+    }
+  }
+  utls::sort(per_train);
+  CHECK_EQ(per_train, expected);
+}
+
+TEST_SUITE("trip index") {
+  TEST_CASE("trip index, all trips") {
+    auto const trains = get_test_trains();
+    auto const idx = make_trip_index(trains);
+
+    soro::size_t trip_count = 0;
+    for (auto const& train : trains) {
+      trip_count += train.trip_count();
+      CHECK_EQ(idx.trips(train.id_).size(), train.trip_count());
+    }
+
+    CHECK_EQ(idx.size(), trip_count);
+    auto const unknown = static_cast<train::id>(trains.size());
+    CHECK_THROWS(std::ignore = idx.trips(unknown));
+
+    check_trip_index(trains, idx, interval{});
+  }
+
+  TEST_CASE("trip index, windows") {
+    auto const trains = get_test_trains();
+    auto const idx = make_trip_index(trains);
+
+    auto const day = ymd_to_abs(2022_y / March / 1);
+
+    for (auto start = 0U; start < 11 * 24; start += 3) {
+      for (auto const length : {0U, 1U, 5U, 24U, 72U}) {
+        interval const i{.start_ = day + hours{start},
+                         .end_ = day + hours{start + length}};
+        check_trip_index(trains, idx, i);
+      }
+    }
+  }
+
+  TEST_CASE("trip index, one long trip") {
+    auto trains = get_test_trains();
+    trains.emplace_back(make_test_train(5, "100000000", hours{1}, hours{200}));
+    auto const idx = make_trip_index(trains);
+
+    auto const day = ymd_to_abs(2022_y / March / 1);
+
+    for (auto start = 0U; start < 11 * 24; start += 5) {
+      interval const i{.start_ = day + hours{start},
+                       .end_ = day + hours{start + 2}};
+      check_trip_index(trains, idx, i);
+    }
+  }
+
+  TEST_CASE("trip index, trip overlapping midnight") {
+    auto const trains = get_test_trains();
+    auto const idx = make_trip_index(trains);
+
+    interval const i{.start_ = ymd_to_abs(2022_y / March / 10) + hours{1},
+                     .end_ = ymd_to_abs(2022_y / March / 10) + hours{3}};
+
+    std::vector<train::trip> const expected = {
+        {.train_id_ = 2, .anchor_ = ymd_to_abs(2022_y / March / 9)}};
+
+    CHECK_EQ(idx.overlapping(i), expected);
+    CHECK_EQ(idx.overlapping(2, i).size(), std::size_t{1});
+  }
+
+  TEST_CASE("trip index, timetable scenarios") {
+    for (auto const& scenario : soro::test::get_timetable_scenarios()) {
+      auto const& tt = scenario->timetable_;
+      auto const& ti = tt->trip_index_;
+
+      check_trip_index(tt->trains_, ti, tt->interval_);
+
+      auto const mid = tt->interval_.start_ +
+                       (tt->interval_.end_ - tt->interval_.start_) / 2;
+      check_trip_index(tt->trains_, ti,
+                       interval{.start_ = mid, .end_ = mid + hours{2}});
+    }
+  }
+}
+
+}  // namespace soro::tt::test
@@ -57,4 +57,24 @@ TEST_SUITE("interpolation") {
       CHECK(equal(coord_expected.lat_, coord_computed.lat_));
     }
   }
-}
\ No newline at end of file
+
+  TEST_CASE("bounding box overlaps and contains") {
+    auto const bb = get_bounding_box(
+        std::vector<gps>{gps{.lon_ = 8.0, .lat_ = 49.0},
+                         gps{.lon_ = 9.0, .lat_ = 50.0}});
+
+    CHECK(bb.contains(gps{.lon_ = 8.5, .lat_ = 49.5}));
+    CHECK(bb.contains(gps{.lon_ = 9.0, .lat_ = 50.0}));
+    CHECK(!bb.contains(gps{.lon_ = 9.1, .lat_ = 49.5}));
+
+    CHECK(bb.overlaps(bb));
+    CHECK(bb.overlaps(get_bounding_box(std::vector<gps>{
+        gps{.lon_ = 8.9, .lat_ = 48.0}, gps{.lon_ = 10.0, .lat_ = 49.1}})));
+    CHECK(!bb.overlaps(get_bounding_box(std::vector<gps>{
+        gps{.lon_ = 9.1, .lat_ = 49.0}, gps{.lon_ = 10.0, .lat_ = 50.0}})));
+
+    bounding_box const empty;
+    CHECK(!empty.contains(gps{.lon_ = 8.5, .lat_ = 49.5}));
+    CHECK(!empty.overlaps(bb));
+  }
+}
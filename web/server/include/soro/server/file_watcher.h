@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace soro::server {
+
+// changes whenever a file below one of the paths, or one of the paths being a
+// file itself, is added, removed, resized or modified, missing paths are
+// skipped
+std::size_t get_fingerprint(std::vector<std::filesystem::path> const& paths);
+
+/*
+ * Polls the paths for changes on a thread of its own, there is no portable
+ * file system notification and a poll every few seconds is cheap compared to
+ * the reload it triggers.
+ *
+ * A change is reported once the paths stayed the same for another interval,
+ * files which are still being copied do not trigger a reload. Changes made by
+ * the callback itself are not reported.
+ */
+struct file_watcher {
+  using callback_t = std::function<void()>;
+
+  file_watcher(std::vector<std::filesystem::path> paths,
+               std::chrono::milliseconds interval, callback_t on_change);
+
+  file_watcher(file_watcher const&) = delete;
+  file_watcher& operator=(file_watcher const&) = delete;
+  file_watcher(file_watcher&&) = delete;
+  file_watcher& operator=(file_watcher&&) = delete;
+  ~file_watcher() = default;
+
+private:
+  void watch(std::stop_token const& stop);
+
+  // false if stopped while waiting
+  bool wait(std::stop_token const& stop);
+
+  std::vector<std::filesystem::path> paths_;
+  std::chrono::milliseconds interval_;
+  callback_t on_change_;
+
+  std::mutex mutex_;
+  std::condition_variable_any cv_;
+
+  // last member, the thread is joined before anything else is destroyed
+  std::jthread thread_;
+};
+
+}  // namespace soro::server
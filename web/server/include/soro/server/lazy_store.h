@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "soro/utls/sassert.h"
+
+namespace soro::server {
+
+// file size, or the sum of all file sizes in a directory, a lower bound for
+// the memory a value loaded from it requires
+inline std::size_t get_size_on_disk(std::filesystem::path const& path) {
+  namespace fs = std::filesystem;
+
+  if (!fs::is_directory(path)) {
+    return fs::file_size(path);
+  }
+
+  std::size_t result = 0;
+  for (auto&& dir_entry : fs::recursive_directory_iterator{path}) {
+    if (dir_entry.is_regular_file()) {
+      result += dir_entry.file_size();
+    }
+  }
+  return result;
+}
+
+/*
+ * Named, immutable values which are loaded on their first request.
+ *
+ * Requests for a value that is currently loading wait for the running load
+ * instead of starting their own. Every entry carries an estimate of its
+ * memory footprint, once the loaded values exceed the budget the least
+ * recently used ones are dropped and loaded again on their next request.
+ *
+ * Readers share the ownership of a value, dropping it from the store never
+ * invalidates a value someone is still working with.
+ */
+template <typename T>
+struct lazy_store {
+  using ptr = std::shared_ptr<T const>;
+
+  // returns nullptr if the value can not be loaded
+  using loader_t = std::function<ptr()>;
+
+  // budget in bytes, 0: keep every loaded value
+  explicit lazy_store(std::size_t const budget = 0)
+      : state_{std::make_unique<state>()} {
+    state_->budget_ = budget;
+  }
+
+  // `loaded` is returned by the first request instead of calling `load`
+  void add(std::string key, std::size_t const bytes, loader_t load,
+           ptr loaded = nullptr) {
+    std::lock_guard const lock{state_->mutex_};
+
+    auto const [it, success] = state_->entries_.try_emplace(std::move(key));
+    utls::sassert(success, "key {} added twice to lazy store", it->first);
+
+    auto& e = it->second;
+    e.bytes_ = bytes;
+    e.load_ = std::move(load);
+    e.value_ = std::move(loaded);
+
+    if (e.value_ != nullptr) {
+      e.last_used_ = ++state_->clock_;
+      state_->resident_ += e.bytes_;
+      evict(e);
+    }
+  }
+
+  // nullptr if the key is unknown or its value could not be loaded
+  ptr get(std::string_view const key) const {
+    std::unique_lock lock{state_->mutex_};
+
+    auto const it = state_->entries_.find(key);
+    if (it == std::end(state_->entries_)) {
+      return nullptr;
+    }
+
+    // entries are never erased, the reference stays valid while unlocked
+    auto& e = it->second;
+    e.last_used_ = ++state_->clock_;
+
+    if (e.value_ != nullptr || e.failed_) {
+      return e.value_;
+    }
+
+    if (e.loading_.valid()) {
+      auto const loading = e.loading_;
+      lock.unlock();
+      return loading.get();
+    }
+
+    std::promise<ptr> promise;
+    e.loading_ = promise.get_future().share();
+    lock.unlock();
+
+    ptr value;
+    try {
+      value = e.load_();
+    } catch (...) {
+      lock.lock();
+      e.loading_ = {};
+      lock.unlock();
+
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+
+    lock.lock();
+    e.loading_ = {};
+    e.value_ = value;
+    e.failed_ = value == nullptr;
+    if (value != nullptr) {
+      state_->resident_ += e.bytes_;
+      evict(e);
+    }
+    lock.unlock();
+
+    promise.set_value(value);
+    return value;
+  }
+
+  bool contains(std::string_view const key) const {
+    std::lock_guard const lock{state_->mutex_};
+    return state_->entries_.contains(key);
+  }
+
+  // get() returns right away, the value is loaded, failed or unknown
+  bool ready(std::string_view const key) const {
+    std::lock_guard const lock{state_->mutex_};
+    auto const it = state_->entries_.find(key);
+    return it == std::end(state_->entries_) ||
+           it->second.value_ != nullptr || it->second.failed_;
+  }
+
+  bool loaded(std::string_view const key) const {
+    std::lock_guard const lock{state_->mutex_};
+    auto const it = state_->entries_.find(key);
+    return it != std::end(state_->entries_) && it->second.value_ != nullptr;
+  }
+
+  // sorted
+  std::vector<std::string> keys() const {
+    std::lock_guard const lock{state_->mutex_};
+
+    std::vector<std::string> result;
+    result.reserve(state_->entries_.size());
+    for (auto const& key_and_entry : state_->entries_) {
+      result.push_back(key_and_entry.first);
+    }
+
+    return result;
+  }
+
+  // estimated bytes of all loaded values
+  std::size_t resident() const {
+    std::lock_guard const lock{state_->mutex_};
+    return state_->resident_;
+  }
+
+private:
+  struct entry {
+    std::size_t bytes_{0};
+    loader_t load_;
+
+    ptr value_;
+    std::shared_future<ptr> loading_;
+    bool failed_{false};
+
+    std::size_t last_used_{0};
+  };
+
+  struct state {
+    std::mutex mutex_;
+    std::map<std::string, entry, std::less<>> entries_;
+
+    std::size_t budget_{0};
+    std::size_t resident_{0};
+    std::size_t clock_{0};
+  };
+
+  // requires the lock, never drops the value of `keep`
+  void evict(entry const& keep) const {
+    while (state_->budget_ != 0 && state_->resident_ > state_->budget_) {
+      entry* oldest = nullptr;
+      for (auto& key_and_entry : state_->entries_) {
+        auto& e = key_and_entry.second;
+        if (e.value_ != nullptr && &e != &keep &&
+            (oldest == nullptr || e.last_used_ < oldest->last_used_)) {
+          oldest = &e;
+        }
+      }
+
+      if (oldest == nullptr) {
+        break;
+      }
+
+      state_->resident_ -= oldest->bytes_;
+      oldest->value_.reset();
+    }
+  }
+
+  // behind a pointer to keep the store movable
+  std::unique_ptr<state> state_;
+};
+
+}  // namespace soro::server
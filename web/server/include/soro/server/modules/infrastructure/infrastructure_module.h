@@ -2,26 +2,27 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
-
-#include "range/v3/view/map.hpp"
-#include "range/v3/view/transform.hpp"
+#include <vector>
 
 #include "net/web_server/query_router.h"
 #include "net/web_server/web_server.h"
 
 #include "soro/infrastructure/infrastructure.h"
+#include "soro/server/lazy_store.h"
 #include "soro/server/server_settings.h"
 
 namespace soro::server {
 
 struct infrastructure_module {
-  auto all() const {
-    return infrastructures_ | ranges::views::values |
-           ranges::views::transform([](auto&& p) -> auto const& { return *p; });
-  }
+  using serve_fn = net::web_server::string_res_t (infrastructure_module::*)(
+      net::query_router::route_request const&) const;
+
+  // all known infrastructures, loaded or not
+  std::vector<std::string> names() const { return infrastructures_.keys(); }
 
-  infra::infrastructure::optional_ptr get_infra(std::string_view const) const;
+  // loads the infrastructure if it is not resident, nullptr if unknown
+  std::shared_ptr<infra::infrastructure const> get_infra(
+      std::string_view const name) const;
 
   net::web_server::string_res_t serve_infrastructure_names(
       net::query_router::route_request const& req) const;
@@ -47,8 +48,16 @@ struct infrastructure_module {
   net::web_server::string_res_t serve_element(
       net::query_router::route_request const& req) const;
 
-  std::unordered_map<std::string_view, std::unique_ptr<infra::infrastructure>>
-      infrastructures_;
+  // elements, stations and routes overlapping a bounding box
+  net::web_server::string_res_t serve_within(
+      net::query_router::route_request const& req) const;
+
+  // elements, stations and routes closest to a position
+  net::web_server::string_res_t serve_nearest(
+      net::query_router::route_request const& req) const;
+
+  // infrastructure name -> infrastructure
+  lazy_store<infra::infrastructure> infrastructures_;
 };
 
 infrastructure_module get_infrastructure_module(server_settings const& s);
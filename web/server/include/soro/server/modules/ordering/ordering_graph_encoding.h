@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "soro/simulation/ordering/ordering_graph.h"
+#include "soro/timetable/timetable.h"
+
+namespace soro::server {
+
+enum class ordering_graph_format : uint8_t { JSON, BINARY };
+
+constexpr std::string_view ORDERING_GRAPH_BINARY_TYPE =
+    "application/octet-stream";
+constexpr std::string_view ORDERING_GRAPH_MAGIC = "SOOG";
+constexpr uint32_t ORDERING_GRAPH_BINARY_VERSION = 1;
+
+std::string_view content_type(ordering_graph_format const format);
+
+// BINARY if the accept header lists ORDERING_GRAPH_BINARY_TYPE, JSON otherwise
+ordering_graph_format negotiate_ordering_graph_format(
+    std::string_view const accept);
+
+/*
+ * Appends the ordering graph to out, trips ordered by their departure.
+ *
+ * JSON:
+ *   { "attributes": { "totalTrains", "maxTrainLength" },
+ *     "nodes": [ { "key", "attributes": { "train", "offset",
+ *                  "relativeTrainId", "route" } } ],
+ *     "edges": [ { "source", "target" } ] }
+ *
+ * BINARY, every integer an unsigned LEB128 varint:
+ *   magic "SOOG", version
+ *   trip count, node count, edge count, max trip length
+ *   per trip: train id, first node id, node count
+ *   per node in trip order: interlocking route id
+ *   per node in trip order: out degree followed by the target node ids
+ */
+void write_ordering_graph(std::string& out,
+                          simulation::ordering_graph const& og,
+                          tt::timetable const& tt,
+                          ordering_graph_format const format);
+
+}  // namespace soro::server
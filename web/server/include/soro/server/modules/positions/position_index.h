@@ -0,0 +1,84 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "soro/base/soro_types.h"
+#include "soro/base/time.h"
+
+#include "soro/utls/coordinates/gps.h"
+
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/timetable/timetable.h"
+
+namespace soro::server {
+
+struct train_position {
+  tt::train::trip trip_;
+  utls::gps position_;
+  bool halting_{false};
+};
+
+/*
+ * Spatio-temporal index over the positions of all trips in a timetable.
+ *
+ * The running time calculation of every train is done once while building
+ * the index, its timestamps are stored as waypoints with the positions of the
+ * passed elements. All trips of a train share these waypoints relative to
+ * their anchor, in between two waypoints a train moves linearly.
+ *
+ * The timetable's trip index narrows a query down to the trips running at the
+ * requested time. For every train the index additionally stores the bounding
+ * box of the positions it takes in consecutive time slices, trips outside the
+ * viewport are dropped with a single lookup before interpolating.
+ */
+struct position_index {
+  // a train is at position_ in [arrival_, departure_]
+  struct waypoint {
+    relative_time arrival_;
+    relative_time departure_;
+    utls::gps position_;
+  };
+
+  static constexpr duration2 SLICE_WIDTH{300};
+
+  position_index(infra::infrastructure const& infra,
+                 tt::timetable const& tt);
+
+  // positions of all trips running at t in the viewport, sorted by the first
+  // departure of their trip. tt has to be the timetable of the index.
+  std::vector<train_position> positions(
+      tt::timetable const& tt, absolute_time const t,
+      utls::bounding_box const& viewport) const;
+
+  // positions of all trips running at t
+  std::vector<train_position> positions(tt::timetable const& tt,
+                                        absolute_time const t) const;
+
+  // position of the trip at t, nullopt if the trip is not running at t
+  std::optional<train_position> position(tt::train::trip const& trip,
+                                         absolute_time const t) const;
+
+  std::span<waypoint const> waypoints(tt::train::id const train_id) const;
+  std::span<utls::bounding_box const> slices(
+      tt::train::id const train_id) const;
+
+  // waypoints of train t are waypoints_[waypoint_offsets_[t],
+  // waypoint_offsets_[t+1])
+  std::vector<waypoint> waypoints_;
+  std::vector<soro::size_t> waypoint_offsets_;
+
+  // slice s of train t covers SLICE_WIDTH seconds starting at its first
+  // waypoint plus s * SLICE_WIDTH, slices of train t are
+  // slices_[slice_offsets_[t], slice_offsets_[t+1])
+  std::vector<utls::bounding_box> slices_;
+  std::vector<soro::size_t> slice_offsets_;
+
+  // how much earlier/later than their event interval trains are running,
+  // widens the trip index queries
+  duration2 max_early_{0};
+  duration2 max_late_{0};
+};
+
+}  // namespace soro::server
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include "soro/server/lazy_store.h"
+#include "soro/server/modules/infrastructure/infrastructure_module.h"
+#include "soro/server/modules/positions/position_index.h"
+#include "soro/server/modules/timetable/timetable_module.h"
+
+namespace soro::server {
+
+struct positions_module {
+  // upper bound for the frames of a single playback response
+  static constexpr std::size_t MAX_FRAMES = 600;
+
+  // builds the index on its first request, nullptr if unknown
+  std::shared_ptr<position_index const> get_position_index(
+      std::string_view const infrastructure_name,
+      std::string_view const timetable_name) const;
+
+  net::web_server::string_res_t serve_positions(
+      net::query_router::route_request const& req,
+      timetable_module const& timetable_m) const;
+
+  // infrastructure name/timetable name -> position index
+  lazy_store<position_index> indices_;
+};
+
+// indices are built with the running time calculation of every train, which
+// is why they are always built on their first request and never evicted.
+// infra_m and timetable_m have to outlive the module.
+positions_module get_positions_module(infrastructure_module const& infra_m,
+                                      timetable_module const& timetable_m);
+
+}  // namespace soro::server
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "soro/base/soro_types.h"
+
+#include "soro/utls/coordinates/gps.h"
+#include "soro/utls/serializable.h"
+
+#include "soro/infrastructure/graph/type.h"
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/infrastructure/spatial_index.h"
+
+#include "soro/server/query_params.h"
+
+namespace soro::server {
+
+struct search_query {
+  std::string_view text_;
+  type_filter types_{};
+
+  // only entries with a bounding box overlapping it
+  std::optional<utls::bounding_box> viewport_{std::nullopt};
+
+  soro::size_t limit_{search_query::DEFAULT_LIMIT};
+
+  static constexpr soro::size_t DEFAULT_LIMIT = 20;
+};
+
+/*
+ * Search index over the names of all stations, elements, station routes and
+ * interlocking routes of an infrastructure.
+ *
+ * Names are searched by their key, the lower case name without anything but
+ * letters and digits. The entries sorted by their key form a flattened trie,
+ * all keys with a given prefix are one consecutive range. Queries with three
+ * or more characters also match entries sharing most of their trigrams, to
+ * tolerate typos.
+ *
+ * Every entry keeps the type and bounding box of what it names, results are
+ * filtered without touching the infrastructure. All members are flat vectors,
+ * the index is serialized once per infrastructure and memory mapped after.
+ */
+struct search_index_t {
+  struct entry {
+    infra::spatial_index::kind kind_{infra::spatial_index::kind::ELEMENT};
+
+    // only set for elements
+    infra::type element_type_{infra::type::INVALID};
+
+    soro::size_t id_{0};
+
+    // empty if none of the named elements has a position
+    utls::bounding_box bounding_box_{};
+  };
+
+  struct match {
+    soro::size_t entry_{0};
+
+    // exact: 3, prefix: [2, 3), trigram similarity: (0, 1]
+    float score_{0.0F};
+  };
+
+  // best match per named item, best first
+  std::vector<match> search(search_query const& query) const;
+
+  // name of entry e is names_[e], its key is keys_[e]
+  soro::vector<entry> entries_;
+  soro::vector<soro::string> names_;
+  soro::vector<soro::string> keys_;
+
+  // all entries, sorted by their key
+  soro::vector<soro::size_t> by_key_;
+
+  // postings of trigrams_[t] are the sorted entries
+  // [postings_[trigram_offsets_[t]], postings_[trigram_offsets_[t + 1]])
+  soro::vector<uint32_t> trigrams_;
+  soro::vector<soro::size_t> trigram_offsets_;
+  soro::vector<soro::size_t> postings_;
+};
+
+struct search_index : utls::serializable<search_index_t> {
+  using utls::serializable<search_index_t>::serializable;
+
+  explicit search_index(infra::infrastructure const& infra);
+};
+
+// lower case letters and digits of the name, other bytes of UTF-8 sequences
+// are kept as they are
+std::string to_search_key(std::string_view const name);
+
+}  // namespace soro::server
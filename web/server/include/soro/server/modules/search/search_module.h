@@ -1,51 +1,27 @@
 #pragma once
 
-#include "guess/guesser.h"
-
+#include "soro/server/lazy_store.h"
 #include "soro/server/modules/infrastructure/infrastructure_module.h"
+#include "soro/server/modules/search/search_index.h"
 
 namespace soro::server {
 
 struct search_module {
-  struct result {
-    enum class type : uint8_t {
-      STATION,
-      ELEMENT,
-      STATION_ROUTE,
-      INTERLOCKING_ROUTE
-    };
-
-    static std::string_view type_to_string(type const t) {
-      switch (t) {
-        case type::STATION: return "station";
-        case type::ELEMENT: return "element";
-        case type::STATION_ROUTE: return "stationRoute";
-        case type::INTERLOCKING_ROUTE: return "interlockingRoute";
-      }
-
-      return "not reachable";
-    }
-
-    type type_;
-    std::string name_{};
-    utls::bounding_box bounding_box_;
-    std::size_t id_{std::numeric_limits<std::size_t>::max()};
-    std::string element_type_{};
-  };
-
-  struct context {
-    std::vector<result> results_;
-    std::unique_ptr<guess::guesser> guesser_;
-  };
+  // upper bound for the results of a single search
+  static constexpr soro::size_t MAX_LIMIT = 500;
 
   net::web_server::string_res_t serve_search(
-      net::query_router::route_request const& req,
-      infrastructure_module const& infra_m) const;
+      net::query_router::route_request const& req) const;
 
-  // infrastructure name -> search context
-  std::unordered_map<std::string_view, context> contexts_;
+  // infrastructure name -> search index
+  lazy_store<search_index> indices_;
 };
 
-search_module get_search_module(infrastructure_module const& infra_m);
+// indices are serialized to the search directory and memory mapped from there
+// as long as they are newer than their serialized infrastructure. otherwise
+// they are built from the infrastructures of infra_m on their first search
+// when running lazily, infra_m has to outlive the module
+search_module get_search_module(server_settings const& s,
+                                infrastructure_module const& infra_m);
 
 }  // namespace soro::server
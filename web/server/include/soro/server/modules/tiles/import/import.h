@@ -1,28 +1,27 @@
 #pragma once
 
 #include <filesystem>
-#include <string>
-#include <vector>
+
+#include "soro/infrastructure/infrastructure.h"
 
 namespace soro::server {
 
 namespace fs = std::filesystem;
 
-struct import_settings {
-  import_settings(fs::path osm_path, fs::path db_path, fs::path tmp_dir,
-                  fs::path profile_path)
-      : osm_path_{std::move(osm_path)},
-        db_path_{std::move(db_path)},
-        tmp_dir_{std::move(tmp_dir)},
-        osm_profile_{std::move(profile_path)} {}
-
-  fs::path osm_path_;
-  fs::path db_path_;
-  fs::path tmp_dir_;
-
-  fs::path osm_profile_;
-};
-
-void import_tiles(import_settings const& settings);
+// layers and metadata match the former osm export and lua profile,
+// the client map style depends on them
+constexpr auto const RAIL_LAYER = "rail";
+constexpr auto const STATION_LAYER = "station";
+
+constexpr auto const MIN_ZOOM_LEVEL = 5U;
+
+/*
+ * Writes the tile database of the infrastructure at db_path.
+ *
+ * Stations, elements and the tracks between neighbouring elements are
+ * inserted as features straight from the infrastructure in parallel. Tracks
+ * between two stations follow the interpolated curve of the osm export.
+ */
+void import_tiles(infra::infrastructure const& infra, fs::path const& db_path);
 
 }  // namespace soro::server
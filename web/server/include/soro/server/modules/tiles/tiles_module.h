@@ -1,6 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
 
 // for tiles::render_ctx
 #include "tiles/get_tile.h"
@@ -14,12 +20,30 @@ namespace soro::server {
 
 struct tiles_module {
   struct context {
-    explicit context(std::filesystem::path const& tile_db_path)
-        : db_env_{tiles::make_tile_database(tile_db_path.string().c_str(),
+    context(std::filesystem::path tile_db_path, std::size_t const fingerprint)
+        : db_path_{std::move(tile_db_path)},
+          fingerprint_{fingerprint},
+          db_env_{tiles::make_tile_database(db_path_.string().c_str(),
                                             tiles::kDefaultSize)},
           tile_handle_{db_env_},
           render_ctx_{tiles::make_render_ctx(tile_handle_)},
-          pack_handle_{tile_db_path.string().c_str()} {}
+          pack_handle_{db_path_.string().c_str()} {}
+
+    context(context const&) = delete;
+    context& operator=(context const&) = delete;
+    context(context&&) = delete;
+    context& operator=(context&&) = delete;
+
+    // removes the database once it is outdated and nobody serves from it
+    ~context();
+
+    std::filesystem::path db_path_;
+
+    // of the infrastructure sources the database was imported from
+    std::size_t fingerprint_;
+
+    // set by the reload that replaces the database
+    std::atomic_bool outdated_{false};
 
     lmdb::env db_env_;
     tiles::tile_db_handle tile_handle_;
@@ -28,12 +52,17 @@ struct tiles_module {
   };
 
   net::web_server::string_res_t serve_tile(
-      net::query_router::route_request const& req);
+      net::query_router::route_request const& req) const;
 
-  std::unordered_map<std::string_view, context> tile_contexts_;
+  // infrastructure name -> tile database, shared with later reloads
+  std::map<std::string, std::shared_ptr<context>, std::less<>> tile_contexts_;
 };
 
+// takes over the tile databases of `previous` for infrastructures whose
+// sources did not change, a database file must not be opened twice by the same
+// process. changed infrastructures are imported to a fresh path.
 tiles_module get_tile_module(server_settings const& settings,
-                             infrastructure_module const& infra_m);
+                             infrastructure_module const& infra_m,
+                             tiles_module const* previous = nullptr);
 
 }  // namespace soro::server
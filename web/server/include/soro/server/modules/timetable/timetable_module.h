@@ -1,35 +1,21 @@
 #pragma once
 
-#include "range/v3/range/concepts.hpp"
-#include "range/v3/view/empty.hpp"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "soro/timetable/timetable.h"
 
+#include "soro/server/lazy_store.h"
 #include "soro/server/modules/infrastructure/infrastructure_module.h"
 #include "soro/server/server_settings.h"
 
 namespace soro::server {
 
 struct timetable_module {
-  struct infra_context {
-    std::unordered_map<std::string_view, std::unique_ptr<tt::timetable>>
-        timetables_;
-  };
-
-  auto all(std::string_view const infrastructure_source) const {
-    // helper to return an empty range when the infrastructure is not found
-    static auto empty_context = infra_context{};
-
-    auto context_it = contexts_.find(infrastructure_source);
-
-    auto const& context =
-        context_it == std::end(contexts_) ? empty_context : context_it->second;
-
-    return context.timetables_ | ranges::views::values |
-           ranges::views::transform([](auto&& p) -> auto const& { return *p; });
-  }
-
-  tt::timetable::optional_ptr get_timetable(
+  // loads the timetable if it is not resident, nullptr if unknown
+  std::shared_ptr<tt::timetable const> get_timetable(
       std::string_view const infrastructure_name,
       std::string_view const timetable_name) const;
 
@@ -39,9 +25,19 @@ struct timetable_module {
   net::web_server::string_res_t serve_timetable(
       net::query_router::route_request const& req) const;
 
-  std::unordered_map<std::string_view, infra_context> contexts_;
+  // infrastructure name -> names of the timetables valid for it
+  std::map<std::string, std::vector<std::string>, std::less<>> names_;
+
+  // infrastructure name/timetable name -> timetable
+  lazy_store<tt::timetable> timetables_;
 };
 
+// key of a timetable in timetable_module::timetables_
+std::string get_timetable_key(std::string_view const infrastructure_name,
+                              std::string_view const timetable_name);
+
+// the module reparses timetables with the infrastructures of infra_m when
+// compiled without serialization support, infra_m has to outlive it
 timetable_module get_timetable_module(server_settings const& s,
                                       infrastructure_module const& infra_m);
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "soro/utls/coordinates/gps.h"
+#include "soro/utls/result.h"
+
+#include "soro/infrastructure/graph/type.h"
+#include "soro/infrastructure/spatial_index.h"
+
+namespace soro::server {
+
+// the parsers expect decimals as matched by the route regex -?\d+(?:\.\d+)?
+
+// "west,south,east,north"
+utls::result<utls::bounding_box> str_to_bounding_box(
+    std::string_view const str);
+
+utls::gps::precision str_to_decimal(std::string_view const str);
+
+// item kinds and element types, e.g. "station,ms" for all stations and main
+// signals. element types restrict the elements to the given types.
+struct type_filter {
+  // element_type is only considered for elements
+  bool accepts(infra::spatial_index::kind const kind,
+               infra::type const element_type) const;
+
+  // accepts everything
+  bool empty() const noexcept;
+
+  std::vector<infra::spatial_index::kind> kinds_;
+  std::vector<infra::type> element_types_;
+};
+
+// comma separated, empty: accepts everything
+utls::result<type_filter> str_to_type_filter(std::string_view const str);
+
+}  // namespace soro::server
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "net/web_server/query_router.h"
+#include "net/web_server/web_server.h"
+
+#include "soro/infrastructure/infrastructure.h"
+#include "soro/timetable/timetable.h"
+
+namespace soro::server {
+
+// identifies the data a response is computed from, changes with every version
+std::string version_tag(infra::infrastructure const& infra);
+std::string version_tag(tt::timetable const& tt);
+
+/*
+ * Caches successful responses of endpoints whose content only depends on the
+ * request target and on immutable data, the infrastructure or a timetable.
+ *
+ * The strong ETag of a response is a hash of its body, a matching
+ * If-None-Match is answered with 304. Bodies above COMPRESS_THRESHOLD are
+ * stored deflated as well and sent compressed to clients accepting deflate,
+ * their ETag carries a -deflate suffix to tell the representations apart.
+ *
+ * Entries are keyed by the version tag and the target, so a new version of
+ * the data never hits an entry of an old one. They are spread over shards by
+ * their key, every shard evicts its least recently used entries once it holds
+ * more than its share of the capacity, outdated entries are evicted this way.
+ */
+struct response_cache {
+  using producer_t = std::function<net::web_server::string_res_t()>;
+
+  static constexpr std::size_t COMPRESS_THRESHOLD = 1024;
+
+  explicit response_cache(std::size_t capacity_bytes, std::size_t shards = 16);
+
+  net::web_server::string_res_t serve(
+      net::query_router::route_request const& req, std::string_view const tag,
+      producer_t const& produce);
+
+  std::size_t hits() const;
+  std::size_t misses() const;
+
+  struct entry {
+    std::size_t bytes() const;
+
+    // of the identity body
+    std::string etag_;
+    std::string content_type_;
+    std::string body_;
+
+    // empty if the body is not worth compressing
+    std::string deflated_;
+  };
+
+private:
+  struct shard {
+    using lru_t = std::list<std::string>;
+
+    std::mutex mutex_;
+    lru_t lru_;
+    std::unordered_map<std::string,
+                       std::pair<std::shared_ptr<entry const>, lru_t::iterator>>
+        entries_;
+    std::size_t bytes_{0};
+    std::size_t hits_{0};
+    std::size_t misses_{0};
+  };
+
+  std::shared_ptr<entry const> get(shard& s, std::string const& key);
+  void put(shard& s, std::string const& key, std::shared_ptr<entry const> e);
+
+  std::size_t shard_capacity_;
+  std::vector<std::unique_ptr<shard>> shards_;
+};
+
+}  // namespace soro::server
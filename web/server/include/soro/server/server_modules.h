@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "soro/server/modules/infrastructure/infrastructure_module.h"
+#include "soro/server/modules/positions/positions_module.h"
+#include "soro/server/modules/search/search_module.h"
+#include "soro/server/modules/tiles/tiles_module.h"
+#include "soro/server/modules/timetable/timetable_module.h"
+#include "soro/server/server_settings.h"
+
+namespace soro::server {
+
+/*
+ * Everything the server serves which is derived from the resource
+ * directories. A reload builds a complete new instance next to the one in
+ * use and publishes it at once, requests keep the instance they started with.
+ *
+ * The search, timetable and positions modules refer to the modules they are
+ * built from in the same instance, which is why instances can neither be
+ * copied nor moved.
+ */
+struct server_modules {
+  // tile databases of `previous` are reused for known infrastructures
+  explicit server_modules(server_settings const& s,
+                          server_modules const* previous = nullptr);
+
+  server_modules(server_modules const&) = delete;
+  server_modules(server_modules&&) = delete;
+  server_modules& operator=(server_modules const&) = delete;
+  server_modules& operator=(server_modules&&) = delete;
+  ~server_modules() = default;
+
+  // incremented with every reload
+  std::size_t generation_;
+
+  infrastructure_module infrastructure_;
+  tiles_module tiles_;
+  search_module search_;
+  timetable_module timetable_;
+  positions_module positions_;
+};
+
+}  // namespace soro::server
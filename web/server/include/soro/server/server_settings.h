@@ -10,11 +10,6 @@ struct server_settings {
     return server_resource_dir_.val() / "misc" / "btrs_geo.csv";
   }
 
-  // OSM profile.lua
-  std ::filesystem::path profile_file() const {
-    return server_resource_dir_.val() / "profile" / "profile.lua";
-  }
-
   // put serialized infrastructure in this directory
   std ::filesystem::path server_infra_dir() const {
     return server_resource_dir_.val() / "infrastructure";
@@ -25,21 +20,16 @@ struct server_settings {
     return server_resource_dir_.val() / "timetable";
   }
 
+  // put serialized search indices in this directory
+  std ::filesystem::path server_search_dir() const {
+    return server_resource_dir_.val() / "search";
+  }
+
   // tiles.mdb in this directory
   std ::filesystem::path tiles_dir() const {
     return server_resource_dir_.val() / "tiles";
   }
 
-  // infrastructure.osm in this directory
-  std ::filesystem::path osm_dir() const {
-    return server_resource_dir_.val() / "osm";
-  }
-
-  // temporary files in this directory
-  std ::filesystem::path tmp_dir() const {
-    return server_resource_dir_.val() / "tmp";
-  }
-
   utl::cmd_line_flag<
       std::filesystem::path, UTL_LONG("--server_resource_dir"),
       UTL_DESC("working directory for the server, already created by cmake")>
@@ -63,6 +53,34 @@ struct server_settings {
                      UTL_DESC("port the server listens on")>
       port_{"8080"};
 
+  utl::cmd_line_flag<unsigned, UTL_LONG("--worker_threads"),
+                     UTL_DESC("threads for expensive requests, 0: all cores")>
+      worker_threads_{0U};
+
+  utl::cmd_line_flag<unsigned, UTL_LONG("--worker_queue"),
+                     UTL_DESC("expensive requests waiting before 503 replies")>
+      worker_queue_{64U};
+
+  utl::cmd_line_flag<unsigned, UTL_LONG("--worker_timeout"),
+                     UTL_DESC("seconds until a waiting request is dropped")>
+      worker_timeout_{120U};
+
+  utl::cmd_line_flag<unsigned, UTL_LONG("--response_cache_mb"),
+                     UTL_DESC("memory for cached infrastructure responses")>
+      response_cache_mb_{256U};
+
+  utl::cmd_line_flag<bool, UTL_LONG("--lazy"),
+                     UTL_DESC("load infrastructures and timetables on demand")>
+      lazy_{false};
+
+  utl::cmd_line_flag<unsigned, UTL_LONG("--memory_budget_mb"),
+                     UTL_DESC("memory per resource kind, 0: unlimited")>
+      memory_budget_mb_{0U};
+
+  utl::cmd_line_flag<unsigned, UTL_LONG("--reload_interval"),
+                     UTL_DESC("seconds between resource checks, 0: no reload")>
+      reload_interval_{10U};
+
   utl::cmd_line_flag<bool, UTL_LONG("--regenerate"), UTL_SHORT("-r"),
                      UTL_DESC("regenerate server resources")>
       regenerate_{false};
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+
 #include "net/web_server/query_router.h"
 
-#include "soro/server/modules/infrastructure/infrastructure_module.h"
+#include "soro/server/file_watcher.h"
 #include "soro/server/modules/ordering/ordering_module.h"
-#include "soro/server/modules/search/search_module.h"
-#include "soro/server/modules/tiles/tiles_module.h"
-#include "soro/server/modules/timetable/timetable_module.h"
+#include "soro/server/response_cache.h"
+#include "soro/server/server_modules.h"
 #include "soro/server/server_settings.h"
+#include "soro/server/worker_pool.h"
 
 namespace soro::server {
 
@@ -19,13 +24,49 @@ struct soro_server {
 private:
   void set_up_routes(server_settings const& s);
 
+  // a request keeps the modules current at its start until it is done
+  std::shared_ptr<server_modules const> modules() const;
+
+  // builds new modules next to the current ones and swaps them in,
+  // the current ones stay in use if that fails
+  void reload(server_settings const& s);
+
+  // serves on the io thread if everything the request needs is resident.
+  // otherwise the load runs on the worker pool, a cold infrastructure or
+  // timetable does not block the other connections
+  void serve_loaded(
+      net::query_router::route_request const& req,
+      net::web_server::http_res_cb_t const& cb, bool const ready,
+      std::function<net::web_server::string_res_t(
+          net::query_router::route_request const&)> const& serve);
+
+  // the response only depends on the infrastructure, cache it
+  void serve_cached(net::query_router::route_request const& req,
+                    net::web_server::http_res_cb_t const& cb,
+                    infrastructure_module::serve_fn const serve);
+
+  // the response depends on arbitrary coordinates, caching it would let
+  // clients fill the cache with responses nobody asks for again
+  void serve_uncached(net::query_router::route_request const& req,
+                      net::web_server::http_res_cb_t const& cb,
+                      infrastructure_module::serve_fn const serve);
+
+  net::web_server::string_res_t get_cached(
+      net::query_router::route_request const& req,
+      infrastructure_module::serve_fn const serve);
+
   net::query_router router_;
 
-  infrastructure_module infrastructure_module_;
-  tiles_module tiles_module_;
-  search_module search_module_;
-  timetable_module timetable_module_;
+  std::atomic<std::shared_ptr<server_modules const>> modules_;
   ordering_module ordering_module_;
+
+  response_cache response_cache_;
+
+  // created in run(), replies are posted to its io context
+  std::optional<worker_pool> workers_;
+
+  // created in run(), reloads the modules on changed resources
+  std::optional<file_watcher> watcher_;
 };
 
 }  // namespace soro::server
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+namespace soro::server {
+
+// rapidjson output stream appending to a string, avoids the string buffer copy
+struct string_output {
+  using Ch = char;
+
+  void Put(Ch const c) { out_.push_back(c); }
+  void Flush() {}
+
+  std::string& out_;
+};
+
+}  // namespace soro::server
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "boost/asio/any_io_executor.hpp"
+
+#include "net/web_server/query_router.h"
+#include "net/web_server/web_server.h"
+
+namespace soro::server {
+
+net::web_server::string_res_t service_unavailable_response(
+    net::web_server::http_req_t const& req);
+
+/*
+ * Runs expensive request handlers on a fixed set of threads, the io thread
+ * keeps serving tiles, search requests and static files in the meantime.
+ *
+ * Requests with the same target and accept header share one computation,
+ * every client waiting for it receives a copy of the response. At most
+ * queue_size computations wait for a worker, beyond that requests are
+ * answered with 503 right away.
+ *
+ * Every client waits at most timeout for its response, afterwards it is
+ * answered with 503 and most likely gave up already. Once the last client of
+ * a computation is gone the computation is dropped from the queue, or its
+ * stop token is triggered if it is running already. Handlers check the token
+ * inside their expensive loops, it is triggered on shutdown as well.
+ */
+struct worker_pool {
+  using handler_t = std::function<net::web_server::string_res_t(
+      net::query_router::route_request const&, std::stop_token const&)>;
+
+  worker_pool(boost::asio::any_io_executor io, unsigned threads,
+              unsigned queue_size, std::chrono::milliseconds timeout);
+  ~worker_pool();
+
+  worker_pool(worker_pool const&) = delete;
+  worker_pool& operator=(worker_pool const&) = delete;
+  worker_pool(worker_pool&&) = delete;
+  worker_pool& operator=(worker_pool&&) = delete;
+
+  // the response is handed to cb on the io executor
+  void submit(net::query_router::route_request const& req,
+              net::web_server::http_res_cb_t const& cb, handler_t handler);
+
+  std::size_t coalesced() const;
+  std::size_t rejected() const;
+  std::size_t cancelled() const;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  struct waiter {
+    net::web_server::http_res_cb_t cb_;
+    unsigned version_;
+    bool keep_alive_;
+    clock::time_point deadline_;
+  };
+
+  struct job {
+    std::string key_;
+    net::query_router::route_request req_;
+    handler_t handler_;
+
+    std::vector<waiter> waiters_;
+
+    // triggered once the last waiter is gone, or on shutdown
+    std::stop_source stop_;
+  };
+
+  void work(std::stop_token const& stop);
+
+  // answers waiters past their deadline, cancels jobs nobody waits for
+  void expire(std::stop_token const& stop);
+  std::vector<waiter> take_expired(job& j, clock::time_point now);
+
+  void reply(std::vector<waiter> const& waiters,
+             net::web_server::string_res_t&& res);
+
+  boost::asio::any_io_executor io_;
+  unsigned queue_size_;
+  std::chrono::milliseconds timeout_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable_any cv_;
+
+  // only woken by its stop token
+  std::condition_variable_any reaper_cv_;
+
+  std::deque<std::shared_ptr<job>> queue_;
+
+  // queued and running jobs, cancelled jobs are removed right away
+  std::unordered_map<std::string, std::shared_ptr<job>> in_flight_;
+
+  std::size_t coalesced_{0};
+  std::size_t rejected_{0};
+  std::size_t cancelled_{0};
+
+  // last members, the threads are joined before anything else is destroyed
+  std::jthread reaper_;
+  std::vector<std::jthread> threads_;
+};
+
+}  // namespace soro::server
@@ -0,0 +1,92 @@
+#include "soro/server/file_watcher.h"
+
+#include "cista/hash.h"
+
+namespace soro::server {
+
+namespace fs = std::filesystem;
+
+std::size_t combine_entry(std::size_t result, fs::directory_entry const& entry,
+                          std::error_code& ec) {
+  result = cista::hash_combine(result, cista::hash(entry.path().string()));
+
+  auto const modified = entry.last_write_time(ec);
+  if (!ec) {
+    result = cista::hash_combine(
+        result, static_cast<std::size_t>(modified.time_since_epoch().count()));
+  }
+
+  if (entry.is_regular_file(ec)) {
+    result = cista::hash_combine(result, entry.file_size(ec));
+  }
+
+  ec.clear();
+  return result;
+}
+
+std::size_t get_fingerprint(std::vector<fs::path> const& paths) {
+  auto result = cista::BASE_HASH;
+
+  for (auto const& path : paths) {
+    std::error_code ec;
+
+    // a single file has no entries to iterate
+    if (fs::directory_entry const file{path, ec};
+        !ec && file.is_regular_file(ec)) {
+      result = combine_entry(result, file, ec);
+      continue;
+    }
+
+    ec.clear();
+    fs::recursive_directory_iterator it{
+        path, fs::directory_options::skip_permission_denied, ec};
+
+    // files may disappear while iterating, skip them instead of throwing
+    for (; !ec && it != fs::recursive_directory_iterator{}; it.increment(ec)) {
+      result = combine_entry(result, *it, ec);
+    }
+  }
+
+  return result;
+}
+
+file_watcher::file_watcher(std::vector<fs::path> paths,
+                           std::chrono::milliseconds const interval,
+                           callback_t on_change)
+    : paths_{std::move(paths)},
+      interval_{interval},
+      on_change_{std::move(on_change)},
+      thread_{[this](std::stop_token const& stop) { watch(stop); }} {}
+
+bool file_watcher::wait(std::stop_token const& stop) {
+  std::unique_lock lock{mutex_};
+  cv_.wait_for(lock, stop, interval_, [] { return false; });
+  return !stop.stop_requested();
+}
+
+void file_watcher::watch(std::stop_token const& stop) {
+  auto known = get_fingerprint(paths_);
+
+  while (wait(stop)) {
+    auto current = get_fingerprint(paths_);
+    if (current == known) {
+      continue;
+    }
+
+    // wait until the paths settled
+    for (auto previous = known; current != previous;) {
+      if (!wait(stop)) {
+        return;
+      }
+
+      previous = current;
+      current = get_fingerprint(paths_);
+    }
+
+    on_change_();
+
+    known = get_fingerprint(paths_);
+  }
+}
+
+}  // namespace soro::server
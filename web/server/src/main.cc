@@ -38,12 +38,6 @@ int main(int argc, char const** argv) {
     return 1;
   }
 
-  if (!fs::exists(s.profile_file())) {
-    uLOG(utl::err) << "cmake should have created " << s.profile_file()
-                   << ", but it does not exist";
-    return 1;
-  }
-
   if (!fs::exists(s.infrastructure_sources_.val()) &&
       fs::is_directory(s.infrastructure_sources_.val())) {
     uLOG(utl::err) << "please specify a valid infrastructure source directory, "
@@ -60,9 +54,8 @@ int main(int argc, char const** argv) {
 
   fs::create_directory(s.server_infra_dir());
   fs::create_directory(s.server_timetable_dir());
+  fs::create_directory(s.server_search_dir());
   fs::create_directory(s.tiles_dir());
-  fs::create_directory(s.osm_dir());
-  fs::create_directory(s.tmp_dir());
 
   soro_server server(s);
   server.run(s);
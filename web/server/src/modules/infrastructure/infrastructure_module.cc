@@ -1,6 +1,8 @@
 #include "soro/server/modules/infrastructure/infrastructure_module.h"
 
+#include "utl/enumerate.h"
 #include "utl/logging.h"
+#include "utl/parallel_for.h"
 #include "utl/timer.h"
 
 #include "soro/utls/serializable.h"
@@ -11,15 +13,9 @@ namespace fs = std::filesystem;
 
 namespace soro::server {
 
-infra::infrastructure::optional_ptr infrastructure_module::get_infra(
+std::shared_ptr<infrastructure const> infrastructure_module::get_infra(
     std::string_view const name) const {
-
-  if (auto const infra_it = infrastructures_.find(name);
-      infra_it != std::end(infrastructures_)) {
-    return infrastructure::optional_ptr(infra_it->second.get());
-  }
-
-  return std::nullopt;
+  return infrastructures_.get(name);
 }
 
 std::vector<fs::path> get_infrastructure_todo_list(
@@ -62,19 +58,58 @@ infrastructure_module get_infrastructure_module(
   utl::scoped_timer const timer("creating infrastructure module");
 
   infrastructure_module result;
+  result.infrastructures_ = lazy_store<infrastructure>(
+      std::size_t{s.memory_budget_mb_.val()} * 1024 * 1024);
 
   auto const infra_todo_list = get_infrastructure_todo_list(s);
-  for (auto const& infra_item : infra_todo_list) {
-    auto infra = std::make_unique<infrastructure>(
-        is_directory(infra_item)
-            ? infrastructure(make_infra_opts(infra_item, s.coord_file()))
-            : infrastructure(infra_item));
-
-    if (infrastructure::serialization_possible() && is_directory(infra_item)) {
-      (*infra).save(s.server_infra_dir() / infra_item.filename());
+
+  // sources without an up to date serialized raw file are built right away,
+  // infrastructures are independent of each other, build them in parallel
+  std::vector<std::shared_ptr<infrastructure const>> built(
+      infra_todo_list.size());
+  utl::parallel_for_run(infra_todo_list.size(), [&](auto&& idx) {
+    auto const& infra_item = infra_todo_list[idx];
+    if (!is_directory(infra_item)) {
+      return;
     }
 
-    result.infrastructures_.emplace((*infra)->source_, std::move(infra));
+    auto infra = std::make_shared<infrastructure>(
+        make_infra_opts(infra_item, s.coord_file()));
+
+    if (infrastructure::serialization_possible()) {
+      infra->save(s.server_infra_dir() / infra_item.filename());
+    }
+
+    built[idx] = std::move(infra);
+  });
+
+  for (auto const [idx, infra_item] : utl::enumerate(infra_todo_list)) {
+    auto const raw = s.server_infra_dir() / infra_item.filename();
+
+    // serialized infrastructures are memory mapped again after an eviction,
+    // without serialization support they are built from their sources again
+    lazy_store<infrastructure>::loader_t load;
+    if (infrastructure::serialization_possible()) {
+      load = [raw] { return std::make_shared<infrastructure const>(raw); };
+    } else {
+      load = [infra_item, coord_file = s.coord_file()] {
+        return std::make_shared<infrastructure const>(
+            make_infra_opts(infra_item, coord_file));
+      };
+    }
+
+    auto const bytes = get_size_on_disk(
+        infrastructure::serialization_possible() ? raw : infra_item);
+
+    result.infrastructures_.add(infra_item.filename().string(), bytes,
+                                std::move(load), std::move(built[idx]));
+  }
+
+  if (!s.lazy_.val()) {
+    auto const names = result.names();
+    utl::parallel_for_run(names.size(), [&](auto&& idx) {
+      result.get_infra(names[idx]);
+    });
   }
 
   return result;
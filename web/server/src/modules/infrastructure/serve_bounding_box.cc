@@ -15,11 +15,11 @@ net::web_server::string_res_t infrastructure_module::serve_bounding_box(
     net::query_router::route_request const& req) const {
 
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
-  auto const bbox = utls::get_bounding_box((**infra)->element_positions_);
+  auto const bbox = utls::get_bounding_box((*infra)->element_positions_);
 
   json_archive archive;
   archive.add()(cereal::make_nvp("boundingBox", bbox));
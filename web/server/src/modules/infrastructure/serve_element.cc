@@ -41,12 +41,12 @@ void add_data_to_cereal_archive(Archive& archive, element_data_t const& ed) {
 net::web_server::string_res_t infrastructure_module::serve_element(
     net::query_router::route_request const& req) const {
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
   auto const e_id = utls::parse_int<element_id>(req.path_params_[1]);
-  auto const& element = (**infra)->graph_.elements_[e_id];
+  auto const& element = (*infra)->graph_.elements_[e_id];
 
   json_archive archive;
 
@@ -60,7 +60,7 @@ net::web_server::string_res_t infrastructure_module::serve_element(
   }
 
   add_data_to_cereal_archive(archive.add(),
-                             (**infra)->graph_.element_data_[e_id]);
+                             (*infra)->graph_.element_data_[e_id]);
 
   return json_response(req, archive);
 }
@@ -16,12 +16,12 @@ net::web_server::string_res_t infrastructure_module::serve_exclusion_set(
   using namespace soro::infra;
 
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
   auto const es_id = utls::parse_int<exclusion_set::id>(req.path_params_[1]);
-  auto const& es = (**infra)->exclusion_.exclusion_sets_[es_id];
+  auto const& es = (*infra)->exclusion_.exclusion_sets_[es_id];
 
   json_archive archive;
   archive.add()(cereal::make_nvp("id", es_id),
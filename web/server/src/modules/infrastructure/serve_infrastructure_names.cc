@@ -1,6 +1,7 @@
 #include "soro/server/modules/infrastructure/infrastructure_module.h"
 
-#include "range/v3/view/map.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
 
 #include "net/web_server/responses.h"
 
@@ -12,8 +13,7 @@ namespace soro::server {
 net::web_server::string_res_t infrastructure_module::serve_infrastructure_names(
     net::query_router::route_request const& req) const {
   json_archive archive;
-  archive.add()(cereal::make_nvp("infrastructures",
-                                 infrastructures_ | ranges::views::keys));
+  archive.add()(cereal::make_nvp("infrastructures", names()));
   return json_response(req, archive);
 }
 
@@ -15,29 +15,29 @@ net::web_server::string_res_t infrastructure_module::serve_interlocking_route(
   using namespace soro::infra;
 
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
   auto const ir_id = utls::parse_int<station_route::id>(req.path_params_[1]);
-  if (ir_id >= (**infra)->interlocking_.routes_.size()) {
+  if (ir_id >= (*infra)->interlocking_.routes_.size()) {
     uLOG(utl::warn) << "Requesting station route " << ir_id
                     << " but there are only "
-                    << (**infra)->interlocking_.routes_.size()
+                    << (*infra)->interlocking_.routes_.size()
                     << " interlocking routes";
     return net::not_found_response(req);
   }
 
-  auto const& ir = (**infra)->interlocking_.routes_[ir_id];
-  auto gen = ir.iterate(**infra);
+  auto const& ir = (*infra)->interlocking_.routes_[ir_id];
+  auto nodes = ir.iterate(*infra);
 
   json_archive archive;
   archive.add()(
       cereal::make_nvp("id", ir.id_),
       cereal::make_nvp(
           "path",
-          gen | ranges::views::transform([&](auto&& rn) {
-            return (**infra)->element_positions_[rn.node_->element_->id()];
+          nodes | ranges::views::transform([&](auto&& rn) {
+            return (*infra)->element_positions_[rn.node_->element_->id()];
           })));
   return json_response(req, archive);
 }
@@ -0,0 +1,146 @@
+#include "soro/server/modules/infrastructure/infrastructure_module.h"
+
+#include <vector>
+
+#include "boost/beast/version.hpp"
+
+#include "rapidjson/writer.h"
+
+#include "net/web_server/responses.h"
+
+#include "soro/utls/parse_int.h"
+#include "soro/utls/result.h"
+
+#include "soro/server/query_params.h"
+#include "soro/server/string_output.h"
+
+namespace soro::server {
+
+using namespace soro::infra;
+
+// upper bound for k in nearest queries
+constexpr soro::size_t MAX_NEAREST = 100;
+
+// upper bound for the results of within queries, larger viewports get an
+// arbitrary subset of the overlapping leaves
+constexpr soro::size_t MAX_WITHIN = 10000;
+
+// all leaves without a filter, elements are accepted by their type
+spatial_index::filter get_filter(type_filter const& types,
+                                 infrastructure const& infra) {
+  if (types.empty()) {
+    return {};
+  }
+
+  return [&infra, types](spatial_index::item const& item) {
+    auto const element_type = item.kind_ == spatial_index::kind::ELEMENT
+                                  ? infra->graph_.elements_[item.id_]->type()
+                                  : type::INVALID;
+    return types.accepts(item.kind_, element_type);
+  };
+}
+
+// type, id and bounding box of every leaf, like the search results
+net::web_server::string_res_t leaves_response(
+    net::query_router::route_request const& req, infrastructure const& infra,
+    std::vector<spatial_index::leaf> const& leaves) {
+  namespace http = boost::beast::http;
+
+  net::web_server::string_res_t res{http::status::ok, req.version()};
+  res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+  res.set(http::field::content_type, "application/json");
+  res.keep_alive(req.keep_alive());
+
+  string_output os{res.body()};
+  rapidjson::Writer<string_output> writer(os);
+
+  auto const write_gps = [&](utls::gps const& p) {
+    writer.StartObject();
+    writer.String("lon");
+    writer.Double(p.lon_);
+    writer.String("lat");
+    writer.Double(p.lat_);
+    writer.EndObject();
+  };
+
+  auto const& index = infra->spatial_;
+
+  writer.StartArray();
+  for (auto const leaf : leaves) {
+    auto const& item = index.items_[leaf];
+    auto const& bb = index.boxes_[leaf];
+
+    writer.StartObject();
+    writer.String("type");
+    auto const kind = to_string(item.kind_);
+    writer.String(kind.data(), static_cast<rapidjson::SizeType>(kind.size()));
+    writer.String("id");
+    writer.Uint(item.id_);
+
+    writer.String("boundingBox");
+    writer.StartArray();
+    write_gps(bb.south_west_);
+    write_gps(bb.north_east_);
+    writer.EndArray();
+
+    if (item.kind_ == spatial_index::kind::ELEMENT) {
+      writer.String("elementType");
+      writer.String(
+          get_type_str(infra->graph_.elements_[item.id_]->type()).c_str());
+    }
+
+    writer.EndObject();
+  }
+  writer.EndArray();
+
+  res.prepare_payload();
+  return res;
+}
+
+net::web_server::string_res_t infrastructure_module::serve_within(
+    net::query_router::route_request const& req) const {
+  // infrastructure_name, bounding box, types
+  utls::expect(req.path_params_.size() == 3);
+
+  auto const infra = get_infra(req.path_params_.front());
+  if (infra == nullptr) {
+    return net::not_found_response(req);
+  }
+
+  auto const viewport = str_to_bounding_box(req.path_params_[1]);
+  if (!viewport) return net::bad_request_response(req);
+
+  auto const types = str_to_type_filter(req.path_params_[2]);
+  if (!types) return net::bad_request_response(req);
+
+  return leaves_response(
+      req, *infra,
+      (*infra)->spatial_.within(*viewport, get_filter(*types, *infra),
+                                MAX_WITHIN));
+}
+
+net::web_server::string_res_t infrastructure_module::serve_nearest(
+    net::query_router::route_request const& req) const {
+  // infrastructure_name, lon, lat, k, types
+  utls::expect(req.path_params_.size() == 5);
+
+  auto const infra = get_infra(req.path_params_.front());
+  if (infra == nullptr) {
+    return net::not_found_response(req);
+  }
+
+  utls::gps const position{.lon_ = str_to_decimal(req.path_params_[1]),
+                           .lat_ = str_to_decimal(req.path_params_[2])};
+
+  auto const k = utls::try_parse_int<soro::size_t>(req.path_params_[3]);
+  if (!k || *k > MAX_NEAREST) return net::bad_request_response(req);
+
+  auto const types = str_to_type_filter(req.path_params_[4]);
+  if (!types) return net::bad_request_response(req);
+
+  return leaves_response(
+      req, *infra,
+      (*infra)->spatial_.nearest(position, *k, get_filter(*types, *infra)));
+}
+
+}  // namespace soro::server
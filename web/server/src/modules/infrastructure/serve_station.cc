@@ -1,5 +1,8 @@
 #include "soro/server/modules/infrastructure/infrastructure_module.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "cereal/types/vector.hpp"
 
 #include "net/web_server/responses.h"
@@ -25,12 +28,21 @@ void CEREAL_SERIALIZE_FUNCTION_NAME(Archive& archive,
 template <typename Archive>
 void CEREAL_SERIALIZE_FUNCTION_NAME(
     Archive& archive,
-    soro::map<soro::string, soro::infra::station_route::ptr> const&
+    soro::hash_map<soro::string, soro::infra::station_route::ptr> const&
         station_routes) {
-  archive(cereal::make_size_tag(
-      static_cast<cereal::size_type>(station_routes.size())));
-
+  // sorted by id, the order of the hash map is not stable across builds
+  std::vector<station_route::ptr> sorted;
+  sorted.reserve(station_routes.size());
   for (auto const& [_, station_route] : station_routes) {
+    sorted.push_back(station_route);
+  }
+  std::ranges::sort(sorted, [](auto&& sr1, auto&& sr2) {
+    return sr1->id_ < sr2->id_;
+  });
+
+  archive(cereal::make_size_tag(static_cast<cereal::size_type>(sorted.size())));
+
+  for (auto const station_route : sorted) {
     archive(station_route);
   }
 }
@@ -44,20 +56,20 @@ net::web_server::string_res_t infrastructure_module::serve_station(
   using namespace soro::infra;
 
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
   auto const s_id = utls::parse_int<station::id>(req.path_params_[1]);
 
-  if (s_id >= (**infra)->stations_.size()) {
+  if (s_id >= (*infra)->stations_.size()) {
     uLOG(utl::warn) << "requesting station with id " << s_id
-                    << " but there are only " << (**infra)->stations_.size()
+                    << " but there are only " << (*infra)->stations_.size()
                     << " stations";
     return net::not_found_response(req);
   }
-  auto const& station = (**infra)->stations_[s_id];
-  auto const& irs = (**infra)->interlocking_.station_to_irs_[s_id];
+  auto const& station = (*infra)->stations_[s_id];
+  auto const& irs = (*infra)->interlocking_.station_to_irs_[s_id];
 
   json_archive archive;
   archive.add()(cereal::make_nvp("id", station->id_),
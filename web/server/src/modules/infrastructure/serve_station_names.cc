@@ -22,12 +22,12 @@ net::web_server::string_res_t infrastructure_module::serve_station_names(
     net::query_router::route_request const& req) const {
 
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
   json_archive archive;
-  archive.add()(cereal::make_nvp("stations", (**infra)->stations_));
+  archive.add()(cereal::make_nvp("stations", (*infra)->stations_));
   return json_response(req, archive);
 }
 
@@ -15,19 +15,19 @@ net::web_server::string_res_t infrastructure_module::serve_station_route(
   using namespace soro::infra;
 
   auto const infra = get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
+  if (infra == nullptr) {
     return net::not_found_response(req);
   }
 
   auto const sr_id = utls::parse_int<station_route::id>(req.path_params_[1]);
-  if (sr_id >= (**infra)->station_routes_.size()) {
+  if (sr_id >= (*infra)->station_routes_.size()) {
     uLOG(utl::warn) << "Requesting station route " << sr_id
                     << " but there are only "
-                    << (**infra)->station_routes_.size() << " station routes";
+                    << (*infra)->station_routes_.size() << " station routes";
     return net::not_found_response(req);
   }
 
-  auto const& sr = (**infra)->station_routes_[sr_id];
+  auto const& sr = (*infra)->station_routes_[sr_id];
 
   json_archive archive;
   archive.add()(
@@ -35,7 +35,7 @@ net::web_server::string_res_t infrastructure_module::serve_station_route(
       cereal::make_nvp("ds100", sr->station_->ds100_),
       cereal::make_nvp(
           "path", sr->nodes() | ranges::views::transform([&](auto&& n) {
-                    return (**infra)->element_positions_[n->element_->id()];
+                    return (*infra)->element_positions_[n->element_->id()];
                   })));
   return json_response(req, archive);
 }
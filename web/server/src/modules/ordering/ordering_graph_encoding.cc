@@ -0,0 +1,210 @@
+#include "soro/server/modules/ordering/ordering_graph_encoding.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "rapidjson/writer.h"
+
+#include "utl/logging.h"
+#include "utl/timer.h"
+
+#include "soro/utls/std_wrapper/sort.h"
+
+#include "soro/base/time.h"
+
+#include "soro/server/string_output.h"
+
+namespace soro::server {
+
+using namespace soro::simulation;
+
+std::string_view content_type(ordering_graph_format const format) {
+  switch (format) {
+    case ordering_graph_format::JSON: return "application/json";
+    case ordering_graph_format::BINARY: return ORDERING_GRAPH_BINARY_TYPE;
+  }
+
+  return "not reachable";
+}
+
+ordering_graph_format negotiate_ordering_graph_format(
+    std::string_view const accept) {
+  return accept.find(ORDERING_GRAPH_BINARY_TYPE) != std::string_view::npos
+             ? ordering_graph_format::BINARY
+             : ordering_graph_format::JSON;
+}
+
+using trip_entry = decltype(ordering_graph::trip_to_nodes_)::value_type;
+
+// trips ordered by their departure, the order the client expects
+std::vector<trip_entry const*> get_sorted_trips(ordering_graph const& og,
+                                                tt::timetable const& tt) {
+  std::vector<trip_entry const*> result;
+  result.reserve(og.trip_to_nodes_.size());
+  for (auto const& entry : og.trip_to_nodes_) {
+    result.push_back(&entry);
+  }
+
+  auto const departure = [&](trip_entry const* e) {
+    auto const& train = tt->trains_[e->first.train_id_];
+    return soro::relative_to_absolute(e->first.anchor_,
+                                      train.first_departure());
+  };
+
+  utls::sort(result, [&](auto&& e1, auto&& e2) {
+    return departure(e1) < departure(e2);
+  });
+
+  return result;
+}
+
+void write_json(std::string& out, ordering_graph const& og,
+                std::vector<trip_entry const*> const& trips,
+                soro::size_t const max_trip_length) {
+  string_output os{out};
+  rapidjson::Writer<string_output> writer(os);
+
+  writer.StartObject();
+
+  writer.String("attributes");
+  writer.StartObject();
+  writer.String("totalTrains");
+  writer.Uint(static_cast<unsigned>(trips.size()));
+  writer.String("maxTrainLength");
+  writer.Uint(max_trip_length);
+  writer.EndObject();
+
+  writer.String("nodes");
+  writer.StartArray();
+  for (auto relative_train_id = 0U; relative_train_id < trips.size();
+       ++relative_train_id) {
+    auto const [from, to] = trips[relative_train_id]->second;
+    for (auto n_id = from; n_id < to; ++n_id) {
+      auto const& node = og.nodes_[n_id];
+
+      writer.StartObject();
+      writer.String("key");
+      writer.Uint(node.id_);
+
+      writer.String("attributes");
+      writer.StartObject();
+      writer.String("train");
+      writer.Uint(node.train_id_);
+      writer.String("offset");
+      writer.Uint(node.id_ - from);
+      writer.String("relativeTrainId");
+      writer.Uint(relative_train_id);
+      writer.String("route");
+      writer.Uint(node.ir_id_);
+      writer.EndObject();
+
+      writer.EndObject();
+    }
+  }
+  writer.EndArray();
+
+  writer.String("edges");
+  writer.StartArray();
+  for (auto const* trip : trips) {
+    for (auto n_id = trip->second.first; n_id < trip->second.second; ++n_id) {
+      for (auto const target : og.nodes_[n_id].out_) {
+        writer.StartObject();
+        writer.String("source");
+        writer.Uint(n_id);
+        writer.String("target");
+        writer.Uint(target);
+        writer.EndObject();
+      }
+    }
+  }
+  writer.EndArray();
+
+  writer.EndObject();
+}
+
+void put_varint(std::string& out, uint64_t v) {
+  while (v >= 0x80U) {
+    out.push_back(static_cast<char>((v & 0x7FU) | 0x80U));
+    v >>= 7U;
+  }
+  out.push_back(static_cast<char>(v));
+}
+
+void write_binary(std::string& out, ordering_graph const& og,
+                  std::vector<trip_entry const*> const& trips,
+                  soro::size_t const max_trip_length) {
+  std::size_t nodes = 0;
+  std::size_t edges = 0;
+  for (auto const* trip : trips) {
+    nodes += trip->second.second - trip->second.first;
+    for (auto n_id = trip->second.first; n_id < trip->second.second; ++n_id) {
+      edges += og.nodes_[n_id].out_.size();
+    }
+  }
+
+  out.append(ORDERING_GRAPH_MAGIC);
+  put_varint(out, ORDERING_GRAPH_BINARY_VERSION);
+
+  put_varint(out, trips.size());
+  put_varint(out, nodes);
+  put_varint(out, edges);
+  put_varint(out, max_trip_length);
+
+  for (auto const* trip : trips) {
+    put_varint(out, trip->first.train_id_);
+    put_varint(out, trip->second.first);
+    put_varint(out, trip->second.second - trip->second.first);
+  }
+
+  for (auto const* trip : trips) {
+    for (auto n_id = trip->second.first; n_id < trip->second.second; ++n_id) {
+      put_varint(out, og.nodes_[n_id].ir_id_);
+    }
+  }
+
+  for (auto const* trip : trips) {
+    for (auto n_id = trip->second.first; n_id < trip->second.second; ++n_id) {
+      auto const& node = og.nodes_[n_id];
+      put_varint(out, node.out_.size());
+      for (auto const target : node.out_) {
+        put_varint(out, target);
+      }
+    }
+  }
+}
+
+void write_ordering_graph(std::string& out, ordering_graph const& og,
+                          tt::timetable const& tt,
+                          ordering_graph_format const format) {
+  utl::scoped_timer const timer("serializing ordering graph");
+
+  auto const trips = get_sorted_trips(og, tt);
+
+  soro::size_t max_trip_length = 0;
+  for (auto const* trip : trips) {
+    max_trip_length =
+        std::max(max_trip_length, trip->second.second - trip->second.first);
+  }
+
+  auto const before = out.size();
+
+  switch (format) {
+    case ordering_graph_format::JSON: {
+      // roughly the size of a node object and two edge objects
+      out.reserve(before + og.nodes_.size() * 200);
+      write_json(out, og, trips, max_trip_length);
+      break;
+    }
+
+    case ordering_graph_format::BINARY: {
+      out.reserve(before + og.nodes_.size() * 8);
+      write_binary(out, og, trips, max_trip_length);
+      break;
+    }
+  }
+
+  uLOG(utl::info) << "serialized ordering graph size: "
+                  << ((out.size() - before) / 1024UL) << " kB";
+}
+
+}  // namespace soro::server
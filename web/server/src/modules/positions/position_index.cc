@@ -0,0 +1,220 @@
+#include "soro/server/modules/positions/position_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "utl/parallel_for.h"
+#include "utl/timer.h"
+
+#include "soro/utls/sassert.h"
+
+#include "soro/runtime/runtime.h"
+
+namespace soro::server {
+
+using namespace soro::tt;
+
+std::vector<position_index::waypoint> get_waypoints(
+    train const& train, infra::infrastructure const& infra,
+    tt::timetable const& tt, runtime::interval_cache& cache) {
+  // infrastructures without layout have no positions at all
+  if (infra->element_positions_.empty()) {
+    return {};
+  }
+
+  auto const times = runtime::runtime_calculation(
+      train, train.physics(*tt), infra, infra::type_set{infra::all_types()},
+      cache);
+
+  std::vector<position_index::waypoint> result;
+  result.reserve(times.times_.size());
+
+  for (auto const& ts : times.times_) {
+    auto const& position = infra->element_positions_[ts.element_->id()];
+    if (!position.valid()) {
+      continue;
+    }
+
+    utls::sassert(result.empty() || result.back().arrival_ <= ts.arrival_,
+                  "timestamps of train {} not sorted", train.id_);
+
+    result.push_back({.arrival_ = ts.arrival_,
+                      .departure_ = ts.departure_,
+                      .position_ = position});
+  }
+
+  return result;
+}
+
+soro::size_t get_slice(std::span<position_index::waypoint const> waypoints,
+                       relative_time const t) {
+  return static_cast<soro::size_t>((t - waypoints.front().arrival_) /
+                                   position_index::SLICE_WIDTH);
+}
+
+// every slice gets the bounding box of all segments overlapping it, as trains
+// move in straight lines between two waypoints this covers all positions
+std::vector<utls::bounding_box> get_slices(
+    std::span<position_index::waypoint const> waypoints) {
+  if (waypoints.empty()) {
+    return {};
+  }
+
+  std::vector<utls::bounding_box> result(
+      get_slice(waypoints, waypoints.back().departure_) + 1);
+
+  for (auto it = std::begin(waypoints); it != std::end(waypoints); ++it) {
+    auto const next = std::next(it);
+    auto const until =
+        next == std::end(waypoints) ? it->departure_ : next->arrival_;
+
+    for (auto s = get_slice(waypoints, it->arrival_);
+         s <= get_slice(waypoints, until); ++s) {
+      result[s].extend(it->position_);
+      if (next != std::end(waypoints)) {
+        result[s].extend(next->position_);
+      }
+    }
+  }
+
+  return result;
+}
+
+position_index::position_index(infra::infrastructure const& infra,
+                               tt::timetable const& tt) {
+  utl::scoped_timer const timer("creating position index");
+
+  auto const& trains = tt->trains_;
+
+  runtime::interval_cache cache;
+  std::vector<std::vector<waypoint>> train_waypoints(trains.size());
+  utl::parallel_for_run(trains.size(), [&](auto&& idx) {
+    train_waypoints[idx] = get_waypoints(trains[idx], infra, tt, cache);
+  });
+
+  waypoint_offsets_.reserve(trains.size() + 1);
+  waypoint_offsets_.emplace_back(0);
+  slice_offsets_.reserve(trains.size() + 1);
+  slice_offsets_.emplace_back(0);
+
+  for (auto const& train : trains) {
+    utls::sassert(train.id_ + 1 == waypoint_offsets_.size(),
+                  "train id {} does not match its position", train.id_);
+
+    auto const& wps = train_waypoints[train.id_];
+
+    if (!wps.empty()) {
+      max_early_ = std::max(max_early_,
+                            duration2{train.first_departure() -
+                                      wps.front().arrival_});
+      max_late_ = std::max(
+          max_late_, duration2{wps.back().departure_ - train.last_arrival()});
+    }
+
+    waypoints_.insert(std::end(waypoints_), std::begin(wps), std::end(wps));
+    waypoint_offsets_.emplace_back(
+        static_cast<soro::size_t>(waypoints_.size()));
+
+    auto const slices = get_slices(wps);
+    slices_.insert(std::end(slices_), std::begin(slices), std::end(slices));
+    slice_offsets_.emplace_back(static_cast<soro::size_t>(slices_.size()));
+  }
+}
+
+std::span<position_index::waypoint const> position_index::waypoints(
+    train::id const train_id) const {
+  utls::expect(train_id + 1 < waypoint_offsets_.size(),
+               "train id {} not in position index", train_id);
+
+  return {waypoints_.data() + waypoint_offsets_[train_id],
+          waypoints_.data() + waypoint_offsets_[train_id + 1]};
+}
+
+std::span<utls::bounding_box const> position_index::slices(
+    train::id const train_id) const {
+  utls::expect(train_id + 1 < slice_offsets_.size(),
+               "train id {} not in position index", train_id);
+
+  return {slices_.data() + slice_offsets_[train_id],
+          slices_.data() + slice_offsets_[train_id + 1]};
+}
+
+bool is_running(std::span<position_index::waypoint const> waypoints,
+                relative_time const t) {
+  return !waypoints.empty() && waypoints.front().arrival_ <= t &&
+         t <= waypoints.back().departure_;
+}
+
+std::optional<train_position> position_index::position(
+    train::trip const& trip, absolute_time const t) const {
+  auto const wps = waypoints(trip.train_id_);
+  auto const rel = absolute_to_relative(trip.anchor_, t);
+
+  if (!is_running(wps, rel)) {
+    return std::nullopt;
+  }
+
+  // the first waypoint arrives at or before rel, so next is never the first
+  auto const next = std::upper_bound(
+      std::begin(wps), std::end(wps), rel,
+      [](auto&& time, auto&& wp) { return time < wp.arrival_; });
+  auto const& prev = *std::prev(next);
+
+  if (rel <= prev.departure_ || next == std::end(wps)) {
+    return train_position{.trip_ = trip,
+                          .position_ = prev.position_,
+                          .halting_ = prev.arrival_ < prev.departure_};
+  }
+
+  auto const progress =
+      static_cast<utls::gps::precision>((rel - prev.departure_).count()) /
+      static_cast<utls::gps::precision>(
+          (next->arrival_ - prev.departure_).count());
+
+  auto const& from = prev.position_;
+  auto const& to = next->position_;
+  return train_position{
+      .trip_ = trip,
+      .position_ = {.lon_ = from.lon_ + progress * (to.lon_ - from.lon_),
+                    .lat_ = from.lat_ + progress * (to.lat_ - from.lat_)},
+      .halting_ = false};
+}
+
+std::vector<train_position> position_index::positions(
+    tt::timetable const& tt, absolute_time const t,
+    utls::bounding_box const& viewport) const {
+  std::vector<train_position> result;
+
+  auto const trips = tt->trip_index_.overlapping(
+      interval{.start_ = t - max_late_, .end_ = t + max_early_});
+
+  for (auto const& trip : trips) {
+    auto const wps = waypoints(trip.train_id_);
+    auto const rel = absolute_to_relative(trip.anchor_, t);
+
+    if (!is_running(wps, rel) ||
+        !slices(trip.train_id_)[get_slice(wps, rel)].overlaps(viewport)) {
+      continue;
+    }
+
+    auto const pos = position(trip, t);
+    if (pos.has_value() && viewport.contains(pos->position_)) {
+      result.push_back(*pos);
+    }
+  }
+
+  return result;
+}
+
+std::vector<train_position> position_index::positions(
+    tt::timetable const& tt, absolute_time const t) const {
+  // contains every valid position
+  utls::bounding_box const everything{
+      .south_west_ = {.lon_ = utls::gps::INVALID, .lat_ = utls::gps::INVALID},
+      .north_east_ = {.lon_ = utls::gps::MAX_INVALID,
+                      .lat_ = utls::gps::MAX_INVALID}};
+
+  return positions(tt, t, everything);
+}
+
+}  // namespace soro::server
@@ -0,0 +1,41 @@
+#include "soro/server/modules/positions/positions_module.h"
+
+#include "utl/timer.h"
+
+namespace soro::server {
+
+std::shared_ptr<position_index const> positions_module::get_position_index(
+    std::string_view const infrastructure_name,
+    std::string_view const timetable_name) const {
+  return indices_.get(get_timetable_key(infrastructure_name, timetable_name));
+}
+
+positions_module get_positions_module(infrastructure_module const& infra_m,
+                                      timetable_module const& timetable_m) {
+  utl::scoped_timer const timer("creating positions module");
+
+  positions_module mod;
+
+  for (auto const& names : timetable_m.names_) {
+    auto const& infra_name = names.first;
+    for (auto const& timetable_name : names.second) {
+      auto load = [&infra_m, &timetable_m, infra_name, timetable_name]()
+          -> std::shared_ptr<position_index const> {
+        auto const infra = infra_m.get_infra(infra_name);
+        auto const tt = timetable_m.get_timetable(infra_name, timetable_name);
+        if (infra == nullptr || tt == nullptr) {
+          return nullptr;
+        }
+
+        return std::make_shared<position_index const>(*infra, *tt);
+      };
+
+      mod.indices_.add(get_timetable_key(infra_name, timetable_name), 0,
+                       std::move(load));
+    }
+  }
+
+  return mod;
+}
+
+}  // namespace soro::server
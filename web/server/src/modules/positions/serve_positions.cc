@@ -0,0 +1,169 @@
+#include "soro/server/modules/positions/positions_module.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "boost/beast/version.hpp"
+
+#include "rapidjson/writer.h"
+
+#include "net/web_server/responses.h"
+
+#include "soro/utls/result.h"
+
+#include "soro/base/time.h"
+
+#include "soro/server/query_params.h"
+#include "soro/server/string_output.h"
+
+namespace soro::server {
+
+struct playback {
+  absolute_time from_;
+  absolute_time to_;
+  duration2 step_;
+  std::optional<utls::bounding_box> viewport_;
+};
+
+utls::result<playback> params_to_playback(
+    std::vector<std::string> const& params) {
+  playback result;
+
+  auto const from = str_to_absolute_time(params[2]);
+  if (!from) return utls::propagate(from);
+  result.from_ = *from;
+
+  auto const to = str_to_absolute_time(params[3]);
+  if (!to) return utls::propagate(to);
+  result.to_ = *to;
+
+  auto const step = utls::try_parse_int<duration2::rep>(params[4]);
+  if (!step) return utls::propagate(step);
+  result.step_ = duration2{*step};
+
+  if (result.from_ > result.to_ ||
+      (result.from_ != result.to_ && result.step_ <= duration2::zero())) {
+    return utls::unexpected(std::errc::invalid_argument);
+  }
+
+  auto const frames =
+      result.from_ == result.to_
+          ? 1
+          : (result.to_ - result.from_) / result.step_ + 1;
+  if (static_cast<std::size_t>(frames) > positions_module::MAX_FRAMES) {
+    return utls::unexpected(std::errc::result_out_of_range);
+  }
+
+  if (!params[5].empty()) {
+    auto const viewport = str_to_bounding_box(params[5]);
+    if (!viewport) return utls::propagate(viewport);
+    result.viewport_ = *viewport;
+  }
+
+  return result;
+}
+
+// every frame is a GeoJSON feature collection of points
+void write_frames(std::string& out, playback const& pb,
+                  position_index const& index, tt::timetable const& tt) {
+  string_output os{out};
+  rapidjson::Writer<string_output> writer(os);
+
+  writer.StartObject();
+  writer.String("frames");
+  writer.StartArray();
+
+  for (auto t = pb.from_; t <= pb.to_; t += pb.step_) {
+    auto const positions = pb.viewport_.has_value()
+                               ? index.positions(tt, t, *pb.viewport_)
+                               : index.positions(tt, t);
+
+    writer.StartObject();
+    writer.String("time");
+    writer.Int64(absolute_time_to_rep(t));
+
+    writer.String("type");
+    writer.String("FeatureCollection");
+    writer.String("features");
+    writer.StartArray();
+    for (auto const& p : positions) {
+      writer.StartObject();
+      writer.String("type");
+      writer.String("Feature");
+
+      writer.String("geometry");
+      writer.StartObject();
+      writer.String("type");
+      writer.String("Point");
+      writer.String("coordinates");
+      writer.StartArray();
+      writer.Double(p.position_.lon_);
+      writer.Double(p.position_.lat_);
+      writer.EndArray();
+      writer.EndObject();
+
+      writer.String("properties");
+      writer.StartObject();
+      writer.String("trainId");
+      writer.Uint(p.trip_.train_id_);
+      writer.String("trainNumber");
+      writer.Uint(tt->trains_[p.trip_.train_id_].number_.main_);
+      writer.String("anchor");
+      writer.Int64(absolute_time_to_rep(p.trip_.anchor_));
+      writer.String("halting");
+      writer.Bool(p.halting_);
+      writer.EndObject();
+
+      writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+
+    // a single frame for from == to, where the step may be zero
+    if (pb.from_ == pb.to_) {
+      break;
+    }
+  }
+
+  writer.EndArray();
+  writer.EndObject();
+}
+
+net::web_server::string_res_t positions_module::serve_positions(
+    net::query_router::route_request const& req,
+    timetable_module const& timetable_m) const {
+  // infrastructure_name, timetable_name, from, to, step, viewport
+  utls::expect(req.path_params_.size() == 6);
+
+  std::string_view const infra_name = req.path_params_[0];
+  std::string_view const timetable_name = req.path_params_[1];
+
+  auto const timetable = timetable_m.get_timetable(infra_name, timetable_name);
+  if (timetable == nullptr) {
+    return net::not_found_response(req);
+  }
+
+  auto const pb = params_to_playback(req.path_params_);
+  if (!pb) return net::bad_request_response(req);
+
+  auto const index = get_position_index(infra_name, timetable_name);
+  if (index == nullptr) {
+    return net::not_found_response(req);
+  }
+
+  namespace http = boost::beast::http;
+
+  net::web_server::string_res_t res{http::status::ok, req.version()};
+  res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+  res.set(http::field::content_type, "application/json");
+  res.keep_alive(req.keep_alive());
+
+  write_frames(res.body(), *pb, *index, *timetable);
+  res.prepare_payload();
+
+  return res;
+}
+
+}  // namespace soro::server
@@ -0,0 +1,297 @@
+#include "soro/server/modules/search/search_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "utl/enumerate.h"
+#include "utl/timer.h"
+
+namespace soro::server {
+
+using namespace soro::infra;
+
+// only queries this long are matched by their trigrams
+constexpr std::size_t MIN_FUZZY_LENGTH = 3;
+
+// shared trigrams of query and key divided by the trigrams of both
+constexpr float MIN_SIMILARITY = 0.25F;
+
+// the begin and end of a key are part of its trigrams, every key has one
+constexpr char KEY_BEGIN = '\x01';
+constexpr char KEY_END = '\x02';
+
+std::string to_search_key(std::string_view const name) {
+  std::string result;
+  result.reserve(name.size());
+
+  for (auto const c : name) {
+    auto const uc = static_cast<unsigned char>(c);
+    if (uc >= 0x80) {
+      result.push_back(c);
+    } else if (std::isalnum(uc) != 0) {
+      result.push_back(static_cast<char>(std::tolower(uc)));
+    }
+  }
+
+  return result;
+}
+
+// sorted and unique
+std::vector<uint32_t> get_trigrams(std::string_view const key) {
+  std::string padded;
+  padded.reserve(key.size() + 2);
+  padded.push_back(KEY_BEGIN);
+  padded.append(key);
+  padded.push_back(KEY_END);
+
+  auto const byte = [&](std::size_t const idx) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(padded[idx]));
+  };
+
+  std::vector<uint32_t> result;
+  for (std::size_t i = 0; i + 3 <= padded.size(); ++i) {
+    result.push_back(byte(i) << 16U | byte(i + 1) << 8U | byte(i + 2));
+  }
+
+  std::ranges::sort(result);
+  result.erase(std::unique(std::begin(result), std::end(result)),
+               std::end(result));
+
+  return result;
+}
+
+void add_entries(search_index_t& index, infrastructure const& infra) {
+  using kind = spatial_index::kind;
+
+  // items without a position are not part of the spatial index
+  std::map<spatial_index::item, utls::bounding_box> boxes;
+  auto const& spatial = infra->spatial_;
+  for (auto leaf = 0U; leaf < spatial.size(); ++leaf) {
+    boxes.emplace(spatial.items_[leaf], spatial.boxes_[leaf]);
+  }
+
+  auto const add = [&](kind const k, soro::size_t const id,
+                       std::string_view const name,
+                       type const element_type = type::INVALID) {
+    auto key = to_search_key(name);
+    if (key.empty()) {
+      return;
+    }
+
+    auto const box = boxes.find({.kind_ = k, .id_ = id});
+    index.entries_.push_back(
+        {.kind_ = k,
+         .element_type_ = element_type,
+         .id_ = id,
+         .bounding_box_ = box == std::end(boxes) ? utls::bounding_box{}
+                                                 : box->second});
+    index.names_.emplace_back(name);
+    index.keys_.emplace_back(key);
+  };
+
+  for (auto const s : infra->stations_) {
+    add(kind::STATION, s->id_, s->ds100_);
+  }
+
+  for (auto const [id, full] : utl::enumerate(infra->full_station_names_)) {
+    auto const s = infra->stations_[static_cast<soro::size_t>(id)];
+    if (s->ds100_ != full) {
+      add(kind::STATION, s->id_, full);
+    }
+  }
+
+  for (auto const e : infra->graph_.elements_) {
+    auto const id = e->id();
+    auto const add_element = [&](std::string_view const name) {
+      add(kind::ELEMENT, id, name, e->type());
+    };
+
+    add_element(std::to_string(id));
+
+    if (e->is(type::MAIN_SIGNAL)) {
+      add_element(infra->graph_.element_data_[id].as<main_signal>().name_);
+    }
+
+    if (e->is(type::SIMPLE_SWITCH)) {
+      add_element(infra->graph_.element_data_[id].as<switch_data>().name_);
+    }
+
+    if (e->is(type::HALT)) {
+      auto const& data = infra->graph_.element_data_[id].as<halt>();
+      add_element(data.name_);
+      add_element(data.identifier_extern_);
+      add_element(data.identifier_operational_);
+    }
+  }
+
+  for (auto const sr : infra->station_routes_) {
+    add(kind::STATION_ROUTE, sr->id_, sr->name_);
+  }
+
+  for (auto const& ir : infra->interlocking_.routes_) {
+    add(kind::INTERLOCKING_ROUTE, ir.id_, std::to_string(ir.id_));
+  }
+}
+
+void add_keys(search_index_t& index) {
+  auto const key = [&](soro::size_t const e) {
+    return std::string_view{index.keys_[e]};
+  };
+
+  index.by_key_.resize(index.entries_.size());
+  std::iota(std::begin(index.by_key_), std::end(index.by_key_), 0);
+  std::stable_sort(
+      std::begin(index.by_key_), std::end(index.by_key_),
+      [&](auto&& e1, auto&& e2) { return key(e1) < key(e2); });
+}
+
+void add_trigrams(search_index_t& index) {
+  std::vector<std::pair<uint32_t, soro::size_t>> trigram_entries;
+  for (auto e = 0U; e < index.keys_.size(); ++e) {
+    for (auto const trigram : get_trigrams(index.keys_[e])) {
+      trigram_entries.emplace_back(trigram, e);
+    }
+  }
+
+  // sorted by trigram and then by entry, duplicates are removed already
+  std::ranges::sort(trigram_entries);
+
+  for (auto const& [trigram, e] : trigram_entries) {
+    if (index.trigrams_.empty() || index.trigrams_.back() != trigram) {
+      index.trigrams_.push_back(trigram);
+      index.trigram_offsets_.push_back(
+          static_cast<soro::size_t>(index.postings_.size()));
+    }
+    index.postings_.push_back(e);
+  }
+
+  index.trigram_offsets_.push_back(
+      static_cast<soro::size_t>(index.postings_.size()));
+}
+
+search_index_t make_search_index(infrastructure const& infra) {
+  utl::scoped_timer const timer("creating search index");
+
+  search_index_t result;
+
+  add_entries(result, infra);
+  add_keys(result);
+  add_trigrams(result);
+
+  return result;
+}
+
+search_index::search_index(infrastructure const& infra) {
+  this->mem_ = make_search_index(infra);
+  this->access_ = std::addressof(std::get<search_index_t>(mem_));
+}
+
+std::vector<search_index_t::match> search_index_t::search(
+    search_query const& query) const {
+  auto const q = to_search_key(query.text_);
+  if (q.empty() || query.limit_ == 0) {
+    return {};
+  }
+
+  auto const key = [this](soro::size_t const e) {
+    return std::string_view{keys_[e]};
+  };
+
+  auto const accept = [&](soro::size_t const e) {
+    auto const& entry = entries_[e];
+    return query.types_.accepts(entry.kind_, entry.element_type_) &&
+           (!query.viewport_.has_value() ||
+            entry.bounding_box_.overlaps(*query.viewport_));
+  };
+
+  std::vector<match> matches;
+
+  // all keys starting with the query are one range of the sorted keys
+  auto it = std::lower_bound(
+      std::begin(by_key_), std::end(by_key_), q,
+      [&](auto&& e, auto&& value) { return key(e) < value; });
+  for (; it != std::end(by_key_) && key(*it).starts_with(q); ++it) {
+    if (!accept(*it)) {
+      continue;
+    }
+
+    auto const length = static_cast<float>(key(*it).size());
+    matches.push_back(
+        {.entry_ = *it,
+         .score_ = 2.0F + static_cast<float>(q.size()) / length});
+  }
+
+  if (q.size() >= MIN_FUZZY_LENGTH) {
+    auto const q_trigrams = get_trigrams(q);
+
+    // entry -> trigrams shared with the query
+    std::unordered_map<soro::size_t, soro::size_t> shared;
+    for (auto const trigram : q_trigrams) {
+      auto const t = std::lower_bound(std::begin(trigrams_),
+                                      std::end(trigrams_), trigram);
+      if (t == std::end(trigrams_) || *t != trigram) {
+        continue;
+      }
+
+      auto const idx =
+          static_cast<std::size_t>(std::distance(std::begin(trigrams_), t));
+      for (auto p = trigram_offsets_[idx]; p < trigram_offsets_[idx + 1];
+           ++p) {
+        ++shared[postings_[p]];
+      }
+    }
+
+    auto const q_count = static_cast<float>(q_trigrams.size());
+    for (auto const& [e, count] : shared) {
+      // prefix matches are found already. the similarity is at most
+      // shared / query trigrams, no need to count the trigrams of the key
+      if (static_cast<float>(count) < MIN_SIMILARITY * q_count ||
+          key(e).starts_with(q) || !accept(e)) {
+        continue;
+      }
+
+      auto const shared_count = static_cast<float>(count);
+      auto const similarity =
+          shared_count /
+          (q_count + static_cast<float>(get_trigrams(key(e)).size()) -
+           shared_count);
+
+      if (similarity >= MIN_SIMILARITY) {
+        matches.push_back({.entry_ = e, .score_ = similarity});
+      }
+    }
+  }
+
+  // best score first, then shorter names, then the order of the entries
+  std::ranges::sort(matches, [&](auto&& m1, auto&& m2) {
+    return std::tuple{-m1.score_, names_[m1.entry_].size(), m1.entry_} <
+           std::tuple{-m2.score_, names_[m2.entry_].size(), m2.entry_};
+  });
+
+  // the best name of every item, for items with several names
+  std::vector<match> result;
+  std::set<spatial_index::item> seen;
+  for (auto const& m : matches) {
+    auto const& entry = entries_[m.entry_];
+    if (!seen.insert({.kind_ = entry.kind_, .id_ = entry.id_}).second) {
+      continue;
+    }
+
+    result.push_back(m);
+    if (result.size() == query.limit_) {
+      break;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace soro::server
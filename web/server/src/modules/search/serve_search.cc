@@ -1,66 +1,102 @@
 #include "soro/server/modules/search/search_module.h"
 
+#include "cereal/types/string.hpp"
 #include "cereal/types/vector.hpp"
 
 #include "net/web_server/responses.h"
 #include "utl/to_vec.h"
 
+#include "soro/utls/parse_int.h"
+
 #include "soro/server/cereal/cereal_extern.h"
 #include "soro/server/cereal/json_archive.h"
 
 namespace soro::server {
 
+struct search_result {
+  std::string_view type_;
+  std::string_view name_;
+  soro::size_t id_;
+  utls::bounding_box bounding_box_;
+  std::string element_type_;
+};
+
 // make prologue and epilogue no-ops to be able to serialize a
 // vector of search results without a root object
-void prologue(cereal::JSONOutputArchive&,
-              std::vector<search_module::result> const&) {}
+void prologue(cereal::JSONOutputArchive&, std::vector<search_result> const&) {}
 
-void epilogue(cereal::JSONOutputArchive&,
-              std::vector<search_module::result> const&) {}
+void epilogue(cereal::JSONOutputArchive&, std::vector<search_result> const&) {}
 
 template <typename Archive>
-void CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar,
-                                    search_module::result const& e) {
-  ar(cereal::make_nvp("type", search_module::result::type_to_string(e.type_)),
-     cereal::make_nvp("name", e.name_), cereal::make_nvp("id", e.id_),
-     cereal::make_nvp("boundingBox", e.bounding_box_),
-     cereal::make_nvp("elementType", e.element_type_));
+void CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, search_result const& r) {
+  ar(cereal::make_nvp("type", std::string{r.type_}),
+     cereal::make_nvp("name", std::string{r.name_}),
+     cereal::make_nvp("id", r.id_),
+     cereal::make_nvp("boundingBox", r.bounding_box_),
+     cereal::make_nvp("elementType", r.element_type_));
 }
 
-std::vector<search_module::result> search(std::string const& query,
-                                          search_module::context const& context,
-                                          infra::infrastructure const&) {
-  return utl::to_vec(context.guesser_->guess_match(query),
-                     [&](auto&& m) { return context.results_[m.index]; });
-}
+// infrastructure_name, search_string[, types, bounding box, limit]
+utls::result<search_query> get_search_query(
+    net::query_router::route_request const& req) {
+  search_query query{.text_ = req.path_params_[1]};
 
-net::web_server::string_res_t search_module::serve_search(
-    net::query_router::route_request const& req,
-    infrastructure_module const& infra_m) const {
+  if (req.path_params_.size() == 2) {
+    return query;
+  }
 
-  auto const infra = infra_m.get_infra(req.path_params_.front());
-  if (!infra.has_value()) {
-    return net::not_found_response(req);
+  auto const types = str_to_type_filter(req.path_params_[2]);
+  if (!types) return utls::propagate(types);
+  query.types_ = *types;
+
+  if (!req.path_params_[3].empty()) {
+    auto const viewport = str_to_bounding_box(req.path_params_[3]);
+    if (!viewport) return utls::propagate(viewport);
+    query.viewport_ = *viewport;
   }
 
-  auto const context_it = contexts_.find(req.path_params_.front());
-  if (context_it == contexts_.end()) {
+  auto const limit = utls::try_parse_int<soro::size_t>(req.path_params_[4]);
+  if (!limit || *limit > search_module::MAX_LIMIT) {
+    return utls::unexpected(std::errc::invalid_argument);
+  }
+  query.limit_ = *limit;
+
+  return query;
+}
+
+net::web_server::string_res_t search_module::serve_search(
+    net::query_router::route_request const& req) const {
+  utls::expect(req.path_params_.size() == 2 || req.path_params_.size() == 5);
+
+  auto const index = indices_.get(req.path_params_.front());
+  if (index == nullptr) {
     return net::not_found_response(req);
   }
 
-  if (req.path_params_.back().size() < 3) {
+  auto const query = get_search_query(req);
+  if (!query) {
     return net::bad_request_response(req);
   }
 
-  auto const search_result =
-      search(req.path_params_.back(), context_it->second, **infra);
-
-  if (search_result.empty()) {
+  auto const results =
+      utl::to_vec((*index)->search(*query), [&](auto&& match) {
+        auto const& entry = (*index)->entries_[match.entry_];
+        return search_result{
+            .type_ = to_string(entry.kind_),
+            .name_ = (*index)->names_[match.entry_],
+            .id_ = entry.id_,
+            .bounding_box_ = entry.bounding_box_,
+            .element_type_ = entry.element_type_ == infra::type::INVALID
+                                 ? std::string{}
+                                 : infra::get_type_str(entry.element_type_)};
+      });
+
+  if (results.empty()) {
     return json_response(req, "[]");
   }
 
   json_archive archive;
-  archive.add()(search_result);
+  archive.add()(results);
   return json_response(req, archive);
 }
 
@@ -1,41 +1,153 @@
 #include "soro/server/modules/tiles/import/import.h"
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "utl/logging.h"
+#include "utl/parallel_for.h"
 #include "utl/timer.h"
 
+#include "tiles/constants.h"
 #include "tiles/db/clear_database.h"
 #include "tiles/db/database_stats.h"
 #include "tiles/db/feature_inserter_mt.h"
 #include "tiles/db/feature_pack.h"
+#include "tiles/db/layer_names.h"
 #include "tiles/db/pack_file.h"
 #include "tiles/db/prepare_tiles.h"
 #include "tiles/db/tile_database.h"
-#include "tiles/osm/feature_handler.h"
-#include "tiles/osm/load_osm.h"
+#include "tiles/feature/feature.h"
+#include "tiles/fixed/convert.h"
+
+#include "soro/server/modules/tiles/osm_export/interpolation.h"
 
 namespace soro::server {
 
-void import_tiles(import_settings const& settings) {
+using namespace soro::infra;
+
+tiles::fixed_xy to_fixed(utls::gps const& pos) {
+  return tiles::latlng_to_fixed({pos.lat_, pos.lon_});
+}
+
+struct feature_writer {
+  void insert(std::string const& layer, uint64_t const id,
+              std::map<std::string, std::string> meta,
+              tiles::fixed_geometry geometry) {
+    inserter_.insert(tiles::feature{
+        .id_ = id,
+        .layer_ = layer_names_.get_layer_idx(layer),
+        .zoom_levels_ = {MIN_ZOOM_LEVEL, tiles::kMaxZoomLevel},
+        .meta_ = std::move(meta),
+        .geometry_ = std::move(geometry)});
+  }
+
+  void insert_station(station::ptr const station, infrastructure const& infra) {
+    auto const& pos = infra->station_positions_[station->id_];
+    insert(STATION_LAYER, station->id_,
+           {{"id", tiles::encode_integer(station->id_)},
+            {"name", tiles::encode_string(std::string{station->ds100_})}},
+           tiles::fixed_point{{to_fixed(pos)}});
+  }
+
+  void insert_element(element_ptr const e, infrastructure const& infra) {
+    auto const& pos = infra->element_positions_[e->id()];
+    insert(e->get_type_str(), e->id(),
+           {{"id", tiles::encode_integer(e->id())},
+            {"rising", tiles::encode_bool(e->rising())}},
+           tiles::fixed_point{{to_fixed(pos)}});
+  }
+
+  // tracks between two stations are interpolated
+  void insert_track(element_ptr const from, element_ptr const to,
+                    infrastructure const& infra) {
+    auto const& positions = infra->element_positions_;
+
+    std::vector<tiles::fixed_xy> line;
+    line.push_back(to_fixed(positions[from->id()]));
+
+    if (infra->element_to_station_.at(from->id()) !=
+        infra->element_to_station_.at(to->id())) {
+      auto const interpolation =
+          osm_export::compute_interpolation(from, to, positions);
+      for (auto const& point : interpolation.points_) {
+        line.push_back(to_fixed(point));
+      }
+    }
+
+    line.push_back(to_fixed(positions[to->id()]));
+
+    // unique as long as element ids fit in 32 bits
+    auto const id = (uint64_t{from->id()} << 32U) | to->id();
+
+    insert(RAIL_LAYER, id, {{"rail", tiles::encode_string("primary")}},
+           tiles::fixed_polyline{std::move(line)});
+  }
+
+  tiles::feature_inserter_mt& inserter_;
+  tiles::layer_names_builder& layer_names_;
+};
+
+// every track once, even if only one of its ends lists the other
+bool owns_track(element_ptr const e, element_ptr const neighbour) {
+  if (e->id() < neighbour->id()) {
+    return true;
+  }
+
+  auto const back = neighbour->neighbours();
+  return std::find(std::begin(back), std::end(back), e) == std::end(back);
+}
+
+void insert_features(infrastructure const& infra,
+                     tiles::feature_inserter_mt& inserter,
+                     tiles::layer_names_builder& layer_names) {
+  feature_writer writer{.inserter_ = inserter, .layer_names_ = layer_names};
+
+  auto const& stations = infra->stations_;
+  utl::parallel_for_run(stations.size(), [&](auto&& idx) {
+    writer.insert_station(stations[static_cast<soro::size_t>(idx)], infra);
+  });
+
+  auto const& elements = infra->graph_.elements_;
+  utl::parallel_for_run(elements.size(), [&](auto&& idx) {
+    auto const e = elements[static_cast<soro::size_t>(idx)];
+
+    writer.insert_element(e, infra);
+
+    for (auto const neighbour : e->neighbours()) {
+      if (neighbour != nullptr && owns_track(e, neighbour)) {
+        writer.insert_track(e, neighbour, infra);
+      }
+    }
+  });
+}
+
+void import_tiles(infrastructure const& infra, fs::path const& db_path) {
   utl::scoped_timer const timer("importing tiles");
-  tiles::check_profile(settings.osm_profile_.string());
 
-  tiles::clear_database(settings.db_path_.string(), tiles::kDefaultSize);
-  tiles::clear_pack_file(settings.db_path_.string().c_str());
+  tiles::clear_database(db_path.string(), tiles::kDefaultSize);
+  tiles::clear_pack_file(db_path.string().c_str());
   timer.print("cleared database");
 
-  lmdb::env db_env = tiles::make_tile_database(
-      settings.db_path_.string().c_str(), tiles::kDefaultSize);
+  lmdb::env db_env =
+      tiles::make_tile_database(db_path.string().c_str(), tiles::kDefaultSize);
   tiles::tile_db_handle db_handle{db_env};
-  tiles::pack_handle pack_handle{settings.db_path_.string().c_str()};
+  tiles::pack_handle pack_handle{db_path.string().c_str()};
 
   {
     tiles::feature_inserter_mt inserter{
         tiles::dbi_handle{db_handle, db_handle.features_dbi_opener()},
         pack_handle};
+    tiles::layer_names_builder layer_names;
+
+    insert_features(infra, inserter, layer_names);
+
+    auto txn = db_handle.make_txn();
+    layer_names.store(db_handle, txn);
+    txn.commit();
 
-    load_osm(db_handle, inserter, settings.osm_path_.string(),
-             settings.osm_profile_.string(), settings.tmp_dir_.string());
-    timer.print("loaded features");
+    timer.print("inserted features");
   }
 
   database_stats(db_handle, pack_handle);
@@ -49,4 +161,4 @@ void import_tiles(import_settings const& settings) {
   timer.print("prepared tiles");
 }
 
-}  // namespace soro::server
\ No newline at end of file
+}  // namespace soro::server
@@ -1,20 +1,29 @@
 #include "soro/server/modules/tiles/tiles_module.h"
 
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <system_error>
+
+#include "fmt/format.h"
+
 #include "net/web_server/responses.h"
 
 #include "tiles/get_tile.h"
 #include "tiles/parse_tile_url.h"
 
+#include "utl/enumerate.h"
 #include "utl/logging.h"
+#include "utl/parallel_for.h"
 #include "utl/timer.h"
 
+#include "soro/server/file_watcher.h"
 #include "soro/server/modules/tiles/import/import.h"
-#include "soro/server/modules/tiles/osm_export/osm_export.h"
 
 namespace soro::server {
 
 net::web_server::string_res_t tiles_module::serve_tile(
-    net::query_router::route_request const& req) {
+    net::query_router::route_request const& req) const {
 
   auto const sc_it = tile_contexts_.find(req.path_params_.front());
   if (sc_it == std::end(tile_contexts_)) {
@@ -22,7 +31,7 @@ net::web_server::string_res_t tiles_module::serve_tile(
                    << " infrastructure while serving tiles";
     return net::not_found_response(req);
   }
-  auto& sc = sc_it->second;
+  auto& sc = *sc_it->second;
 
   net::web_server::string_res_t response;
 
@@ -48,53 +57,138 @@ net::web_server::string_res_t tiles_module::serve_tile(
   return response;
 }
 
-fs::path create_osm_file(server_settings const& settings,
-                         soro::infra::infrastructure const& infra) {
-
-  auto osm_path =
-      (settings.osm_dir() / static_cast<std::string_view>(infra->source_))
-          .replace_extension(".osm");
+// the pack file and the lock file of lmdb live next to the database
+void remove_tiles_db(fs::path const& db_path) {
+  std::error_code ec;
+  for (auto const* suffix : {"", "-lock", ".pck"}) {
+    auto path = db_path;
+    path += suffix;
+    fs::remove(path, ec);
+  }
+}
 
-  if (settings.regenerate_.val() || !fs::exists(osm_path)) {
-    osm_export::export_and_write(*infra, osm_path);
+tiles_module::context::~context() {
+  if (outdated_) {
+    remove_tiles_db(db_path_);
   }
+}
 
-  return osm_path;
+// every version of the infrastructure sources has a database of its own
+fs::path get_tiles_db_path(server_settings const& s,
+                           std::string_view const infra_name,
+                           std::size_t const fingerprint) {
+  return s.tiles_dir() / fmt::format("{}-{:016x}.mdb", infra_name, fingerprint);
+}
+
+// databases of earlier versions, left behind by an earlier run
+void remove_outdated_tiles_dbs(server_settings const& s,
+                               std::string_view const infra_name,
+                               fs::path const& current) {
+  auto const prefix = std::string{infra_name} + '-';
+
+  std::error_code ec;
+  for (auto const& entry : fs::directory_iterator{s.tiles_dir(), ec}) {
+    auto const& path = entry.path();
+    auto const stem = path.stem().string();
+    if (path.extension() != ".mdb" || path == current ||
+        !stem.starts_with(prefix)) {
+      continue;
+    }
+
+    // other infrastructures may share the prefix, their suffix is no version
+    auto const version = std::string_view{stem}.substr(prefix.size());
+    if (version.size() == 16 &&
+        std::ranges::all_of(version, [](char const c) {
+          return std::isxdigit(static_cast<unsigned char>(c)) != 0;
+        })) {
+      remove_tiles_db(path);
+    }
+  }
 }
 
 fs::path create_tiles_db(server_settings const& s,
-                         soro::infra::infrastructure const& infra,
-                         fs::path const& osm_path) {
-  auto tile_db_path =
-      (s.tiles_dir() / static_cast<std::string_view>(infra->source_))
-          .replace_extension(".mdb");
+                         std::string_view const infra_name,
+                         std::size_t const fingerprint,
+                         infrastructure_module const& infra_m) {
+  auto const tile_db_path = get_tiles_db_path(s, infra_name, fingerprint);
+  auto const raw = s.server_infra_dir() / infra_name;
 
+  // only load the infrastructure if the import is required
   if (s.regenerate_.val() || !fs::exists(tile_db_path) ||
-      last_write_time(osm_path) > last_write_time(tile_db_path)) {
-    import_settings const import_settings(osm_path, tile_db_path, s.tmp_dir(),
-                                          s.profile_file());
-    import_tiles(import_settings);
+      (fs::exists(raw) &&
+       last_write_time(raw) > last_write_time(tile_db_path))) {
+    auto const infra = infra_m.get_infra(infra_name);
+    utls::sassert(infra != nullptr, "unknown infrastructure {}", infra_name);
+    import_tiles(*infra, tile_db_path);
   }
 
   return tile_db_path;
 }
 
 tiles_module get_tile_module(server_settings const& settings,
-                             infrastructure_module const& infra_m) {
+                             infrastructure_module const& infra_m,
+                             tiles_module const* previous) {
   utl::scoped_timer const timer("creating tile module");
 
   tiles_module result;
 
-  for (auto const& infra : infra_m.all()) {
-    auto const osm_path = create_osm_file(settings, infra);
-    auto const tile_db_path = create_tiles_db(settings, infra, osm_path);
-
+  auto const infra_names = infra_m.names();
+
+  // the database of previous is reused if neither the sources nor the
+  // serialized raw infrastructure changed
+  auto const get_previous = [&](std::string_view const infra_name,
+                                std::size_t const fingerprint) {
+    if (previous == nullptr) {
+      return std::shared_ptr<tiles_module::context>{};
+    }
+
+    auto const it = previous->tile_contexts_.find(infra_name);
+    if (it == std::end(previous->tile_contexts_)) {
+      return std::shared_ptr<tiles_module::context>{};
+    }
+
+    if (it->second->fingerprint_ != fingerprint) {
+      it->second->outdated_ = true;
+      return std::shared_ptr<tiles_module::context>{};
+    }
+
+    return it->second;
+  };
+
+  // export and import are independent for every infrastructure
+  std::vector<std::shared_ptr<tiles_module::context>> contexts(
+      infra_names.size());
+  utl::parallel_for_run(infra_names.size(), [&](auto&& idx) {
+    auto const& infra_name = infra_names[idx];
+    // the database is imported from the serialized raw infrastructure, it is
+    // outdated as soon as the sources or the raw infrastructure changed
+    auto const fingerprint =
+        get_fingerprint({settings.infrastructure_sources_.val() / infra_name,
+                         settings.server_infra_dir() / infra_name});
+
+    contexts[idx] = get_previous(infra_name, fingerprint);
+    if (contexts[idx] != nullptr) {
+      return;
+    }
+
+    auto const tile_db_path =
+        create_tiles_db(settings, infra_name, fingerprint, infra_m);
+    contexts[idx] =
+        std::make_shared<tiles_module::context>(tile_db_path, fingerprint);
+
+    // nobody else opened any database yet
+    if (previous == nullptr) {
+      remove_outdated_tiles_dbs(settings, infra_name, tile_db_path);
+    }
+  });
+
+  for (auto const [idx, infra_name] : utl::enumerate(infra_names)) {
     auto [_, success] =
-        result.tile_contexts_.try_emplace(infra->source_, tile_db_path);
+        result.tile_contexts_.try_emplace(infra_name, std::move(contexts[idx]));
 
     utls::sassert(success,
                   "naming conflict during tile db creation with name {}",
-                  infra->source_);
+                  infra_name);
   }
 
   return result;
@@ -34,12 +34,12 @@ net::web_server::string_res_t timetable_module::serve_timetable(
 
   auto const timetable = get_timetable(infrastructure_name, timetable_name);
 
-  if (!timetable.has_value()) {
+  if (timetable == nullptr) {
     return net::not_found_response(req);
   }
 
   json_archive archive;
-  archive.add()(cereal::make_nvp("timetable", (**timetable)));
+  archive.add()(cereal::make_nvp("timetable", (*timetable)));
   return json_response(req, archive);
 }
 
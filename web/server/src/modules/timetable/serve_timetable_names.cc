@@ -1,5 +1,10 @@
 #include "soro/server/modules/timetable/timetable_module.h"
 
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include "net/web_server/responses.h"
+
 #include "soro/server/cereal/cereal_extern.h"
 #include "soro/server/cereal/json_archive.h"
 
@@ -7,13 +12,15 @@ namespace soro::server {
 
 net::web_server::string_res_t timetable_module::serve_timetable_names(
     net::query_router::route_request const& req) const {
-  auto const& context = this->contexts_.at(req.path_params_.front());
+  auto const names_it = names_.find(req.path_params_.front());
+  if (names_it == std::end(names_)) {
+    return net::not_found_response(req);
+  }
 
   json_archive archive;
-  archive.add()(cereal::make_nvp("timetables",
-                                 context.timetables_ | ranges::views::keys));
+  archive.add()(cereal::make_nvp("timetables", names_it->second));
 
   return json_response(req, archive);
 }
 
-}  // namespace soro::server
\ No newline at end of file
+}  // namespace soro::server
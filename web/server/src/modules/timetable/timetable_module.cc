@@ -1,6 +1,12 @@
 #include "soro/server/modules/timetable/timetable_module.h"
 
+#include <string>
+#include <vector>
+
+#include "utl/enumerate.h"
 #include "utl/logging.h"
+#include "utl/parallel_for.h"
+#include "utl/timer.h"
 
 #include "soro/server/server_settings.h"
 #include "soro/timetable/timetable.h"
@@ -10,28 +16,35 @@ namespace soro::server {
 
 namespace fs = std::filesystem;
 
-tt::timetable::optional_ptr timetable_module::get_timetable(
+std::string get_timetable_key(std::string_view const infrastructure_name,
+                              std::string_view const timetable_name) {
+  std::string result{infrastructure_name};
+  result += '/';
+  result += timetable_name;
+  return result;
+}
+
+std::shared_ptr<tt::timetable const> timetable_module::get_timetable(
     std::string_view const infrastructure_name,
     std::string_view const timetable_name) const {
+  return timetables_.get(
+      get_timetable_key(infrastructure_name, timetable_name));
+}
 
-  auto const context_it = contexts_.find(infrastructure_name);
+struct timetable_task {
+  std::string infrastructure_name_;
+  fs::path source_;
 
-  if (context_it == std::end(contexts_)) {
-    return std::nullopt;
-  }
+  // serialized timetables depend on the infrastructure they were parsed with
+  fs::path raw_;
 
-  auto const& context = context_it->second;
+  bool parse_{false};
+};
 
-  auto tt_it = context.timetables_.find(timetable_name);
-  if (tt_it == std::end(context.timetables_)) {
-    return std::nullopt;
-  }
-
-  return tt::timetable::optional_ptr(tt_it->second.get());
-}
-
-std::vector<fs::path> get_timetable_todo_list(server_settings const& settings) {
-  std::vector<fs::path> timetable_todo_list;
+std::vector<timetable_task> get_timetable_todo_list(
+    server_settings const& settings,
+    std::vector<std::string> const& infrastructure_names) {
+  std::vector<timetable_task> timetable_todo_list;
 
   for (auto&& dir_entry :
        fs::directory_iterator{settings.timetable_sources_.val()}) {
@@ -42,53 +55,117 @@ std::vector<fs::path> get_timetable_todo_list(server_settings const& settings) {
       continue;
     }
 
-    auto const potential_raw =
-        settings.server_timetable_dir() / dir_entry.path().filename();
-
-    // add to todo list if either:
-    // - regenerate is set
-    // - compiled without serialization support
-    // - we don't have a serialized raw file anyways
-    // - the serialized raw file we have is outdated
-    if (settings.regenerate_.val() ||
-        !tt::timetable::serialization_possible() || !exists(potential_raw) ||
-        fs::last_write_time(potential_raw) < dir_entry.last_write_time()) {
-      timetable_todo_list.emplace_back(dir_entry.path());
-    } else {
-      timetable_todo_list.emplace_back(potential_raw);
+    for (auto const& infra_name : infrastructure_names) {
+      auto const potential_raw = settings.server_timetable_dir() / infra_name /
+                                 dir_entry.path().filename();
+      auto const infra_raw = settings.server_infra_dir() / infra_name;
+
+      // parse if either:
+      // - regenerate is set
+      // - compiled without serialization support
+      // - we don't have a serialized raw file anyways
+      // - the serialized raw file we have is outdated
+      // - the infrastructure was serialized after the timetable
+      auto const parse =
+          settings.regenerate_.val() ||
+          !tt::timetable::serialization_possible() || !exists(potential_raw) ||
+          fs::last_write_time(potential_raw) < dir_entry.last_write_time() ||
+          (exists(infra_raw) &&
+           fs::last_write_time(potential_raw) < fs::last_write_time(infra_raw));
+
+      timetable_todo_list.push_back({.infrastructure_name_ = infra_name,
+                                     .source_ = dir_entry.path(),
+                                     .raw_ = potential_raw,
+                                     .parse_ = parse});
     }
   }
 
   return timetable_todo_list;
 }
 
+std::shared_ptr<tt::timetable const> parse_timetable(
+    timetable_task const& task, infrastructure_module const& infra_m) {
+  auto const infra = infra_m.get_infra(task.infrastructure_name_);
+  if (infra == nullptr) {
+    return nullptr;
+  }
+
+  auto tt =
+      tt::try_parsing_timetable(tt::make_timetable_opts(task.source_), *infra);
+
+  if (!tt) {
+    return nullptr;
+  }
+
+  return std::make_shared<tt::timetable const>(std::move(*tt));
+}
+
 timetable_module get_timetable_module(server_settings const& s,
                                       infrastructure_module const& infra_m) {
+  utl::scoped_timer const timer("creating timetable module");
+
   timetable_module result;
+  result.timetables_ = lazy_store<tt::timetable>(
+      std::size_t{s.memory_budget_mb_.val()} * 1024 * 1024);
 
-  auto const timetable_todo_list = get_timetable_todo_list(s);
+  auto const infra_names = infra_m.names();
+  auto const timetable_todo_list = get_timetable_todo_list(s, infra_names);
 
-  for (auto const& infra : infra_m.all()) {
-    timetable_module::infra_context context;
+  if (tt::timetable::serialization_possible()) {
+    for (auto const& infra_name : infra_names) {
+      fs::create_directories(s.server_timetable_dir() / infra_name);
+    }
+  }
 
-    for (auto const& tt_item : timetable_todo_list) {
-      auto tt =
-          tt::try_parsing_timetable(tt::make_timetable_opts(tt_item), infra);
+  // every pair of infrastructure and timetable source without an up to date
+  // serialized raw file is parsed right away and on its own
+  std::vector<std::shared_ptr<tt::timetable const>> parsed(
+      timetable_todo_list.size());
+  utl::parallel_for_run(timetable_todo_list.size(), [&](auto&& idx) {
+    auto const& task = timetable_todo_list[idx];
+    if (!task.parse_) {
+      return;
+    }
 
-      if (!tt) {
-        continue;
-      }
+    parsed[idx] = parse_timetable(task, infra_m);
 
-      auto tt_ptr = std::make_unique<tt::timetable>(std::move(*tt));
+    if (tt::timetable::serialization_possible() && parsed[idx] != nullptr) {
+      parsed[idx]->save(task.raw_);
+    }
+  });
 
-      if (tt::timetable::serialization_possible() && is_directory(tt_item)) {
-        (*tt_ptr).save(s.server_timetable_dir() / tt_item.filename());
-      }
+  for (auto const [idx, task] : utl::enumerate(timetable_todo_list)) {
+    // the timetable source is not valid for the infrastructure
+    if (task.parse_ && parsed[idx] == nullptr) {
+      continue;
+    }
 
-      context.timetables_.emplace((*tt_ptr)->source_, std::move(tt_ptr));
+    // serialized timetables are memory mapped again after an eviction,
+    // without serialization support they are parsed from their sources again
+    lazy_store<tt::timetable>::loader_t load;
+    if (tt::timetable::serialization_possible()) {
+      load = [raw = task.raw_] {
+        return std::make_shared<tt::timetable const>(raw);
+      };
+    } else {
+      load = [task, &infra_m] { return parse_timetable(task, infra_m); };
     }
 
-    result.contexts_.emplace(infra->source_, std::move(context));
+    auto const bytes = get_size_on_disk(
+        tt::timetable::serialization_possible() ? task.raw_ : task.source_);
+
+    auto tt_name = task.source_.filename().string();
+    auto key = get_timetable_key(task.infrastructure_name_, tt_name);
+    result.timetables_.add(std::move(key), bytes, std::move(load),
+                           std::move(parsed[idx]));
+    result.names_[task.infrastructure_name_].push_back(std::move(tt_name));
+  }
+
+  if (!s.lazy_.val()) {
+    auto const keys = result.timetables_.keys();
+    utl::parallel_for_run(keys.size(), [&](auto&& idx) {
+      result.timetables_.get(keys[idx]);
+    });
   }
 
   return result;
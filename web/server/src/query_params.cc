@@ -0,0 +1,81 @@
+#include "soro/server/query_params.h"
+
+#include <algorithm>
+#include <array>
+
+#include "soro/utls/parse_fp.h"
+#include "soro/utls/sassert.h"
+#include "soro/utls/std_wrapper/contains.h"
+#include "soro/utls/string.h"
+
+namespace soro::server {
+
+using namespace soro::infra;
+
+utls::gps::precision str_to_decimal(std::string_view const str) {
+  return utls::parse_fp<utls::gps::precision>(str);
+}
+
+utls::result<utls::bounding_box> str_to_bounding_box(
+    std::string_view const str) {
+  auto const values = utls::split(str, ",");
+  utls::expect(values.size() == 4, "bounding box {} has not 4 values", str);
+
+  utls::bounding_box const result{
+      .south_west_ = {.lon_ = str_to_decimal(values[0]),
+                      .lat_ = str_to_decimal(values[1])},
+      .north_east_ = {.lon_ = str_to_decimal(values[2]),
+                      .lat_ = str_to_decimal(values[3])}};
+
+  if (result.south_west_.lon_ > result.north_east_.lon_ ||
+      result.south_west_.lat_ > result.north_east_.lat_) {
+    return utls::unexpected(std::errc::invalid_argument);
+  }
+
+  return result;
+}
+
+bool type_filter::accepts(spatial_index::kind const kind,
+                          type const element_type) const {
+  if (empty() || utls::contains(kinds_, kind)) {
+    return true;
+  }
+
+  return kind == spatial_index::kind::ELEMENT &&
+         utls::contains(element_types_, element_type);
+}
+
+bool type_filter::empty() const noexcept {
+  return kinds_.empty() && element_types_.empty();
+}
+
+constexpr std::array ALL_KINDS = {
+    spatial_index::kind::ELEMENT, spatial_index::kind::STATION,
+    spatial_index::kind::STATION_ROUTE,
+    spatial_index::kind::INTERLOCKING_ROUTE};
+
+constexpr auto ALL_TYPES = all_types();
+
+utls::result<type_filter> str_to_type_filter(std::string_view const str) {
+  type_filter result;
+
+  for (auto const token : utls::split(str, ",")) {
+    auto const kind = std::ranges::find_if(
+        ALL_KINDS, [&](auto&& k) { return to_string(k) == token; });
+    if (kind != std::end(ALL_KINDS)) {
+      result.kinds_.push_back(*kind);
+      continue;
+    }
+
+    auto const element_type = std::ranges::find_if(
+        ALL_TYPES, [&](auto&& t) { return get_type_str(t) == token; });
+    if (element_type == std::end(ALL_TYPES)) {
+      return utls::unexpected(std::errc::invalid_argument);
+    }
+    result.element_types_.push_back(*element_type);
+  }
+
+  return result;
+}
+
+}  // namespace soro::server
@@ -0,0 +1,207 @@
+#include "soro/server/response_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <utility>
+
+#include "boost/beast/version.hpp"
+
+#include "cista/hash.h"
+
+#include "tiles/util.h"
+
+#include "soro/utls/sassert.h"
+
+#include "soro/base/time.h"
+
+namespace soro::server {
+
+namespace http = boost::beast::http;
+
+std::string version_tag(infra::infrastructure const& infra) {
+  std::string result{static_cast<std::string_view>(infra->source_)};
+  result += '/';
+  result += static_cast<std::string_view>(infra->version_.name_);
+  result += '/';
+  result += std::to_string(infra->version_.number_);
+  return result;
+}
+
+std::string version_tag(tt::timetable const& tt) {
+  std::string result{static_cast<std::string_view>(tt->source_)};
+  result += '/';
+  result += std::to_string(absolute_time_to_rep(tt->interval_.start_));
+  result += '-';
+  result += std::to_string(absolute_time_to_rep(tt->interval_.end_));
+  result += '/';
+  result += std::to_string(tt->trains_.size());
+  return result;
+}
+
+std::string get_key(std::string_view const target,
+                    std::string_view const tag) {
+  std::string result{tag};
+  result += ' ';
+  result += target;
+  return result;
+}
+
+// strong etag of the body, equal bodies share it across versions of the data
+std::string get_etag(std::string_view const body) {
+  auto const h = cista::hash(body);
+
+  std::array<char, 2 + 16> buf{};
+  buf.front() = '"';
+  auto const [end, ec] = std::to_chars(buf.data() + 1, buf.data() + 17, h, 16);
+  utls::sassert(ec == std::errc{}, "could not format etag");
+  *end = '"';
+
+  return {buf.data(), end + 1};
+}
+
+// the deflated body is a representation of its own and must not share the
+// strong etag of the identity body
+std::string get_deflated_etag(std::string_view const etag) {
+  std::string result{etag.substr(0, etag.size() - 1)};
+  result += "-deflate\"";
+  return result;
+}
+
+std::size_t response_cache::entry::bytes() const {
+  return sizeof(entry) + etag_.size() + content_type_.size() + body_.size() +
+         deflated_.size();
+}
+
+response_cache::response_cache(std::size_t const capacity_bytes,
+                               std::size_t const shards)
+    : shard_capacity_{capacity_bytes / std::max(std::size_t{1}, shards)} {
+  utls::expect(shards != 0, "response cache requires at least one shard");
+
+  shards_.reserve(shards);
+  for (auto i = 0U; i < shards; ++i) {
+    shards_.emplace_back(std::make_unique<shard>());
+  }
+}
+
+std::shared_ptr<response_cache::entry const> response_cache::get(
+    shard& s, std::string const& key) {
+  std::lock_guard const lock{s.mutex_};
+
+  auto const it = s.entries_.find(key);
+  if (it == std::end(s.entries_)) {
+    ++s.misses_;
+    return nullptr;
+  }
+
+  ++s.hits_;
+  s.lru_.splice(std::begin(s.lru_), s.lru_, it->second.second);
+  return it->second.first;
+}
+
+void response_cache::put(shard& s, std::string const& key,
+                         std::shared_ptr<entry const> e) {
+  auto const bytes = e->bytes() + key.size();
+  if (bytes > shard_capacity_) {
+    return;
+  }
+
+  std::lock_guard const lock{s.mutex_};
+
+  // computed concurrently by another request
+  if (s.entries_.contains(key)) {
+    return;
+  }
+
+  while (s.bytes_ + bytes > shard_capacity_ && !s.lru_.empty()) {
+    auto const& oldest = s.lru_.back();
+    auto const it = s.entries_.find(oldest);
+    s.bytes_ -= it->second.first->bytes() + oldest.size();
+    s.entries_.erase(it);
+    s.lru_.pop_back();
+  }
+
+  s.lru_.push_front(key);
+  s.entries_.emplace(key, std::pair{std::move(e), std::begin(s.lru_)});
+  s.bytes_ += bytes;
+}
+
+net::web_server::string_res_t response_cache::serve(
+    net::query_router::route_request const& req, std::string_view const tag,
+    producer_t const& produce) {
+  // entries of an outdated version are never hit again and age out
+  auto const target = req.target();
+  auto const key =
+      get_key(std::string_view{target.data(), target.size()}, tag);
+
+  auto& s = *shards_[cista::hash(key) % shards_.size()];
+
+  auto e = get(s, key);
+  if (e == nullptr) {
+    auto res = produce();
+    if (res.result() != http::status::ok) {
+      return res;
+    }
+
+    auto fresh = std::make_shared<entry>();
+    fresh->content_type_ = std::string{res[http::field::content_type]};
+    fresh->body_ = std::move(res.body());
+    fresh->etag_ = get_etag(fresh->body_);
+    if (fresh->body_.size() > COMPRESS_THRESHOLD) {
+      fresh->deflated_ = tiles::compress_deflate(fresh->body_);
+    }
+
+    e = fresh;
+    put(s, key, std::move(fresh));
+  }
+
+  auto const deflate = !e->deflated_.empty() &&
+                       req[http::field::accept_encoding].find("deflate") !=
+                           std::string_view::npos;
+  auto const etag = deflate ? get_deflated_etag(e->etag_) : e->etag_;
+
+  if (req[http::field::if_none_match].find(etag) != std::string_view::npos) {
+    net::web_server::string_res_t res{http::status::not_modified,
+                                      req.version()};
+    res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+    res.set(http::field::etag, etag);
+    res.set(http::field::vary, "Accept-Encoding");
+    res.keep_alive(req.keep_alive());
+    return res;
+  }
+
+  net::web_server::string_res_t res{http::status::ok, req.version()};
+  res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+  res.set(http::field::content_type, e->content_type_);
+  res.set(http::field::etag, etag);
+  res.set(http::field::cache_control, "no-cache");
+  res.set(http::field::vary, "Accept-Encoding");
+  if (deflate) {
+    res.set(http::field::content_encoding, "deflate");
+  }
+  res.keep_alive(req.keep_alive());
+  res.body() = deflate ? e->deflated_ : e->body_;
+  res.prepare_payload();
+
+  return res;
+}
+
+std::size_t response_cache::hits() const {
+  std::size_t result = 0;
+  for (auto const& s : shards_) {
+    std::lock_guard const lock{s->mutex_};
+    result += s->hits_;
+  }
+  return result;
+}
+
+std::size_t response_cache::misses() const {
+  std::size_t result = 0;
+  for (auto const& s : shards_) {
+    std::lock_guard const lock{s->mutex_};
+    result += s->misses_;
+  }
+  return result;
+}
+
+}  // namespace soro::server
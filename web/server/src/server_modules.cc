@@ -0,0 +1,66 @@
+#include "soro/server/server_modules.h"
+
+#include <chrono>
+#include <future>
+
+#include "utl/logging.h"
+
+namespace soro::server {
+
+std::chrono::milliseconds since(
+    std::chrono::steady_clock::time_point const start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+template <typename Fn>
+auto timed_async(std::chrono::milliseconds& duration, Fn&& fn) {
+  return std::async(std::launch::async,
+                    [&duration, fn = std::forward<Fn>(fn)]() {
+                      auto const start = std::chrono::steady_clock::now();
+                      auto result = fn();
+                      duration = since(start);
+                      return result;
+                    });
+}
+
+server_modules::server_modules(server_settings const& s,
+                               server_modules const* previous)
+    : generation_{previous == nullptr ? 0 : previous->generation_ + 1} {
+  auto const start = std::chrono::steady_clock::now();
+
+  // all other modules read the infrastructures
+  infrastructure_ = get_infrastructure_module(s);
+  auto const infra_time = since(start);
+
+  // tiles, search and timetables are independent of each other, every one of
+  // them processes the infrastructures in parallel as well
+  std::chrono::milliseconds tiles_time{};
+  std::chrono::milliseconds search_time{};
+  std::chrono::milliseconds timetable_time{};
+
+  auto tiles = timed_async(tiles_time, [&] {
+    return get_tile_module(s, infrastructure_,
+                           previous == nullptr ? nullptr : &previous->tiles_);
+  });
+  auto search = timed_async(
+      search_time, [&] { return get_search_module(s, infrastructure_); });
+  auto timetables = timed_async(
+      timetable_time, [&] { return get_timetable_module(s, infrastructure_); });
+
+  tiles_ = tiles.get();
+  search_ = search.get();
+  timetable_ = timetables.get();
+
+  // only registers the timetables, indices are built on request
+  positions_ = get_positions_module(infrastructure_, timetable_);
+
+  uLOG(utl::info) << "modules of generation " << generation_ << " took "
+                  << since(start).count()
+                  << "ms, infrastructure: " << infra_time.count()
+                  << "ms, tiles: " << tiles_time.count()
+                  << "ms, search: " << search_time.count()
+                  << "ms, timetables: " << timetable_time.count() << "ms";
+}
+
+}  // namespace soro::server
@@ -1,5 +1,12 @@
 #include "soro/server/soro_server.h"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "net/stop_handler.h"
 #include "net/web_server/responses.h"
 #include "net/web_server/serve_static.h"
@@ -15,7 +22,7 @@ void soro_server::set_up_routes(server_settings const& s) {
   router_.reply_hook([](web_server::http_res_t const& resp) {
     std::visit(
         [](auto&& r) {
-          if (r.result() != boost::beast::http::status::ok) {
+          if (r.result_int() >= 400) {
             uLOG(utl::info) << "bad response status: " << r.result();
           }
         },
@@ -23,11 +30,12 @@ void soro_server::set_up_routes(server_settings const& s) {
   });
 
   // 0.0.0.0:8080/infrastructures/
-  router_.route("GET", R"(/infrastructures\/?$)",
-                [this](net::query_router::route_request const& req,
-                       web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_infrastructure_names(req));
-                });
+  router_.route(
+      "GET", R"(/infrastructures\/?$)",
+      [this](net::query_router::route_request const& req,
+             web_server::http_res_cb_t const& cb, bool const) {
+        cb(modules()->infrastructure_.serve_infrastructure_names(req));
+      });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/tiles/{int}/{int}/{int}.mvt
   router_.route(
@@ -35,27 +43,35 @@ void soro_server::set_up_routes(server_settings const& s) {
       R"(/infrastructure\/([a-zA-Z0-9_-]+)\/tiles\/(\d+)\/(\d+)\/(\d+).mvt)",
       [this](net::query_router::route_request const& req,
              web_server::http_res_cb_t const& cb,
-             bool const) { cb(tiles_module_.serve_tile(req)); });
+             bool const) { cb(modules()->tiles_.serve_tile(req)); });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/bounding_box/
   router_.route("GET", R"(/infrastructure\/([a-zA-Z0-9_-]+)\/bounding_box\/?$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_bounding_box(req));
+                  serve_cached(req, cb,
+                               &infrastructure_module::serve_bounding_box);
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/stations/
   router_.route("GET", R"(/infrastructure\/([a-zA-Z0-9_-]+)\/stations/$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_station_names(req));
+                  serve_loaded(
+                      req, cb,
+                      modules()->infrastructure_.infrastructures_.ready(
+                          req.path_params_.front()),
+                      [this](net::query_router::route_request const& r) {
+                        return modules()->infrastructure_.serve_station_names(
+                            r);
+                      });
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/station/{id}
   router_.route("GET", R"(/infrastructure\/([a-zA-Z0-9_-]+)\/station/(\d+)$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_station(req));
+                  serve_cached(req, cb, &infrastructure_module::serve_station);
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/station_route/{id}
@@ -63,7 +79,8 @@ void soro_server::set_up_routes(server_settings const& s) {
                 R"(/infrastructure\/([a-zA-Z0-9_-]+)\/station_route/(\d+)$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_station_route(req));
+                  serve_cached(req, cb,
+                               &infrastructure_module::serve_station_route);
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/interlocking_route/{id}
@@ -71,7 +88,7 @@ void soro_server::set_up_routes(server_settings const& s) {
       "GET", R"(/infrastructure\/([a-zA-Z0-9_-]+)\/interlocking_route/(\d+)$)",
       [this](net::query_router::route_request const& req,
              web_server::http_res_cb_t const& cb, bool const) {
-        cb(infrastructure_module_.serve_interlocking_route(req));
+        serve_cached(req, cb, &infrastructure_module::serve_interlocking_route);
       });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/exclusion_sets/{id}
@@ -79,29 +96,66 @@ void soro_server::set_up_routes(server_settings const& s) {
                 R"(/infrastructure\/([a-zA-Z0-9_-]+)\/exclusion_sets/(\d+)$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_exclusion_set(req));
+                  serve_cached(req, cb,
+                               &infrastructure_module::serve_exclusion_set);
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/element/{id}
   router_.route("GET", R"(/infrastructure\/([a-zA-Z0-9_-]+)\/element/(\d+)$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(infrastructure_module_.serve_element(req));
+                  serve_cached(req, cb, &infrastructure_module::serve_element);
                 });
 
+  // 0.0.0.0:8080/infrastructure/{infrastructure_name}/within?bbox={west,south,east,north}&types={type,type,...}
+  router_.route(
+      "GET",
+      R"(/infrastructure/([a-zA-Z0-9_-]+)/within\?bbox=((?:-?\d+(?:\.\d+)?,){3}-?\d+(?:\.\d+)?)&types=([a-zA-Z_,]*)$)",
+      [this](net::query_router::route_request const& req,
+             web_server::http_res_cb_t const& cb, bool const) {
+        serve_uncached(req, cb, &infrastructure_module::serve_within);
+      });
+
+  // 0.0.0.0:8080/infrastructure/{infrastructure_name}/nearest?lon={lon}&lat={lat}&k={k}&types={type,type,...}
+  router_.route(
+      "GET",
+      R"(/infrastructure/([a-zA-Z0-9_-]+)/nearest\?lon=(-?\d+(?:\.\d+)?)&lat=(-?\d+(?:\.\d+)?)&k=(\d+)&types=([a-zA-Z_,]*)$)",
+      [this](net::query_router::route_request const& req,
+             web_server::http_res_cb_t const& cb, bool const) {
+        serve_uncached(req, cb, &infrastructure_module::serve_nearest);
+      });
+
+  // 0.0.0.0:8080/infrastructure/{infrastructure_name}/search?query={search_string}&types={type,type,...}&bbox={west,south,east,north}&limit={limit}
+  router_.route(
+      "GET",
+      R"(/infrastructure/([a-zA-Z0-9_-]+)/search\?query=([a-zA-Z0-9_-]+)&types=([a-zA-Z_,]*)&bbox=((?:-?\d+(?:\.\d+)?,){3}-?\d+(?:\.\d+)?|)&limit=(\d+)$)",
+      [this](net::query_router::route_request const& req,
+             web_server::http_res_cb_t const& cb, bool const) {
+        serve_loaded(req, cb,
+                     modules()->search_.indices_.ready(req.path_params_[0]),
+                     [this](net::query_router::route_request const& r) {
+                       return modules()->search_.serve_search(r);
+                     });
+      });
+
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/search/{search_string}
   router_.route("GET",
                 R"(/infrastructure/([a-zA-Z0-9_-]+)/search/([a-zA-Z0-9_-]+)$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(search_module_.serve_search(req, infrastructure_module_));
+                  serve_loaded(
+                      req, cb,
+                      modules()->search_.indices_.ready(req.path_params_[0]),
+                      [this](net::query_router::route_request const& r) {
+                        return modules()->search_.serve_search(r);
+                      });
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/timetables/
   router_.route("GET", R"(/infrastructure/([a-zA-Z0-9_-]+)/timetables\/?$)",
                 [this](net::query_router::route_request const& req,
                        web_server::http_res_cb_t const& cb, bool const) {
-                  cb(timetable_module_.serve_timetable_names(req));
+                  cb(modules()->timetable_.serve_timetable_names(req));
                 });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/timetable/{timetable_name}
@@ -109,8 +163,31 @@ void soro_server::set_up_routes(server_settings const& s) {
       "GET",
       R"(/infrastructure/([a-zA-Z0-9_-]+)/timetable/([a-zA-Z0-9_-]+)\/?$)",
       [this](net::query_router::route_request const& req,
-             web_server::http_res_cb_t const& cb,
-             bool const) { cb(timetable_module_.serve_timetable(req)); });
+             web_server::http_res_cb_t const& cb, bool const) {
+        auto const current = modules();
+        auto const ready =
+            current->infrastructure_.infrastructures_.ready(
+                req.path_params_[0]) &&
+            current->timetable_.timetables_.ready(get_timetable_key(
+                req.path_params_[0], req.path_params_[1]));
+
+        serve_loaded(
+            req, cb, ready, [this](net::query_router::route_request const& r) {
+              auto const m = modules();
+              auto const infra =
+                  m->infrastructure_.get_infra(r.path_params_[0]);
+              auto const tt = m->timetable_.get_timetable(r.path_params_[0],
+                                                          r.path_params_[1]);
+              if (infra == nullptr || tt == nullptr) {
+                return net::not_found_response(r);
+              }
+
+              auto const tag = std::to_string(m->generation_) + '/' +
+                               version_tag(*infra) + '/' + version_tag(*tt);
+              return response_cache_.serve(
+                  r, tag, [&] { return m->timetable_.serve_timetable(r); });
+            });
+      });
 
   // 0.0.0.0:8080/infrastructure/{infrastructure_name}/timetable/{timetable_name}/ordering?from={from}&to={to}&trainIds={trainId,trainId,...}
   router_.route(
@@ -118,8 +195,30 @@ void soro_server::set_up_routes(server_settings const& s) {
       R"(/infrastructure/([a-zA-Z0-9_-]+)/timetable/([a-zA-Z0-9_-]+)/ordering\?from=([0-9]+)&to=([0-9]+)&trainIds=(\d*(?:,\d+)*)$)",
       [this](net::query_router::route_request const& req,
              web_server::http_res_cb_t const& cb, bool const) {
-        cb(ordering_module_.serve_ordering_graph(req, infrastructure_module_,
-                                                 timetable_module_));
+        workers_->submit(
+            req, cb,
+            [this](net::query_router::route_request const& r,
+                   std::stop_token const& stop) {
+              auto const m = modules();
+              return ordering_module_.serve_ordering_graph(
+                  r, m->infrastructure_, m->timetable_, stop);
+            });
+      });
+
+  // 0.0.0.0:8080/infrastructure/{infrastructure_name}/timetable/{timetable_name}/positions?from={from}&to={to}&step={step}&viewport={west,south,east,north}
+  router_.route(
+      "GET",
+      R"(/infrastructure/([a-zA-Z0-9_-]+)/timetable/([a-zA-Z0-9_-]+)/positions\?from=([0-9]+)&to=([0-9]+)&step=([0-9]+)&viewport=((?:-?\d+(?:\.\d+)?,){3}-?\d+(?:\.\d+)?|)$)",
+      [this](net::query_router::route_request const& req,
+             web_server::http_res_cb_t const& cb, bool const) {
+        // the first request for a timetable builds its position index
+        workers_->submit(req, cb,
+                         [this](net::query_router::route_request const& r,
+                                std::stop_token const&) {
+                           auto const m = modules();
+                           return m->positions_.serve_positions(r,
+                                                                m->timetable_);
+                         });
       });
 
   // if nothing matches: match all and try to serve static file
@@ -134,12 +233,79 @@ void soro_server::set_up_routes(server_settings const& s) {
                 });
 }
 
+void soro_server::serve_loaded(
+    net::query_router::route_request const& req,
+    web_server::http_res_cb_t const& cb, bool const ready,
+    std::function<web_server::string_res_t(
+        net::query_router::route_request const&)> const& serve) {
+  if (ready) {
+    cb(serve(req));
+    return;
+  }
+
+  // concurrent requests for the same target share the load
+  workers_->submit(req, cb,
+                   [serve](net::query_router::route_request const& r,
+                           std::stop_token const&) { return serve(r); });
+}
+
+void soro_server::serve_cached(net::query_router::route_request const& req,
+                               web_server::http_res_cb_t const& cb,
+                               infrastructure_module::serve_fn const serve) {
+  serve_loaded(req, cb,
+               modules()->infrastructure_.infrastructures_.ready(
+                   req.path_params_.front()),
+               [this, serve](net::query_router::route_request const& r) {
+                 return get_cached(r, serve);
+               });
+}
+
+void soro_server::serve_uncached(net::query_router::route_request const& req,
+                                 web_server::http_res_cb_t const& cb,
+                                 infrastructure_module::serve_fn const serve) {
+  serve_loaded(req, cb,
+               modules()->infrastructure_.infrastructures_.ready(
+                   req.path_params_.front()),
+               [this, serve](net::query_router::route_request const& r) {
+                 return (modules()->infrastructure_.*serve)(r);
+               });
+}
+
+net::web_server::string_res_t soro_server::get_cached(
+    net::query_router::route_request const& req,
+    infrastructure_module::serve_fn const serve) {
+  auto const m = modules();
+  auto const infra = m->infrastructure_.get_infra(req.path_params_.front());
+  if (infra == nullptr) {
+    return net::not_found_response(req);
+  }
+
+  // the generation separates equally named versions of different reloads
+  auto const tag = std::to_string(m->generation_) + '/' + version_tag(*infra);
+  return response_cache_.serve(
+      req, tag, [&] { return (m->infrastructure_.*serve)(req); });
+}
+
+std::shared_ptr<server_modules const> soro_server::modules() const {
+  return modules_.load();
+}
+
+void soro_server::reload(server_settings const& s) {
+  uLOG(utl::info) << "server resources changed, reloading";
+
+  try {
+    auto const previous = modules();
+    modules_.store(std::make_shared<server_modules const>(s, previous.get()));
+  } catch (std::exception const& e) {
+    uLOG(utl::err) << "reload failed, keeping the current modules: "
+                   << e.what();
+  }
+}
+
 soro_server::soro_server(server_settings const& s)
-    : infrastructure_module_{get_infrastructure_module(s)},
-      tiles_module_{get_tile_module(s, infrastructure_module_)},
-      search_module_{get_search_module(infrastructure_module_)},
-      timetable_module_{get_timetable_module(s, infrastructure_module_)},
-      ordering_module_{get_ordering_module()} {
+    : modules_{std::make_shared<server_modules const>(s)},
+      ordering_module_{get_ordering_module()},
+      response_cache_{std::size_t{s.response_cache_mb_.val()} * 1024 * 1024} {
   set_up_routes(s);
 }
 
@@ -147,6 +313,21 @@ void soro_server::run(server_settings const& s) {
   boost::asio::io_context ioc;
   net::web_server serv{ioc};
 
+  auto const threads = s.worker_threads_.val() == 0
+                           ? std::max(1U, std::thread::hardware_concurrency())
+                           : s.worker_threads_.val();
+  workers_.emplace(ioc.get_executor(), threads, s.worker_queue_.val(),
+                   std::chrono::seconds{s.worker_timeout_.val()});
+
+  if (s.reload_interval_.val() != 0) {
+    watcher_.emplace(
+        std::vector{s.server_infra_dir(), s.server_timetable_dir(),
+                    s.infrastructure_sources_.val(),
+                    s.timetable_sources_.val()},
+        std::chrono::seconds{s.reload_interval_.val()},
+        [this, &s] { reload(s); });
+  }
+
   serv.on_http_request([this](web_server::http_req_t const& rq,
                               web_server::http_res_cb_t const& cb,
                               bool const ssl) {
@@ -177,6 +358,9 @@ void soro_server::run(server_settings const& s) {
   } else {
     ioc.run();
   }
+
+  watcher_.reset();
+  workers_.reset();
 }
 
 }  // namespace soro::server
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "soro/server/worker_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#include "boost/asio/post.hpp"
+#include "boost/beast/version.hpp"
+
+#include "utl/logging.h"
+
+#include "soro/utls/sassert.h"
+
+namespace soro::server {
+
+namespace http = boost::beast::http;
+
+net::web_server::string_res_t status_response(
+    net::web_server::http_req_t const& req, http::status const status,
+    std::string_view const content) {
+  net::web_server::string_res_t res{status, req.version()};
+  res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+  res.set(http::field::content_type, "text/plain");
+  res.keep_alive(req.keep_alive());
+  res.body() = content;
+  res.prepare_payload();
+  return res;
+}
+
+net::web_server::string_res_t service_unavailable_response(
+    net::web_server::http_req_t const& req) {
+  auto res = status_response(req, http::status::service_unavailable,
+                             "server busy, try again later");
+  res.set(http::field::retry_after, "1");
+  return res;
+}
+
+worker_pool::worker_pool(boost::asio::any_io_executor io,
+                         unsigned const threads, unsigned const queue_size,
+                         std::chrono::milliseconds const timeout)
+    : io_{std::move(io)}, queue_size_{queue_size}, timeout_{timeout} {
+  utls::expect(threads != 0, "worker pool requires at least one thread");
+
+  reaper_ = std::jthread{[this](std::stop_token const& s) { expire(s); }};
+
+  threads_.reserve(threads);
+  for (auto i = 0U; i < threads; ++i) {
+    threads_.emplace_back([this](std::stop_token const& s) { work(s); });
+  }
+}
+
+worker_pool::~worker_pool() {
+  reaper_.request_stop();
+  reaper_ = {};
+
+  {
+    std::lock_guard const lock{mutex_};
+    for (auto const& [key, j] : in_flight_) {
+      j->stop_.request_stop();
+    }
+    queue_.clear();
+  }
+
+  for (auto& t : threads_) {
+    t.request_stop();
+  }
+  threads_.clear();
+
+  uLOG(utl::info) << "worker pool: " << coalesced_ << " coalesced, "
+                  << rejected_ << " rejected, " << cancelled_
+                  << " cancelled requests";
+}
+
+std::size_t worker_pool::coalesced() const {
+  std::lock_guard const lock{mutex_};
+  return coalesced_;
+}
+
+std::size_t worker_pool::rejected() const {
+  std::lock_guard const lock{mutex_};
+  return rejected_;
+}
+
+std::size_t worker_pool::cancelled() const {
+  std::lock_guard const lock{mutex_};
+  return cancelled_;
+}
+
+void worker_pool::submit(net::query_router::route_request const& req,
+                         net::web_server::http_res_cb_t const& cb,
+                         handler_t handler) {
+  // the accept header selects the encoding, it is part of the identity
+  std::string key{req.target()};
+  key += '\n';
+  key += req[http::field::accept];
+  waiter w{.cb_ = cb,
+           .version_ = req.version(),
+           .keep_alive_ = req.keep_alive(),
+           .deadline_ = clock::now() + timeout_};
+
+  {
+    std::lock_guard const lock{mutex_};
+
+    if (auto const it = in_flight_.find(key); it != std::end(in_flight_)) {
+      it->second->waiters_.emplace_back(std::move(w));
+      ++coalesced_;
+      return;
+    }
+
+    if (queue_.size() < queue_size_) {
+      auto j = std::make_shared<job>();
+      j->key_ = key;
+      j->req_ = req;
+      j->handler_ = std::move(handler);
+      j->waiters_.emplace_back(std::move(w));
+
+      in_flight_.emplace(std::move(key), j);
+      queue_.emplace_back(std::move(j));
+      cv_.notify_one();
+      return;
+    }
+
+    ++rejected_;
+  }
+
+  uLOG(utl::warn) << "worker queue full, rejecting " << req.target();
+  cb(service_unavailable_response(req));
+}
+
+std::vector<worker_pool::waiter> worker_pool::take_expired(
+    job& j, clock::time_point const now) {
+  std::vector<waiter> expired;
+
+  auto const is_expired = [&](waiter const& w) { return w.deadline_ <= now; };
+  std::ranges::copy_if(j.waiters_, std::back_inserter(expired), is_expired);
+  std::erase_if(j.waiters_, is_expired);
+
+  // nobody waits for the result anymore
+  if (!expired.empty() && j.waiters_.empty()) {
+    j.stop_.request_stop();
+    in_flight_.erase(j.key_);
+    std::erase_if(queue_, [&](auto&& queued) { return queued.get() == &j; });
+    ++cancelled_;
+  }
+
+  return expired;
+}
+
+void worker_pool::expire(std::stop_token const& stop) {
+  auto const interval =
+      std::clamp(timeout_ / 4, std::chrono::milliseconds{10},
+                 std::chrono::milliseconds{1000});
+
+  while (true) {
+    std::vector<std::pair<std::shared_ptr<job>, std::vector<waiter>>> expired;
+
+    {
+      std::unique_lock lock{mutex_};
+      reaper_cv_.wait_for(lock, stop, interval, [] { return false; });
+      if (stop.stop_requested()) {
+        return;
+      }
+
+      // take_expired removes cancelled jobs from in_flight_
+      std::vector<std::shared_ptr<job>> jobs;
+      jobs.reserve(in_flight_.size());
+      for (auto const& [key, j] : in_flight_) {
+        jobs.emplace_back(j);
+      }
+
+      auto const now = clock::now();
+      for (auto& j : jobs) {
+        auto waiters = take_expired(*j, now);
+        if (!waiters.empty()) {
+          expired.emplace_back(std::move(j), std::move(waiters));
+        }
+      }
+    }
+
+    for (auto const& [j, waiters] : expired) {
+      uLOG(utl::warn) << "request expired " << j->key_;
+      reply(waiters, service_unavailable_response(j->req_));
+    }
+  }
+}
+
+void worker_pool::work(std::stop_token const& stop) {
+  while (true) {
+    std::shared_ptr<job> j;
+    std::vector<waiter> expired;
+
+    {
+      std::unique_lock lock{mutex_};
+      if (!cv_.wait(lock, stop, [&] { return !queue_.empty(); })) {
+        return;
+      }
+
+      j = std::move(queue_.front());
+      queue_.pop_front();
+
+      // the reaper runs periodically, it may have missed some
+      expired = take_expired(*j, clock::now());
+    }
+
+    if (!expired.empty()) {
+      reply(expired, service_unavailable_response(j->req_));
+    }
+
+    if (j->stop_.stop_requested()) {
+      continue;
+    }
+
+    // lets a running handler stop early on shutdown
+    std::stop_callback const on_shutdown{stop,
+                                         [&] { j->stop_.request_stop(); }};
+
+    net::web_server::string_res_t res;
+    try {
+      res = j->handler_(j->req_, j->stop_.get_token());
+    } catch (std::exception const& e) {
+      uLOG(utl::err) << "error while serving " << j->key_ << ": " << e.what();
+      res = status_response(j->req_, http::status::internal_server_error,
+                            "internal server error");
+    }
+
+    std::vector<waiter> waiters;
+    {
+      std::lock_guard const lock{mutex_};
+
+      // a cancelled job is replaced by a new one for the same key
+      if (auto const it = in_flight_.find(j->key_);
+          it != std::end(in_flight_) && it->second == j) {
+        in_flight_.erase(it);
+      }
+      waiters = std::move(j->waiters_);
+    }
+
+    reply(waiters, std::move(res));
+  }
+}
+
+void worker_pool::reply(std::vector<waiter> const& waiters,
+                        net::web_server::string_res_t&& res) {
+  for (auto i = 0U; i < waiters.size(); ++i) {
+    auto const& w = waiters[i];
+
+    // the last client gets the original, everyone else a copy
+    net::web_server::string_res_t copy;
+    if (i + 1 == waiters.size()) {
+      copy = std::move(res);
+    } else {
+      copy = res;
+    }
+    copy.version(w.version_);
+    copy.keep_alive(w.keep_alive_);
+
+    boost::asio::post(io_, [cb = w.cb_, r = std::move(copy)]() mutable {
+      cb(net::web_server::http_res_t{std::move(r)});
+    });
+  }
+}
+
+}  // namespace soro::server
@@ -0,0 +1,77 @@
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "soro/server/file_watcher.h"
+
+namespace soro::test {
+
+using namespace soro::server;
+
+namespace fs = std::filesystem;
+
+TEST_SUITE("file watcher") {
+
+  TEST_CASE("fingerprint changes with the files") {
+    auto const dir = fs::temp_directory_path() / "soro_fingerprint_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "nested");
+
+    auto const empty = get_fingerprint({dir});
+    CHECK_EQ(get_fingerprint({dir}), empty);
+
+    std::ofstream{dir / "nested" / "a"} << "a";
+    auto const one_file = get_fingerprint({dir});
+    CHECK_NE(one_file, empty);
+
+    std::ofstream{dir / "nested" / "a"} << "aa";
+    CHECK_NE(get_fingerprint({dir}), one_file);
+
+    // single files are fingerprinted as well
+    auto const file = get_fingerprint({dir / "nested" / "a"});
+    CHECK_NE(file, get_fingerprint({}));
+    std::ofstream{dir / "nested" / "a"} << "aaa";
+    CHECK_NE(get_fingerprint({dir / "nested" / "a"}), file);
+
+    // missing paths are skipped
+    CHECK_EQ(get_fingerprint({dir / "missing"}), get_fingerprint({}));
+
+    fs::remove_all(dir);
+  }
+
+  TEST_CASE("changes are reported once") {
+    auto const dir = fs::temp_directory_path() / "soro_file_watcher_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::atomic_size_t changes = 0;
+    {
+      file_watcher const watcher({dir}, std::chrono::milliseconds{10},
+                                 [&] { ++changes; });
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{30});
+      CHECK_EQ(changes.load(), 0);
+
+      std::ofstream{dir / "a"} << "a";
+
+      auto const deadline =
+          std::chrono::steady_clock::now() + std::chrono::seconds{5};
+      while (changes.load() == 0 &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+
+    CHECK_EQ(changes.load(), 1);
+
+    fs::remove_all(dir);
+  }
+}
+
+}  // namespace soro::test
@@ -0,0 +1,102 @@
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "soro/server/lazy_store.h"
+
+namespace soro::test {
+
+using namespace soro::server;
+
+TEST_SUITE("lazy store") {
+
+  TEST_CASE("values are loaded on their first request") {
+    lazy_store<std::string> store;
+
+    std::size_t loads = 0;
+    store.add("a", 1, [&] {
+      ++loads;
+      return std::make_shared<std::string const>("a");
+    });
+    store.add("b", 1, [] { return nullptr; });
+
+    CHECK_EQ(loads, 0);
+    CHECK(store.contains("a"));
+    CHECK(!store.loaded("a"));
+    CHECK(!store.ready("a"));
+
+    CHECK_EQ(*store.get("a"), "a");
+    CHECK_EQ(*store.get("a"), "a");
+    CHECK_EQ(loads, 1);
+    CHECK(store.loaded("a"));
+    CHECK(store.ready("a"));
+
+    // failed and unknown values are answered without a load
+    CHECK(!store.ready("b"));
+    CHECK_EQ(store.get("b"), nullptr);
+    CHECK(store.ready("b"));
+    CHECK(store.ready("c"));
+    CHECK_EQ(store.get("c"), nullptr);
+    CHECK_EQ(store.keys(), (std::vector<std::string>{"a", "b"}));
+  }
+
+  TEST_CASE("concurrent requests share one load") {
+    lazy_store<std::string> store;
+
+    std::atomic_size_t loads = 0;
+    store.add("a", 1, [&] {
+      ++loads;
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      return std::make_shared<std::string const>("a");
+    });
+
+    std::vector<std::shared_ptr<std::string const>> results(8);
+    {
+      std::vector<std::jthread> threads;
+      for (auto& result : results) {
+        threads.emplace_back([&] { result = store.get("a"); });
+      }
+    }
+
+    CHECK_EQ(loads.load(), 1);
+    for (auto const& result : results) {
+      REQUIRE_NE(result, nullptr);
+      CHECK_EQ(result, results.front());
+    }
+  }
+
+  TEST_CASE("least recently used values are evicted") {
+    lazy_store<std::string> store(250);
+
+    std::size_t loads = 0;
+    for (auto const* key : {"a", "b", "c"}) {
+      store.add(key, 100, [&loads, key] {
+        ++loads;
+        return std::make_shared<std::string const>(key);
+      });
+    }
+
+    auto const a = store.get("a");
+    store.get("b");
+    store.get("a");
+    store.get("c");  // evicts b
+
+    CHECK_EQ(loads, 3);
+    CHECK_EQ(store.resident(), 200);
+    CHECK(store.loaded("a"));
+    CHECK(!store.loaded("b"));
+
+    store.get("b");  // evicts a
+    CHECK_EQ(loads, 4);
+    CHECK(!store.loaded("a"));
+
+    // readers keep evicted values alive
+    CHECK_EQ(*a, "a");
+  }
+}
+
+}  // namespace soro::test
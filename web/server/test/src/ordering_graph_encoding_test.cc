@@ -0,0 +1,125 @@
+#include "doctest/doctest.h"
+
+#include <string>
+
+#include "rapidjson/document.h"
+
+#include "soro/server/modules/ordering/ordering_graph_encoding.h"
+
+#include "test/file_paths.h"
+
+namespace soro::test {
+
+using namespace soro::tt;
+using namespace soro::infra;
+using namespace soro::server;
+using namespace soro::simulation;
+
+struct varint_reader {
+  uint64_t next() {
+    uint64_t result = 0;
+    for (auto shift = 0U;; shift += 7U) {
+      auto const byte = static_cast<uint8_t>(data_[pos_++]);
+      result |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+      if ((byte & 0x80U) == 0) {
+        return result;
+      }
+    }
+  }
+
+  std::string_view data_;
+  std::size_t pos_{0};
+};
+
+TEST_SUITE("ordering graph encoding") {
+
+  TEST_CASE("negotiate format") {
+    CHECK_EQ(negotiate_ordering_graph_format(""), ordering_graph_format::JSON);
+    CHECK_EQ(negotiate_ordering_graph_format("application/json"),
+             ordering_graph_format::JSON);
+    CHECK_EQ(negotiate_ordering_graph_format(
+                 "application/octet-stream, application/json;q=0.5"),
+             ordering_graph_format::BINARY);
+  }
+
+  TEST_CASE("json and binary describe the same graph") {
+    auto opts = SMALL_OPTS;
+    opts.exclusions_ = true;
+    opts.interlocking_ = true;
+    opts.exclusion_graph_ = false;
+    opts.layout_ = false;
+
+    infrastructure const infra(opts);
+    timetable const tt(FOLLOW_OPTS, infra);
+    ordering_graph const og(infra, tt);
+
+    std::size_t edges = 0;
+    for (auto const& node : og.nodes_) {
+      edges += node.out_.size();
+    }
+
+    std::string json;
+    write_ordering_graph(json, og, tt, ordering_graph_format::JSON);
+
+    rapidjson::Document doc;
+    doc.Parse(json.c_str());
+    REQUIRE(!doc.HasParseError());
+
+    CHECK_EQ(doc["attributes"]["totalTrains"].GetUint(),
+             og.trip_to_nodes_.size());
+    CHECK_EQ(doc["nodes"].Size(), og.nodes_.size());
+    CHECK_EQ(doc["edges"].Size(), edges);
+
+    std::string binary;
+    write_ordering_graph(binary, og, tt, ordering_graph_format::BINARY);
+    CHECK_LT(binary.size(), json.size());
+
+    REQUIRE(binary.starts_with(ORDERING_GRAPH_MAGIC));
+    varint_reader r{.data_ = binary, .pos_ = ORDERING_GRAPH_MAGIC.size()};
+
+    CHECK_EQ(r.next(), ORDERING_GRAPH_BINARY_VERSION);
+
+    auto const trips = r.next();
+    auto const nodes = r.next();
+    CHECK_EQ(trips, og.trip_to_nodes_.size());
+    CHECK_EQ(nodes, og.nodes_.size());
+    CHECK_EQ(r.next(), edges);
+    CHECK_EQ(r.next(), doc["attributes"]["maxTrainLength"].GetUint());
+
+    // trips in the same order as the json nodes
+    std::vector<ordering_node::id> node_order;
+    for (auto t = 0U; t < trips; ++t) {
+      auto const train = r.next();
+      auto const first = r.next();
+      auto const count = r.next();
+
+      CHECK_EQ(og.nodes_[first].train_id_, train);
+      for (auto n = first; n < first + count; ++n) {
+        node_order.push_back(static_cast<ordering_node::id>(n));
+      }
+    }
+    REQUIRE_EQ(node_order.size(), nodes);
+
+    for (auto i = 0U; i < nodes; ++i) {
+      auto const& json_node = doc["nodes"][i];
+      CHECK_EQ(json_node["key"].GetUint(), node_order[i]);
+      CHECK_EQ(r.next(), json_node["attributes"]["route"].GetUint());
+    }
+
+    std::size_t edge_idx = 0;
+    for (auto const id : node_order) {
+      auto const degree = r.next();
+      REQUIRE_EQ(degree, og.nodes_[id].out_.size());
+
+      for (auto e = 0U; e < degree; ++e, ++edge_idx) {
+        auto const& json_edge = doc["edges"][static_cast<unsigned>(edge_idx)];
+        CHECK_EQ(json_edge["source"].GetUint(), id);
+        CHECK_EQ(r.next(), json_edge["target"].GetUint());
+      }
+    }
+
+    CHECK_EQ(r.pos_, binary.size());
+  }
+}
+
+}  // namespace soro::test
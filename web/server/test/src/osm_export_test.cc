@@ -80,19 +80,15 @@ TEST_SUITE("osm export suite") {
 
     // every element id from the osm file must appear in the infrastructure
     for (auto id : element_ids) {
-      CHECK(iss.element_to_station_.find(id) !=
-            std::end(iss.element_to_station_));
+      CHECK(id < iss.element_to_station_.size());
+      CHECK(iss.element_to_station_[id] != nullptr);
     }
 
     // every element id must appear in the osm file
-    for (auto const& [e_id, station_ptr] : iss.element_to_station_) {
-      CHECK(utls::contains(element_ids, e_id));
-    }
-
-    for (auto const& pair : iss.element_to_station_) {
-      auto id = pair.first;
-      CHECK(std::find(element_ids.begin(), element_ids.end(), id) !=
-            element_ids.end());
+    for (element_id e_id = 0; e_id < iss.element_to_station_.size(); ++e_id) {
+      if (iss.element_to_station_[e_id] != nullptr) {
+        CHECK(utls::contains(element_ids, e_id));
+      }
     }
   }
 
@@ -0,0 +1,103 @@
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "soro/utls/coordinates/gps.h"
+
+#include "soro/server/modules/positions/position_index.h"
+
+#include "test/file_paths.h"
+
+namespace soro::test {
+
+using namespace soro::tt;
+using namespace soro::infra;
+using namespace soro::server;
+
+// reference implementation, asks every trip of the timetable
+std::vector<train_position> brute_force_positions(
+    position_index const& index, timetable const& tt, absolute_time const t,
+    utls::bounding_box const& viewport) {
+  std::vector<train_position> result;
+
+  for (auto const& train : tt->trains_) {
+    for (auto const& trip : train.trips()) {
+      auto const pos = index.position(trip, t);
+      if (pos.has_value() && viewport.contains(pos->position_)) {
+        result.push_back(*pos);
+      }
+    }
+  }
+
+  return result;
+}
+
+void check_equal(std::vector<train_position> got,
+                 std::vector<train_position> expected) {
+  auto const by_trip = [](auto&& p1, auto&& p2) { return p1.trip_ < p2.trip_; };
+  std::sort(std::begin(got), std::end(got), by_trip);
+  std::sort(std::begin(expected), std::end(expected), by_trip);
+
+  REQUIRE_EQ(got.size(), expected.size());
+  for (auto i = 0U; i < got.size(); ++i) {
+    CHECK_EQ(got[i].trip_, expected[i].trip_);
+    CHECK_EQ(got[i].position_.lon_, expected[i].position_.lon_);
+    CHECK_EQ(got[i].position_.lat_, expected[i].position_.lat_);
+    CHECK_EQ(got[i].halting_, expected[i].halting_);
+  }
+}
+
+TEST_SUITE("position index") {
+
+  TEST_CASE("position index, follow") {
+    auto opts = SMALL_OPTS;
+    opts.exclusions_ = true;
+    opts.interlocking_ = true;
+    opts.exclusion_graph_ = false;
+
+    infrastructure const infra(opts);
+    timetable const tt(FOLLOW_OPTS, infra);
+    position_index const index(infra, tt);
+
+    REQUIRE_EQ(index.waypoint_offsets_.size(), tt->trains_.size() + 1);
+    REQUIRE_EQ(index.slice_offsets_.size(), tt->trains_.size() + 1);
+
+    // slices cover every waypoint of their time span
+    for (auto const& train : tt->trains_) {
+      auto const wps = index.waypoints(train.id_);
+      auto const slices = index.slices(train.id_);
+
+      for (auto const& wp : wps) {
+        CHECK_LE(wp.arrival_, wp.departure_);
+
+        auto const s = static_cast<std::size_t>(
+            (wp.arrival_ - wps.front().arrival_) /
+            position_index::SLICE_WIDTH);
+        REQUIRE_LT(s, slices.size());
+        CHECK(slices[s].contains(wp.position_));
+      }
+    }
+
+    auto const all = utls::get_bounding_box(infra->element_positions_);
+    auto west = all;
+    west.north_east_.lon_ = (all.south_west_.lon_ + all.north_east_.lon_) / 2;
+
+    std::size_t running = 0;
+    for (auto const& entry : tt->trip_index_.by_departure_) {
+      for (auto t = entry.interval_.start_ - duration2{120};
+           t <= entry.interval_.end_ + duration2{120}; t += duration2{30}) {
+        auto const positions = index.positions(tt, t);
+        running += positions.size();
+
+        check_equal(positions, brute_force_positions(index, tt, t, all));
+        check_equal(index.positions(tt, t, west),
+                    brute_force_positions(index, tt, t, west));
+      }
+    }
+
+    CHECK_GT(running, 0U);
+  }
+}
+
+}  // namespace soro::test
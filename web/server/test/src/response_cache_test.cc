@@ -0,0 +1,145 @@
+#include "doctest/doctest.h"
+
+#include <string>
+
+#include "soro/server/cereal/json_archive.h"
+#include "soro/server/response_cache.h"
+
+namespace soro::test {
+
+using namespace soro::server;
+
+namespace http = boost::beast::http;
+
+net::query_router::route_request make_request(std::string_view const target) {
+  return net::query_router::route_request{
+      net::web_server::http_req_t{http::verb::get, target, 11}};
+}
+
+TEST_SUITE("response cache") {
+
+  TEST_CASE("cached responses and etags") {
+    response_cache cache(1024 * 1024, 2);
+
+    // every produced body is different
+    std::size_t produced = 0;
+    auto const produce = [&](auto const& req) {
+      return [&] {
+        ++produced;
+        return json_response(req, std::string(4096, 'a') +
+                                      std::to_string(produced));
+      };
+    };
+
+    auto req = make_request("/infrastructure/a/station/1");
+
+    auto const first = cache.serve(req, "v1", produce(req));
+    auto const second = cache.serve(req, "v1", produce(req));
+
+    CHECK_EQ(produced, 1);
+    CHECK_EQ(cache.hits(), 1);
+    CHECK_EQ(cache.misses(), 1);
+    CHECK_EQ(first.body(), second.body());
+    CHECK_EQ(first[http::field::content_type], "application/json");
+
+    auto const etag = std::string{first[http::field::etag]};
+    CHECK(!etag.empty());
+
+    // a new version of the data produces a new body with a new etag
+    auto const other_version = cache.serve(req, "v2", produce(req));
+    CHECK_EQ(produced, 2);
+    CHECK_NE(other_version[http::field::etag], etag);
+    CHECK_NE(other_version.body(), first.body());
+
+    // both versions are cached
+    auto const again = cache.serve(req, "v2", produce(req));
+    CHECK_EQ(again.body(), other_version.body());
+    CHECK_EQ(again[http::field::etag], other_version[http::field::etag]);
+
+    req.set(http::field::if_none_match, etag);
+    auto const not_modified = cache.serve(req, "v1", produce(req));
+    CHECK_EQ(not_modified.result(), http::status::not_modified);
+    CHECK(not_modified.body().empty());
+    CHECK_EQ(produced, 2);
+
+    req.erase(http::field::if_none_match);
+    req.set(http::field::accept_encoding, "gzip, deflate");
+    auto const deflated = cache.serve(req, "v1", produce(req));
+    CHECK_EQ(deflated[http::field::content_encoding], "deflate");
+    CHECK_LT(deflated.body().size(), first.body().size());
+    CHECK_EQ(produced, 2);
+
+    // the deflated body is a representation with an etag of its own
+    auto const deflated_etag = std::string{deflated[http::field::etag]};
+    CHECK_NE(deflated_etag, etag);
+
+    req.set(http::field::if_none_match, etag);
+    CHECK_EQ(cache.serve(req, "v1", produce(req)).result(), http::status::ok);
+
+    req.set(http::field::if_none_match, deflated_etag);
+    CHECK_EQ(cache.serve(req, "v1", produce(req)).result(),
+             http::status::not_modified);
+    CHECK_EQ(produced, 2);
+  }
+
+  TEST_CASE("etags are derived from the content") {
+    response_cache cache(1024 * 1024, 1);
+
+    auto const req = make_request("/infrastructure/a/station/1");
+    auto const produce = [&] { return json_response(req, "a"); };
+
+    // a new version with the same content keeps the etag
+    auto const v1 = cache.serve(req, "v1", produce);
+    auto const v2 = cache.serve(req, "v2", produce);
+    CHECK_EQ(v1[http::field::etag], v2[http::field::etag]);
+
+    auto const other_req = make_request("/infrastructure/a/station/2");
+    auto const other = cache.serve(
+        other_req, "v1", [&] { return json_response(other_req, "b"); });
+    CHECK_NE(other[http::field::etag], v1[http::field::etag]);
+  }
+
+  TEST_CASE("failed responses are not cached") {
+    response_cache cache(1024 * 1024, 1);
+
+    std::size_t produced = 0;
+    auto const req = make_request("/infrastructure/a/station/99");
+    auto const produce = [&] {
+      ++produced;
+      return net::web_server::string_res_t{http::status::not_found, 11};
+    };
+
+    CHECK_EQ(cache.serve(req, "v1", produce).result(), http::status::not_found);
+    CHECK_EQ(cache.serve(req, "v1", produce).result(), http::status::not_found);
+    CHECK_EQ(produced, 2);
+  }
+
+  TEST_CASE("least recently used entries are evicted") {
+    // room for two entries per shard
+    response_cache cache(2 * (sizeof(response_cache::entry) + 300), 1);
+
+    std::size_t produced = 0;
+    auto const serve = [&](std::string_view const target) {
+      auto const req = make_request(target);
+      cache.serve(req, "v1", [&] {
+        ++produced;
+        return json_response(req, std::string(256, 'a'));
+      });
+    };
+
+    serve("/a");
+    serve("/b");
+    serve("/a");
+    serve("/c");  // evicts /b
+
+    CHECK_EQ(produced, 3);
+
+    serve("/a");
+    CHECK_EQ(produced, 3);
+
+    serve("/b");
+    CHECK_EQ(produced, 4);
+  }
+}
+
+}  // namespace soro::test
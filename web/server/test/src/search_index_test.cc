@@ -0,0 +1,147 @@
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "soro/server/modules/search/search_index.h"
+
+#include "test/file_paths.h"
+
+namespace soro::test {
+
+using namespace soro::infra;
+using namespace soro::server;
+
+using kind = spatial_index::kind;
+
+type_filter const ONLY_STATIONS{.kinds_ = {kind::STATION}};
+
+bool contains_station(search_index_t const& index,
+                      std::vector<search_index_t::match> const& matches,
+                      station::id const id) {
+  return std::ranges::any_of(matches, [&](auto&& m) {
+    auto const& entry = index.entries_[m.entry_];
+    return entry.kind_ == kind::STATION && entry.id_ == id;
+  });
+}
+
+void check_matches(search_index_t const& index, search_query const& query,
+                   std::vector<search_index_t::match> const& matches) {
+  CHECK_LE(matches.size(), query.limit_);
+
+  std::set<spatial_index::item> items;
+  for (auto const& m : matches) {
+    auto const& entry = index.entries_[m.entry_];
+    CHECK(items.insert({.kind_ = entry.kind_, .id_ = entry.id_}).second);
+    CHECK(query.types_.accepts(entry.kind_, entry.element_type_));
+
+    if (query.viewport_.has_value()) {
+      CHECK(entry.bounding_box_.overlaps(*query.viewport_));
+    }
+  }
+
+  CHECK(std::ranges::is_sorted(
+      matches, [](auto&& m1, auto&& m2) { return m1.score_ > m2.score_; }));
+}
+
+void check_keys(search_index_t const& index) {
+  REQUIRE_EQ(index.by_key_.size(), index.entries_.size());
+  REQUIRE_EQ(index.names_.size(), index.entries_.size());
+  REQUIRE_EQ(index.keys_.size(), index.entries_.size());
+
+  for (auto i = 1U; i < index.by_key_.size(); ++i) {
+    CHECK_LE(std::string_view{index.keys_[index.by_key_[i - 1]]},
+             std::string_view{index.keys_[index.by_key_[i]]});
+  }
+
+  REQUIRE_EQ(index.trigram_offsets_.size(), index.trigrams_.size() + 1);
+  CHECK(std::ranges::is_sorted(index.trigrams_));
+}
+
+void check_stations(search_index_t const& index, infrastructure const& infra) {
+  for (auto const s : infra->stations_) {
+    auto const key = to_search_key(s->ds100_);
+    if (key.empty()) {
+      continue;
+    }
+
+    // exact
+    search_query query{.text_ = s->ds100_, .types_ = ONLY_STATIONS};
+    auto const exact = index.search(query);
+    check_matches(index, query, exact);
+    REQUIRE_FALSE(exact.empty());
+    CHECK_EQ(exact.front().score_, 3.0F);
+    CHECK(contains_station(index, exact, s->id_));
+
+    // prefix
+    query.text_ = std::string_view{key}.substr(0, 1);
+    query.limit_ = static_cast<soro::size_t>(index.entries_.size());
+    auto const prefix = index.search(query);
+    check_matches(index, query, prefix);
+    CHECK(contains_station(index, prefix, s->id_));
+
+    // typo in the middle of a longer name
+    if (key.size() >= 8) {
+      auto typo = key;
+      typo[key.size() / 2] = typo[key.size() / 2] == 'x' ? 'y' : 'x';
+      query.text_ = typo;
+      auto const fuzzy = index.search(query);
+      check_matches(index, query, fuzzy);
+      CHECK(contains_station(index, fuzzy, s->id_));
+    }
+  }
+}
+
+void check_filters(search_index_t const& index) {
+  search_query query{.text_ = "1", .limit_ = 5};
+  check_matches(index, query, index.search(query));
+
+  query.types_ = {.element_types_ = {type::MAIN_SIGNAL}};
+  query.limit_ = static_cast<soro::size_t>(index.entries_.size());
+  auto const signals = index.search(query);
+  check_matches(index, query, signals);
+  CHECK(std::ranges::all_of(signals, [&](auto&& m) {
+    return index.entries_[m.entry_].element_type_ == type::MAIN_SIGNAL;
+  }));
+
+  utls::bounding_box const nowhere{
+      .south_west_ = {.lon_ = 0.0, .lat_ = 0.0},
+      .north_east_ = {.lon_ = 0.0, .lat_ = 0.0}};
+  query.types_ = {};
+  query.viewport_ = nowhere;
+  check_matches(index, query, index.search(query));
+
+  query.limit_ = 0;
+  CHECK(index.search(query).empty());
+
+  query.text_ = "-_";
+  query.limit_ = search_query::DEFAULT_LIMIT;
+  CHECK(index.search(query).empty());
+}
+
+TEST_CASE("search index") {
+  for (auto const& infra : get_infrastructure_scenarios()) {
+    search_index const not_serialized(*infra);
+
+#if defined(SERIALIZE)
+    not_serialized.save("search.raw");
+    search_index const index("search.raw");
+#else
+    auto const& index = not_serialized;
+#endif
+
+    check_keys(*index);
+    check_stations(*index, *infra);
+    check_filters(*index);
+  }
+}
+
+TEST_CASE("search key") {
+  CHECK_EQ(to_search_key("Frankfurt (Main) Hbf"), "frankfurtmainhbf");
+  CHECK_EQ(to_search_key("N_12-a"), "n12a");
+  CHECK_EQ(to_search_key("-_ "), "");
+}
+
+}  // namespace soro::test
@@ -0,0 +1,192 @@
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio/io_context.hpp"
+
+#include "net/web_server/responses.h"
+
+#include "soro/server/worker_pool.h"
+
+namespace soro::test {
+
+using namespace soro::server;
+using namespace std::chrono_literals;
+
+namespace http = boost::beast::http;
+
+net::query_router::route_request make_job_request(
+    std::string_view const target) {
+  return net::query_router::route_request{
+      net::web_server::http_req_t{http::verb::get, target, 11}};
+}
+
+// runs the io context until done returns true, replies are posted to it
+void run_until(boost::asio::io_context& ioc,
+               std::function<bool()> const& done) {
+  auto const give_up = std::chrono::steady_clock::now() + 10s;
+  while (!done() && std::chrono::steady_clock::now() < give_up) {
+    ioc.restart();
+    ioc.run_for(5ms);
+  }
+  REQUIRE(done());
+}
+
+struct responses {
+  net::web_server::http_res_cb_t callback() {
+    return [this](net::web_server::http_res_t&& res) {
+      statuses_.push_back(
+          std::get<net::web_server::string_res_t>(res).result());
+    };
+  }
+
+  std::size_t count(http::status const status) const {
+    return static_cast<std::size_t>(
+        std::ranges::count(statuses_, status));
+  }
+
+  std::vector<http::status> statuses_;
+};
+
+// blocks until released, then answers with 200
+struct blocking_handler {
+  worker_pool::handler_t handler() {
+    return [this](net::query_router::route_request const& req,
+                  std::stop_token const&) {
+      ++calls_;
+      started_.release();
+      released_.wait();
+      return net::web_server::string_res_t{http::status::ok, req.version()};
+    };
+  }
+
+  std::atomic_size_t calls_{0};
+  std::counting_semaphore<> started_{0};
+  std::shared_future<void> released_;
+};
+
+TEST_SUITE("worker pool") {
+
+  TEST_CASE("identical requests share one computation") {
+    boost::asio::io_context ioc;
+    responses r;
+
+    std::promise<void> release;
+    blocking_handler h;
+    h.released_ = release.get_future().share();
+
+    {
+      worker_pool pool(ioc.get_executor(), 2, 4, 10s);
+
+      auto const req = make_job_request("/ordering?from=1&to=2");
+      for (auto i = 0; i < 3; ++i) {
+        pool.submit(req, r.callback(), h.handler());
+      }
+
+      h.started_.acquire();
+      release.set_value();
+
+      run_until(ioc, [&] { return r.statuses_.size() == 3; });
+
+      CHECK_EQ(h.calls_.load(), 1U);
+      CHECK_EQ(pool.coalesced(), 2U);
+      CHECK_EQ(r.count(http::status::ok), 3U);
+    }
+  }
+
+  TEST_CASE("requests beyond the queue size are rejected") {
+    boost::asio::io_context ioc;
+    responses r;
+
+    std::promise<void> release;
+    blocking_handler h;
+    h.released_ = release.get_future().share();
+
+    {
+      worker_pool pool(ioc.get_executor(), 1, 1, 10s);
+
+      // running, the queue is empty again
+      pool.submit(make_job_request("/a"), r.callback(), h.handler());
+      h.started_.acquire();
+
+      // queued
+      pool.submit(make_job_request("/b"), r.callback(), h.handler());
+
+      // rejected right away
+      pool.submit(make_job_request("/c"), r.callback(), h.handler());
+      REQUIRE_EQ(r.statuses_.size(), 1U);
+      CHECK_EQ(r.statuses_.front(), http::status::service_unavailable);
+      CHECK_EQ(pool.rejected(), 1U);
+
+      release.set_value();
+      run_until(ioc, [&] { return r.statuses_.size() == 3; });
+
+      CHECK_EQ(h.calls_.load(), 2U);
+      CHECK_EQ(r.count(http::status::ok), 2U);
+    }
+  }
+
+  TEST_CASE("computations nobody waits for are cancelled") {
+    boost::asio::io_context ioc;
+    responses r;
+
+    std::atomic_bool stopped{false};
+    std::atomic_size_t calls{0};
+    std::counting_semaphore<> started{0};
+
+    std::promise<void> release;
+    auto const released = release.get_future().share();
+
+    // runs until it is cancelled, then blocks the worker until released
+    auto const until_stopped = [&](net::query_router::route_request const& req,
+                                   std::stop_token const& stop) {
+      ++calls;
+      started.release();
+
+      auto const give_up = std::chrono::steady_clock::now() + 10s;
+      while (!stop.stop_requested() &&
+             std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(1ms);
+      }
+
+      stopped = stop.stop_requested();
+      released.wait();
+      return net::web_server::string_res_t{http::status::ok, req.version()};
+    };
+
+    {
+      worker_pool pool(ioc.get_executor(), 1, 2, 50ms);
+
+      // running
+      pool.submit(make_job_request("/a"), r.callback(), until_stopped);
+      started.acquire();
+
+      // queued behind the running one, expires before it gets a worker
+      pool.submit(make_job_request("/b"), r.callback(), until_stopped);
+
+      run_until(ioc, [&] { return r.statuses_.size() == 2; });
+      CHECK_EQ(r.count(http::status::service_unavailable), 2U);
+      CHECK_EQ(pool.cancelled(), 2U);
+
+      run_until(ioc, [&] { return stopped.load(); });
+      release.set_value();
+    }
+
+    // the running computation was stopped, the queued one never ran
+    CHECK(stopped.load());
+    CHECK_EQ(calls.load(), 1U);
+
+    // cancelled computations do not answer anyone
+    CHECK_EQ(r.statuses_.size(), 2U);
+  }
+}
+
+}  // namespace soro::test